@@ -0,0 +1,61 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// arena.cc: bump allocator for objects owned by a table
+// -----------------------------------
+
+#include <algorithm>
+#include <stdint.h>
+#include "arena.h"
+
+namespace sigen
+{
+   //
+   // carves len bytes from the current block, starting a new one if
+   // they don't fit. Oversized requests get a block of their own
+   void *Arena::allocate(size_t len, size_t align)
+   {
+      size_t pad = (align - reinterpret_cast<uintptr_t>(pos) % align) % align;
+
+      if (!pos || pad + len > avail) {
+         size_t size = std::max<size_t>(len + align, BLOCK_SIZE);
+         blocks.emplace_back(new ui8[size]);
+         pos = blocks.back().get();
+         avail = size;
+         pad = (align - reinterpret_cast<uintptr_t>(pos) % align) % align;
+      }
+
+      void *p = pos + pad;
+      pos += pad + len;
+      avail -= pad + len;
+      return p;
+   }
+
+   //
+   // only the most recent allocation can be taken back
+   void Arena::release(void *p, size_t len)
+   {
+      ui8 *b = static_cast<ui8 *>(p);
+      if (b + len == pos) {
+         pos = b;
+         avail += len;
+      }
+   }
+
+} // namespace
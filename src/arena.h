@@ -0,0 +1,79 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// arena.h: bump allocator for objects owned by a table
+// -----------------------------------
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include "types.h"
+
+namespace sigen {
+
+   /*!
+    * \brief Block allocator for objects that live as long as their owner.
+    *
+    * Objects are placed one after another in 4 KB blocks, so building
+    * thousands of descriptors costs a handful of allocations. Nothing is
+    * freed on its own: the owner destroys what it made (if needed) and
+    * the blocks go with the arena.
+    */
+   class Arena
+   {
+   public:
+      Arena() : pos(nullptr), avail(0) { }
+
+      // prohibit
+      Arena(const Arena &) = delete;
+      Arena(const Arena &&) = delete;
+      Arena &operator=(const Arena &) = delete;
+      Arena &operator=(const Arena &&) = delete;
+
+      //! \brief Constructs a `T` in the arena.
+      template <class T, class... Args>
+      T *make(Args&&... args) {
+         return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+      }
+
+      //! \brief Destroys `t`, giving its room back if it was the last allocation.
+      template <class T>
+      void destroy(T *t) {
+         t->~T();
+         release(t, sizeof(T));
+      }
+
+      //! \brief Returns `len` bytes of uninitialized storage.
+      void *allocate(size_t len, size_t align = alignof(std::max_align_t));
+      //! \brief Gives back the last allocation, if `p` (of `len` bytes) was it.
+      void release(void *p, size_t len);
+
+   private:
+      enum { BLOCK_SIZE = 4096 };
+
+      std::vector<std::unique_ptr<ui8[]> > blocks;
+      ui8 *pos;      // next free byte in the current block
+      size_t avail;  // bytes left in it
+   };
+
+} // sigen namespace
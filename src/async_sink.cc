@@ -0,0 +1,528 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// async_sink.cc: asynchronous (io_uring) file and fifo output
+// -----------------------------------
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "config.h"
+#include "async_sink.h"
+#include "tstream.h"
+
+#ifdef HAVE_LINUX_IO_URING_H
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_RW_CUR_POS)
+#define SIGEN_IO_URING
+#endif
+#endif
+
+namespace sigen
+{
+   namespace async_sink_priv {
+      struct Completion {
+         unsigned index;   // buffer
+         ssize_t res;      // bytes written or -errno
+      };
+   }
+
+   using namespace async_sink_priv;
+
+   //
+   // write mechanism - writes a buffer range at an offset (-1 for the
+   // current position) and reports when done
+   //
+   class AsyncFileSink::Writer
+   {
+   public:
+      virtual ~Writer() {}
+
+      virtual bool uring() const = 0;
+      virtual bool submit(unsigned index, const ui8 *data, size_t len, off_t off) = 0;
+      // appends the finished writes, waiting for one if wait is set.
+      // Returns false once completions can no longer be waited for
+      virtual bool reap(bool wait, std::vector<Completion> &done) = 0;
+   };
+
+
+#ifdef SIGEN_IO_URING
+   //
+   // io_uring through the raw system calls, writing from registered
+   // buffers
+   //
+   class AsyncFileSink::UringWriter : public Writer
+   {
+   public:
+      UringWriter(int fd, const Buffer *buffers, bool seekable);
+      ~UringWriter() { release(); }
+
+      bool valid() const { return ring_fd >= 0; }
+
+      bool uring() const { return true; }
+      bool submit(unsigned index, const ui8 *data, size_t len, off_t off);
+      bool reap(bool wait, std::vector<Completion> &done);
+
+   private:
+      int fd, ring_fd;
+      bool broken;         // an enter() failed, don't wait on the ring
+      void *sq_ring, *cq_ring;
+      size_t sq_ring_len, cq_ring_len;
+      io_uring_sqe *sqes;
+      size_t sqes_len;
+
+      unsigned *sq_tail, *sq_mask, *sq_array;
+      unsigned *cq_head, *cq_tail, *cq_mask;
+      io_uring_cqe *cqes;
+
+      void release();
+      int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+         int r;
+         do {
+            r = syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0);
+         } while (r < 0 && errno == EINTR);
+         return r;
+      }
+   };
+
+   AsyncFileSink::UringWriter::UringWriter(int f, const Buffer *buffers, bool seekable) :
+      fd(f), ring_fd(-1), broken(false),
+      sq_ring(MAP_FAILED), cq_ring(MAP_FAILED), sq_ring_len(0), cq_ring_len(0),
+      sqes(static_cast<io_uring_sqe *>(MAP_FAILED)), sqes_len(0)
+   {
+      io_uring_params p;
+      memset(&p, 0, sizeof(p));
+      ring_fd = syscall(__NR_io_uring_setup, BUFFERS, &p);
+      if (ring_fd < 0)
+         return;
+
+      sq_ring_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+      cq_ring_len = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+      const bool single_mmap = p.features & IORING_FEAT_SINGLE_MMAP;
+      if (single_mmap)
+         sq_ring_len = std::max(sq_ring_len, cq_ring_len);
+
+      sq_ring = mmap(nullptr, sq_ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     ring_fd, IORING_OFF_SQ_RING);
+      if (!single_mmap)
+         cq_ring = mmap(nullptr, cq_ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring_fd, IORING_OFF_CQ_RING);
+      sqes_len = p.sq_entries * sizeof(io_uring_sqe);
+      sqes = static_cast<io_uring_sqe *>(mmap(nullptr, sqes_len, PROT_READ | PROT_WRITE,
+                                              MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES));
+
+      iovec iov[BUFFERS];
+      for (unsigned i = 0; i < BUFFERS; i++) {
+         iov[i].iov_base = buffers[i].data;
+         iov[i].iov_len = BUFFER_SIZE;
+      }
+
+      // non-seekable files are written at the current position
+      if ((!seekable && !(p.features & IORING_FEAT_RW_CUR_POS)) ||
+          sq_ring == MAP_FAILED || sqes == MAP_FAILED ||
+          (!single_mmap && cq_ring == MAP_FAILED) ||
+          syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_BUFFERS, iov, BUFFERS) < 0) {
+         release();
+         return;
+      }
+
+      ui8 *sq = static_cast<ui8 *>(sq_ring);
+      sq_tail = reinterpret_cast<unsigned *>(sq + p.sq_off.tail);
+      sq_mask = reinterpret_cast<unsigned *>(sq + p.sq_off.ring_mask);
+      sq_array = reinterpret_cast<unsigned *>(sq + p.sq_off.array);
+
+      ui8 *cq = static_cast<ui8 *>(single_mmap ? sq_ring : cq_ring);
+      cq_head = reinterpret_cast<unsigned *>(cq + p.cq_off.head);
+      cq_tail = reinterpret_cast<unsigned *>(cq + p.cq_off.tail);
+      cq_mask = reinterpret_cast<unsigned *>(cq + p.cq_off.ring_mask);
+      cqes = reinterpret_cast<io_uring_cqe *>(cq + p.cq_off.cqes);
+   }
+
+   //
+   // unmaps the rings and closes the ring, which unregisters the buffers
+   //
+   void AsyncFileSink::UringWriter::release()
+   {
+      if (sqes != MAP_FAILED)
+         munmap(sqes, sqes_len);
+      if (cq_ring != MAP_FAILED)
+         munmap(cq_ring, cq_ring_len);
+      if (sq_ring != MAP_FAILED)
+         munmap(sq_ring, sq_ring_len);
+      sq_ring = cq_ring = MAP_FAILED;
+      sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+
+      if (ring_fd >= 0)
+         ::close(ring_fd);
+      ring_fd = -1;
+   }
+
+   //
+   // at most BUFFERS writes are in flight, so the rings never fill. If
+   // the enter fails the entry is still queued and might complete later,
+   // so the ring is only used to collect what's already done from then on
+   //
+   bool AsyncFileSink::UringWriter::submit(unsigned index, const ui8 *data, size_t len, off_t off)
+   {
+      const unsigned tail = *sq_tail;
+      const unsigned idx = tail & *sq_mask;
+
+      io_uring_sqe *sqe = &sqes[idx];
+      memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode = IORING_OP_WRITE_FIXED;
+      sqe->fd = fd;
+      sqe->addr = reinterpret_cast<uintptr_t>(data);
+      sqe->len = len;
+      sqe->off = static_cast<__u64>(off);
+      sqe->buf_index = index;
+      sqe->user_data = index;
+
+      sq_array[idx] = idx;
+      __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+      if (enter(1, 0, 0) != 1)
+         broken = true;
+      return !broken;
+   }
+
+   bool AsyncFileSink::UringWriter::reap(bool wait, std::vector<Completion> &done)
+   {
+      unsigned head = *cq_head;
+      if (wait && !broken && head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE) &&
+          enter(0, 1, IORING_ENTER_GETEVENTS) < 0)
+         broken = true;
+
+      for (; head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE); head++) {
+         const io_uring_cqe &cqe = cqes[head & *cq_mask];
+         done.push_back({ static_cast<unsigned>(cqe.user_data), cqe.res });
+      }
+      __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+      return !broken;
+   }
+#endif
+
+
+   //
+   // fallback - a thread writing the queued buffers, a run of adjacent
+   // buffers with one pwritev()
+   //
+   class AsyncFileSink::ThreadWriter : public Writer
+   {
+   public:
+      explicit ThreadWriter(int f) : fd(f), stopping(false) {
+         thread = std::thread(&ThreadWriter::run, this);
+      }
+      ~ThreadWriter() {
+         {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+         }
+         cond.notify_all();
+         thread.join();
+      }
+
+      bool uring() const { return false; }
+      bool submit(unsigned index, const ui8 *data, size_t len, off_t off) {
+         std::lock_guard<std::mutex> lock(mutex);
+         queue.push_back({ index, data, len, off });
+         cond.notify_all();
+         return true;
+      }
+      bool reap(bool wait, std::vector<Completion> &done) {
+         std::unique_lock<std::mutex> lock(mutex);
+         if (wait)
+            cond.wait(lock, [this] { return !completed.empty(); });
+         done.insert(done.end(), completed.begin(), completed.end());
+         completed.clear();
+         return true;
+      }
+
+   private:
+      struct Job {
+         unsigned index;
+         const ui8 *data;
+         size_t len;
+         off_t off;
+      };
+
+      int fd;
+      std::thread thread;
+      std::mutex mutex;
+      std::condition_variable cond;
+      std::deque<Job> queue;
+      std::vector<Completion> completed;
+      bool stopping;
+
+      void run();
+      ssize_t writeAll(iovec *iov, int count, off_t off);
+   };
+
+   void AsyncFileSink::ThreadWriter::run()
+   {
+      std::vector<Job> jobs;
+      std::vector<Completion> results;
+      std::unique_lock<std::mutex> lock(mutex);
+
+      while (true) {
+         cond.wait(lock, [this] { return stopping || !queue.empty(); });
+         if (queue.empty())
+            break;
+
+         jobs.assign(queue.begin(), queue.end());
+         queue.clear();
+         lock.unlock();
+
+         results.clear();
+         for (size_t first = 0; first < jobs.size(); ) {
+            // the run of jobs following on from each other
+            iovec iov[BUFFERS];
+            size_t last = first;
+            off_t end = jobs[first].off;
+            do {
+               iov[last - first].iov_base = const_cast<ui8 *>(jobs[last].data);
+               iov[last - first].iov_len = jobs[last].len;
+               if (end >= 0)
+                  end += jobs[last].len;
+               last++;
+            } while (last < jobs.size() && last - first < BUFFERS &&
+                     (end < 0 ? jobs[last].off < 0 : jobs[last].off == end));
+
+            const ssize_t r = writeAll(iov, last - first, jobs[first].off);
+            for (size_t i = first; i < last; i++) {
+               results.push_back({ jobs[i].index, r < 0 ? r : static_cast<ssize_t>(jobs[i].len) });
+            }
+            first = last;
+         }
+
+         lock.lock();
+         completed.insert(completed.end(), results.begin(), results.end());
+         cond.notify_all();
+      }
+   }
+
+   //
+   // writes everything, across short writes
+   //
+   ssize_t AsyncFileSink::ThreadWriter::writeAll(iovec *iov, int count, off_t off)
+   {
+      ssize_t total = 0;
+      while (count > 0) {
+         ssize_t r = off < 0 ? writev(fd, iov, count) : pwritev(fd, iov, count, off + total);
+         if (r < 0) {
+            if (errno == EINTR)
+               continue;
+            return -errno;
+         }
+         total += r;
+
+         for (; count > 0 && static_cast<size_t>(r) >= iov->iov_len; count--, iov++) {
+            r -= iov->iov_len;
+         }
+         if (count > 0) {
+            iov->iov_base = static_cast<ui8 *>(iov->iov_base) + r;
+            iov->iov_len -= r;
+         }
+      }
+      return total;
+   }
+
+
+   // --------------------------------
+   // async file sink
+   //
+   AsyncFileSink::AsyncFileSink(const std::string &file_name, Backend backend) :
+      fd(-1), ok(false), seekable(false), offset(0), written(0),
+      memory(BUFFERS * BUFFER_SIZE), cur(0), in_flight(0)
+   {
+      for (unsigned i = 0; i < BUFFERS; i++) {
+         buffers[i] = { &memory[i * BUFFER_SIZE], 0, 0, 0, false };
+      }
+
+      fd = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) {
+         std::cerr << "AsyncFileSink::AsyncFileSink(): can't open " << file_name << ": "
+                   << strerror(errno) << ".. writes disabled" << std::endl;
+         return;
+      }
+
+      struct stat st;
+      seekable = fstat(fd, &st) == 0 && (S_ISREG(st.st_mode) || S_ISBLK(st.st_mode));
+
+#ifdef SIGEN_IO_URING
+      if (backend == AUTO_BACKEND) {
+         std::unique_ptr<UringWriter> uw(new UringWriter(fd, buffers, seekable));
+         if (uw->valid())
+            writer = std::move(uw);
+      }
+#endif
+      if (!writer)
+         writer.reset(new ThreadWriter(fd));
+      ok = true;
+   }
+
+   AsyncFileSink::~AsyncFileSink()
+   {
+      close();
+   }
+
+   bool AsyncFileSink::usingUring() const
+   {
+      return writer && writer->uring();
+   }
+
+
+   //
+   // submits the rest of a buffer. A failed submit stays in flight, as
+   // the write may still complete
+   //
+   void AsyncFileSink::submit(unsigned index)
+   {
+      Buffer &b = buffers[index];
+      b.busy = true;
+      in_flight++;
+
+      if (!writer->submit(index, b.data + b.done, b.len - b.done,
+                          b.offset < 0 ? -1 : b.offset + b.done))
+         ok = false;
+   }
+
+   //
+   // takes in the finished writes - short writes are resubmitted.
+   // Returns false if the writer can't wait for completions anymore
+   //
+   bool AsyncFileSink::reap(bool wait)
+   {
+      std::vector<Completion> done;
+      const bool waiting = writer->reap(wait, done);
+      if (!waiting)
+         ok = false;
+
+      for (const Completion &c : done) {
+         Buffer &b = buffers[c.index];
+         in_flight--;
+
+         if (c.res > 0) {
+            b.done += c.res;
+            written += c.res;
+            if (b.done < b.len) {
+               submit(c.index);
+               continue;
+            }
+         }
+         else if (c.res < 0 || b.done < b.len) {
+            ok = false;
+         }
+         b.busy = false;
+         b.len = b.done = 0;
+      }
+      return waiting;
+   }
+
+
+   //
+   // fills the buffers, submitting each when full
+   //
+   void AsyncFileSink::writeBytes(const ui8 *data, size_t len)
+   {
+      while (len > 0 && ok) {
+         Buffer &b = buffers[cur];
+         while (b.busy && ok)
+            reap(true);
+         if (!ok)
+            return;
+
+         if (b.len == 0)
+            b.offset = seekable ? offset : -1;
+
+         const size_t n = std::min<size_t>(len, BUFFER_SIZE - b.len);
+         memcpy(b.data + b.len, data, n);
+         b.len += n;
+         offset += n;
+         data += n;
+         len -= n;
+
+         if (b.len == BUFFER_SIZE) {
+            // in order - one write at a time
+            while (!seekable && in_flight > 0 && reap(true))
+               ;
+            if (!ok)
+               return;
+            submit(cur);
+            cur = (cur + 1) % BUFFERS;
+         }
+      }
+
+      if (in_flight > 0)
+         reap(false);
+   }
+
+   void AsyncFileSink::write(const ui8 *packets, size_t count)
+   {
+      writeBytes(packets, count * PACKET_SIZE);
+   }
+
+   void AsyncFileSink::write(const TStream &ts)
+   {
+      for (const Section *s : ts.section_list) {
+         writeBytes(s->getBinaryData(), s->length());
+      }
+   }
+
+   void AsyncFileSink::flush()
+   {
+      if (!writer)
+         return;
+
+      Buffer &b = buffers[cur];
+      if (!b.busy && b.len > 0 && ok) {
+         while (!seekable && in_flight > 0 && reap(true))
+            ;
+         if (ok) {
+            submit(cur);
+            cur = (cur + 1) % BUFFERS;
+         }
+      }
+      while (in_flight > 0 && reap(true))
+         ;
+   }
+
+   bool AsyncFileSink::close()
+   {
+      if (fd < 0)
+         return ok;
+
+      flush();
+      writer.reset();
+      if (::close(fd) != 0)
+         ok = false;
+      fd = -1;
+      return ok;
+   }
+
+} // sigen namespace
@@ -0,0 +1,121 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// async_sink.h: asynchronous (io_uring) file and fifo output
+// -----------------------------------
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "sink.h"
+
+namespace sigen {
+
+   class TStream;
+
+   /*!
+    * \brief PacketSink submitting writes asynchronously, so the caller
+    * doesn't block on the file or fifo.
+    *
+    * Packets (or sections) are copied into a small pool of buffers; a
+    * full buffer is submitted to io_uring as a write from its registered
+    * buffer and the next one is filled meanwhile. Completions are reaped
+    * without waiting on each write - the caller only waits when all the
+    * buffers are in flight. Where io_uring isn't available (older
+    * kernels, blocked by a seccomp policy, not built in), the buffers
+    * are written by a thread with pwritev() instead.
+    *
+    * Fifos and other non-seekable files are written in order, one
+    * buffer in flight at a time. All calls must come from one thread.
+    */
+   class AsyncFileSink : public PacketSink
+   {
+   public:
+      enum Backend {
+         AUTO_BACKEND,     //!< io_uring if available, else THREAD_BACKEND.
+         THREAD_BACKEND    //!< pwritev() on a writer thread.
+      };
+      enum {
+         BUFFERS = 8,                        //!< Writes in flight at most.
+         BUFFER_SIZE = 348 * PACKET_SIZE     //!< Bytes per write (~64 KiB).
+      };
+
+      /*!
+       * \brief Constructor - opens (creates / truncates) the file, or a
+       * fifo for writing.
+       * \param file_name Output file.
+       * \param backend Write mechanism.
+       */
+      explicit AsyncFileSink(const std::string &file_name, Backend backend = AUTO_BACKEND);
+      ~AsyncFileSink();
+
+      // prohibit
+      AsyncFileSink(const AsyncFileSink &) = delete;
+      AsyncFileSink &operator=(const AsyncFileSink &) = delete;
+
+      void write(const ui8 *packets, size_t count);
+      //! \brief Write all the sections of a stream back to back (as TStream::write()).
+      void write(const TStream &ts);
+      //! \brief Write any bytes.
+      void writeBytes(const ui8 *data, size_t len);
+      //! \brief Submit the partially filled buffer and wait for all writes.
+      void flush();
+
+      /*!
+       * \brief Flush and close the file. Called by the destructor.
+       * \return `false` if any write failed.
+       */
+      bool close();
+
+      //! \brief `false` if the file couldn't be opened or a write failed.
+      bool good() const { return ok; }
+      //! \brief `true` if writes go through io_uring.
+      bool usingUring() const;
+      //! \brief Bytes written (completed) so far.
+      off_t bytesWritten() const { return written; }
+
+   private:
+      struct Buffer {
+         ui8 *data;
+         size_t len;        // bytes filled
+         size_t done;       // bytes written
+         off_t offset;      // file offset, -1 if not seekable
+         bool busy;         // submitted
+      };
+      class Writer;
+      class UringWriter;
+      class ThreadWriter;
+
+      int fd;
+      bool ok;
+      bool seekable;
+      off_t offset, written;
+      std::vector<ui8> memory;
+      Buffer buffers[BUFFERS];
+      unsigned cur, in_flight;
+      std::unique_ptr<Writer> writer;
+
+      void submit(unsigned index);
+      bool reap(bool wait);
+   };
+
+} // sigen namespace
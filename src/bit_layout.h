@@ -0,0 +1,216 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// bit_layout.h: declarative bit field layouts for descriptor and
+//               table fields
+// -----------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <utility>
+#include "tstream.h"
+#include "types.h"
+
+namespace sigen {
+
+   /*! \addtogroup abstract
+    *  @{
+    */
+
+   //! \brief A `BITS` wide value field of a BitLayout (1 to 32 bits).
+   template <ui8 BITS>
+   struct Field
+   {
+      static_assert(BITS > 0 && BITS <= 32, "fields are 1 to 32 bits wide");
+      enum { bits = BITS, is_value = 1 };
+   };
+
+   //! \brief `BITS` reserved bits of a BitLayout, always written as 1's.
+   template <ui8 BITS>
+   struct Reserved
+   {
+      static_assert(BITS > 0 && BITS <= 32, "fields are 1 to 32 bits wide");
+      enum { bits = BITS, is_value = 0 };
+   };
+
+   namespace bit_layout_priv {
+      // the bytes a layout packs into
+      template <ui16 N>
+      struct Bytes {
+         ui8 data[N];
+      };
+
+      constexpr ui32 mask(ui8 bits) {
+         return (bits == 32) ? 0xffffffff : ((ui32(1) << bits) - 1);
+      }
+
+      constexpr ui16 sum() { return 0; }
+      template <class... T>
+      constexpr ui16 sum(ui16 n, T... rest) { return n + sum(rest...); }
+
+      // bit offset of field idx
+      template <class... F>
+      constexpr ui16 offset(size_t idx) {
+         const ui8 w[] = { F::bits... };
+         ui16 o = 0;
+         for (size_t i = 0; i < idx; i++)
+            o += w[i];
+         return o;
+      }
+
+      // number of value fields before field idx
+      template <class... F>
+      constexpr ui8 valueIndex(size_t idx) {
+         const bool v[] = { F::is_value... };
+         ui8 n = 0;
+         for (size_t i = 0; i < idx; i++)
+            n += v[i];
+         return n;
+      }
+
+      // index of the n'th value field
+      template <class... F>
+      constexpr size_t fieldIndex(ui8 n) {
+         const bool v[] = { F::is_value... };
+         size_t i = 0;
+         for (; !v[i] || n; i++)
+            n -= v[i];
+         return i;
+      }
+
+      template <class... F>
+      constexpr ui8 width(size_t idx) {
+         const ui8 w[] = { F::bits... };
+         return w[idx];
+      }
+
+      // ORs the low BITS of v into b starting OFF bits in
+      template <ui16 OFF, ui8 BITS, ui16 N>
+      constexpr void insert(Bytes<N> &b, ui32 v) {
+         v &= mask(BITS);
+         const ui16 end = OFF + BITS;
+         for (ui16 i = OFF / 8; i <= (end - 1) / 8; i++) {
+            const int shift = (i + 1) * 8 - end;
+            b.data[i] |= static_cast<ui8>(shift >= 0 ? (v << shift) : (v >> -shift));
+         }
+      }
+
+      // reads the BITS starting OFF bits into data
+      template <ui16 OFF, ui8 BITS>
+      constexpr ui32 extract(const ui8 *data) {
+         const ui16 end = OFF + BITS;
+         const ui16 last = (end - 1) / 8;
+         unsigned long long acc = 0;
+         for (ui16 i = OFF / 8; i <= last; i++)
+            acc = (acc << 8) | data[i];
+         return static_cast<ui32>(acc >> ((last + 1) * 8 - end)) & mask(BITS);
+      }
+   }
+
+   /*!
+    * \brief Wire layout of a run of fixed width fields, MSB first.
+    *
+    * A descriptor declares its fixed fields once, e.g.:
+    *
+    *     struct Layout : BitLayout<Field<32>, Reserved<12>, Field<4>> {
+    *        enum { FREQUENCY, FEC_OUTER };
+    *     };
+    *
+    * and both its serializer and a parser come from it. write() packs
+    * all the fields (reserved bits set to 1) into one LENGTH byte store
+    * instead of one shift, mask and store per field; pack() does the
+    * same in a constant expression. View reads the fields back in place
+    * from serialized data. Values are given in field order, skipping
+    * the Reserved ones, and are masked to their width.
+    */
+   template <class... F>
+   class BitLayout
+   {
+   public:
+      enum {
+         BITS = bit_layout_priv::sum(F::bits...),
+         LENGTH = BITS / 8,
+         FIELDS = bit_layout_priv::sum(F::is_value...)
+      };
+      static_assert(BITS % 8 == 0, "layouts fill whole bytes");
+
+      using Bytes = bit_layout_priv::Bytes<LENGTH>;
+
+      //! \brief Packs the field values into LENGTH bytes.
+      template <class... V>
+      static constexpr Bytes pack(V... v) {
+         static_assert(sizeof...(V) == FIELDS, "one value per Field");
+         const ui32 values[FIELDS + 1] = { static_cast<ui32>(v)..., 0 };
+         return packFields(std::index_sequence_for<F...>(), values);
+      }
+
+      //! \brief Writes the packed field values to the section.
+      template <class... V>
+      static bool write(Section &s, V... v) {
+         const Bytes b = pack(v...);
+         return s.setBits(b.data, LENGTH);
+      }
+
+      /*!
+       * \brief Zero-copy reader of the fields of serialized data.
+       *
+       * Holds the pointer only, so the data must outlive the view. A
+       * default view is empty and tests false.
+       */
+      class View
+      {
+      public:
+         constexpr View() : data(nullptr) { }
+         //! \param d Points to the layout's first byte.
+         explicit constexpr View(const ui8 *d) : data(d) { }
+
+         constexpr explicit operator bool() const { return data != nullptr; }
+
+         //! \brief Value of the N'th (non-reserved) field.
+         template <ui8 N>
+         constexpr ui32 get() const {
+            static_assert(N < FIELDS, "no such field");
+            using namespace bit_layout_priv;
+            return extract<offset<F...>(fieldIndex<F...>(N)),
+                           width<F...>(fieldIndex<F...>(N))>(data);
+         }
+
+         //! \brief The first byte after the layout.
+         constexpr const ui8 *end() const { return data + LENGTH; }
+
+      private:
+         const ui8 *data;
+      };
+
+   private:
+      template <size_t... I>
+      static constexpr Bytes packFields(std::index_sequence<I...>, const ui32 (&values)[FIELDS + 1]) {
+         Bytes b{};
+         const int expand[] = {
+            (bit_layout_priv::insert<bit_layout_priv::offset<F...>(I), F::bits>(
+               b, F::is_value ? values[bit_layout_priv::valueIndex<F...>(I)] : 0xffffffff), 0)...
+         };
+         (void) expand;
+         return b;
+      }
+   };
+   //! @}
+
+} // sigen namespace
@@ -31,13 +31,13 @@ namespace sigen
 {
    //
    // add a descriptor to the list
-   bool CAT::addDesc(Descriptor &d)
+   bool CAT::add_desc(Descriptor &d, bool in_arena)
    {
       // make sure we have enough room to add it
       if ( !incLength( d.length() ) )
          return false;
 
-      descriptors.add(d, 0);
+      descriptors.add(d, 0, in_arena);
       return true;
    }
 
@@ -46,68 +46,21 @@ namespace sigen
    //
    bool CAT::writeSection(Section& section, ui8 cur_sec, ui16 &sec_bytes) const
    {
-      bool done = false, exit = false;
-
-      while (!exit)
-      {
-         switch (run.op_state)
-         {
-           case INIT:
-              // associate the iterators to the list
-              run.d_iter = descriptors.begin();
-              run.op_state = WRITE_HEAD;
-
-           case WRITE_HEAD:
-              // common data for every section
-              // if table's length is > max_section_len, we'll
-              // overwrite the section length later on
-              writeSectionHeader(section);
-
-              // section count information
-              section.set08Bits(cur_sec);
-
-              // we don't know the last section number yet, so
-              // for now set it to 0,
-              section.set08Bits(0);//last_sec_num);
-
-              sec_bytes = BASE_LENGTH; // the minimum section size
-              run.op_state = (!run.d ? GET_DESC : WRITE_DESC);
-              break;
-
-           case GET_DESC:
-              // fetch the next descriptor
-              if (run.d_iter != descriptors.end()) {
-                 run.d = (*run.d_iter++).get();
-
-                 // check if we can fit it in this section
-                 if (sec_bytes + run.d->length() > getMaxDataLen()) {
-                    // we can't.. return so we can get a new section
-                    // we'll add it when we come back
-                    run.op_state = WRITE_HEAD;
-                    exit = true;
-                 }
-                 else // we found one to write
-                    run.op_state = WRITE_DESC;
-                 break;
-              }
-              else {
-                 // no more descriptors so all sections are done!
-                 run = Context();
-                 exit = done = true;
-              }
-              break;
-
-           case WRITE_DESC:
-              // add the network descriptor
-              run.d->buildSections(section);
-              sec_bytes += run.d->length();
-
-              // try to add another one
-              run.op_state = GET_DESC;
-              break;
-         }
-      }
-      return done;
+      return run.write(section, sec_bytes, BASE_LENGTH, getMaxDataLen(),
+                       [&](Section& s) {
+                          // common data for every section
+                          // if table's length is > max_section_len, we'll
+                          // overwrite the section length later on
+                          writeSectionHeader(s);
+
+                          // section count information
+                          s.set08Bits(cur_sec);
+
+                          // we don't know the last section number yet, so
+                          // for now set it to 0,
+                          s.set08Bits(0);
+                       },
+                       &descriptors, nullptr);
    }
 
 
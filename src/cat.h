@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "section_writer.h"
 #include "table.h"
 
 namespace sigen {
@@ -59,7 +60,19 @@ namespace sigen {
        * \brief Add a Descriptor to the descriptors loop.
        * \param desc Descriptor to add.
        */
-      bool addDesc(Descriptor& desc);
+      bool addDesc(Descriptor& desc) { return add_desc(desc, false); }
+      /*!
+       * \brief Construct a Descriptor in place in the descriptors loop.
+       *
+       * The `D` is built in the table's arena instead of being allocated
+       * on its own.
+       * \param args Arguments for the `D` constructor.
+       */
+      template <class D, class... Args>
+      bool emplaceDesc(Args&&... args) {
+         return emplace<D>([this](Descriptor& d) { return add_desc(d, true); },
+                           std::forward<Args>(args)...);
+      }
 
 #ifdef ENABLE_DUMP
       virtual void dump(std::ostream &) const;
@@ -72,16 +85,9 @@ namespace sigen {
 
       // list of descriptors
       DescList descriptors;
+      bool add_desc(Descriptor& d, bool in_arena);
 
-      enum State_t { INIT, WRITE_HEAD, GET_DESC, WRITE_DESC };
-      mutable struct Context {
-         Context() : d_done(false), op_state(INIT), d(nullptr) {}
-
-         bool d_done;
-         State_t op_state;
-         const Descriptor *d;
-         std::list<std::unique_ptr<Descriptor> >::const_iterator d_iter;
-      } run;
+      mutable SectionWriter<NoItem> run;
 
    protected:
       virtual bool writeSection(Section&, ui8, ui16 &) const;
@@ -0,0 +1,69 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// clock.cc: time sources for the UTC and time driven output
+// -----------------------------------
+
+#include <chrono>
+#include <thread>
+#include "clock.h"
+
+namespace sigen
+{
+   std::atomic<Clock *> Clock::current_clock(nullptr);
+
+   Clock &Clock::current()
+   {
+      static SystemClock system_clock;
+
+      Clock *c = current_clock.load(std::memory_order_acquire);
+      return c ? *c : system_clock;
+   }
+
+   void Clock::setCurrent(Clock *clock)
+   {
+      current_clock.store(clock, std::memory_order_release);
+   }
+
+
+   // --------------------------------
+   // system clock
+   //
+   time_t SystemClock::now() const
+   {
+      return ::time(nullptr);
+   }
+
+   void SystemClock::sleepUntil(time_t t)
+   {
+      std::this_thread::sleep_until(std::chrono::system_clock::from_time_t(t));
+   }
+
+
+   // --------------------------------
+   // simulated clock
+   //
+   void SimulatedClock::sleepUntil(time_t when)
+   {
+      time_t cur = t.load(std::memory_order_acquire);
+      while (cur < when && !t.compare_exchange_weak(cur, when, std::memory_order_acq_rel))
+         ;
+   }
+
+} // sigen namespace
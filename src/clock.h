@@ -0,0 +1,90 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// clock.h: time sources for the UTC and time driven output
+// -----------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <ctime>
+
+namespace sigen {
+
+   /*!
+    * \brief Source of the current time, in seconds since the epoch (UTC).
+    *
+    * UTC(), and so the TDT / TOT default constructors, read the
+    * current() clock, the system clock unless another one is set. A
+    * SimulatedClock set as current (or passed to a Scheduler) lets time
+    * driven output run as fast as it can be built.
+    */
+   class Clock
+   {
+   public:
+      virtual ~Clock() {}
+
+      //! \brief Current time.
+      virtual time_t now() const = 0;
+      //! \brief Returns once now() has reached t.
+      virtual void sleepUntil(time_t t) = 0;
+
+      //! \brief The clock UTC() reads.
+      static Clock &current();
+      /*!
+       * \brief Set the clock UTC() reads, `nullptr` for the system clock.
+       * \param clock Clock to use, not owned - must outlive its use.
+       */
+      static void setCurrent(Clock *clock);
+
+   private:
+      static std::atomic<Clock *> current_clock;
+   };
+
+   //! \brief The system's real time clock.
+   class SystemClock : public Clock
+   {
+   public:
+      time_t now() const;
+      void sleepUntil(time_t t);
+   };
+
+   /*!
+    * \brief Clock only moved on explicitly, so sleepUntil() returns at
+    * once with the time set to what was waited for.
+    */
+   class SimulatedClock : public Clock
+   {
+   public:
+      //! \param start Initial time.
+      explicit SimulatedClock(time_t start) : t(start) {}
+
+      time_t now() const { return t.load(std::memory_order_acquire); }
+      void sleepUntil(time_t when);
+
+      //! \brief Move the time forward (or back).
+      void advance(time_t secs) { t.fetch_add(secs, std::memory_order_acq_rel); }
+      //! \brief Set the time.
+      void set(time_t when) { t.store(when, std::memory_order_release); }
+
+   private:
+      std::atomic<time_t> t;
+   };
+
+} // sigen namespace
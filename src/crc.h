@@ -0,0 +1,67 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// crc.h: the mpeg-2 section crc32, usable in constant expressions
+// -----------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include "types.h"
+
+namespace sigen {
+
+   namespace crc_priv {
+      const ui32 POLYNOMIAL = 0x04c11db7;
+
+      // the byte-at-a-time table, generated at compile time
+      struct Table {
+         ui32 entry[256];
+
+         constexpr Table() : entry() {
+            for (ui32 i = 0; i < 256; i++) {
+               ui32 c = i << 24;
+               for (int b = 0; b < 8; b++)
+                  c = (c << 1) ^ ((c & 0x80000000) ? POLYNOMIAL : 0);
+               entry[i] = c;
+            }
+         }
+      };
+
+      constexpr Table CRC_TABLE;
+   }
+
+   //
+   // crc of a data block (from the given crc). Sections start from
+   // 0xffffffff
+   //
+   constexpr ui32 crc32(const ui8 *d, size_t len, ui32 crc = 0xffffffff)
+   {
+      for (size_t i = 0; i < len; i++)
+         crc = (crc << 8) ^ crc_priv::CRC_TABLE.entry[ ((crc >> 24) ^ d[i]) & 0xff ];
+      return crc;
+   }
+
+   // one byte step, for callers working on changed bits
+   constexpr ui32 crc32(ui32 crc, ui8 byte)
+   {
+      return (crc << 8) ^ crc_priv::CRC_TABLE.entry[ ((crc >> 24) ^ byte) & 0xff ];
+   }
+
+} // namespace
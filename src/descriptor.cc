@@ -23,6 +23,7 @@
 #include <iostream>
 #include <list>
 #include <string>
+#include <utility>
 #include "descriptor.h"
 
 namespace sigen
@@ -50,6 +51,27 @@ namespace sigen
    }
 #endif
 
+
+   // ============================================
+   // serialized descriptor
+   // --------------------------------------------
+   bool RawDesc::isValidLoop(const ui8 *data, ui16 len)
+   {
+      ui32 i = 0;
+      while (i + 2 <= len) {
+         i += 2 + data[i + 1];
+      }
+      return i == len;
+   }
+
+#ifdef ENABLE_DUMP
+   void RawDesc::dump(std::ostream &o) const
+   {
+      dumpHeader(o, RAW_D_S);
+      dumpData(o, data.data(), data.size());
+   }
+#endif
+
    //
    // increments the length by the given ccount (if there's room
    // available)
@@ -64,27 +86,28 @@ namespace sigen
    }
 
    //
-   // tests if the string can be added to the descriptor.. if not, it
-   // resizes the string, increments the descriptor length by the size
-   // and returns the resulting string
+   // tests if the text can be added to the descriptor.. if not, it
+   // truncates the view (not the text), increments the descriptor
+   // length by the size and returns a copy of the resulting text
    //
-   std::string Descriptor::incLength(const std::string& str)
+   std::string Descriptor::incLength(StrView str)
    {
-      std::string new_str(str);
-      ui16 len = new_str.length();
+      // compared wide so long strings can't wrap
+      str = str.prefix( CAPACITY - total_length );
 
-      // determine if the current string can fit
-      if ( !lengthFits(len) ) {
-         // nope.. truncate it to the max size
-         ui16 free_space = CAPACITY - total_length;
+      total_length += str.length();
+      return str.str();
+   }
 
-         new_str = new_str.substr( 0, free_space );
-         len = free_space;
-      }
+   std::string Descriptor::incLength(std::string&& str)
+   {
+      // same as above, compared wide so long strings can't wrap
+      size_t free_space = CAPACITY - total_length;
+      if (str.length() > free_space)
+         str.resize( free_space );
 
-      // increment the descriptor's length
-      total_length += len;
-      return new_str;
+      total_length += str.length();
+      return std::move(str);
    }
 
 
@@ -94,7 +117,7 @@ namespace sigen
 
    //
    // adds a new language to the specified network
-   bool MultilingualTextDesc::addText(const LanguageCode& code, const std::string& text)
+   bool MultilingualTextDesc::addText(const LanguageCode& code, StrView text)
    {
       // check if we can even fit a lang code & text length byte
       if (!incLength(Text::BASE_LEN))
@@ -126,7 +149,7 @@ namespace sigen
    // dumps the text loop
    void MultilingualTextDesc::dumpTextLoop(std::ostream& o, STRID data_type) const
    {
-      incOutLevel();
+      incOutLevel(o);
 
       for (const auto& text : ml_text_list) {
          identStr(o, CODE_S, text.code);
@@ -134,7 +157,7 @@ namespace sigen
          identStr(o, data_type, text.data);
       }
 
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -24,7 +24,10 @@
 
 #include <list>
 #include <string>
+#include <vector>
+#include "bit_layout.h"
 #include "language_code.h"
+#include "str_view.h"
 #include "table.h"
 #include "tstream.h"
 
@@ -42,7 +45,9 @@ namespace sigen {
     * allocated by the caller using the `new` operator and fully
     * populated before adding them to a table instance. Once added,
     * the table claims ownership of the descriptor pointer and will
-    * handle deletion.
+    * handle deletion. Alternatively, the tables' `emplace...Desc<D>()`
+    * methods construct the descriptor in place in the table's own
+    * arena from the `D` constructor arguments.
     *
     * \warning Note that once added, the descriptor must not
     * be modified by the caller (in essence, the pointer is now
@@ -82,10 +87,31 @@ namespace sigen {
       bool lengthFits(ui16 len) const { return (total_length + len < CAPACITY); }
       // increments the length of the desc based on the given size
       bool incLength(ui8 len);
-      // increments the length of the desc based on the given string's length
-      std::string incLength(const std::string &str);
+      // increments the length of the desc by the given text's length,
+      // truncating the view to fit, and returns a copy of what fits
+      std::string incLength(StrView str);
+      // as above but truncates the passed string in place
+      std::string incLength(std::string &&str);
    };
 
+   /*!
+    * \brief Zero-copy view of the fixed fields of a serialized `D`.
+    *
+    * \param data Descriptor bytes, starting at the tag.
+    * \param len Number of bytes available at data.
+    * \return A D::Layout::View on the descriptor data, or an empty one
+    * if data doesn't hold a `D` long enough for the layout.
+    */
+   template <class D>
+   typename D::Layout::View descView(const ui8 *data, ui16 len)
+   {
+      using View = typename D::Layout::View;
+
+      if (len < 2 || data[0] != D::TAG || data[1] < D::Layout::LENGTH || len < data[1] + 2)
+         return View();
+      return View(data + 2);
+   }
+
 
 
    // ---------------------------
@@ -131,7 +157,7 @@ namespace sigen {
    {
    protected:
       // constructor
-      StringDataDesc(ui8 tag, const std::string &str) :
+      StringDataDesc(ui8 tag, StrView str) :
          Descriptor(tag, 0),
          data( incLength(str) ) {
       }
@@ -154,6 +180,46 @@ namespace sigen {
    };
 
 
+   /*!
+    * \brief Descriptor built from its serialized bytes, as added by the
+    * bulk loading methods.
+    */
+   class RawDesc : public Descriptor
+   {
+   public:
+      /*!
+       * \brief Constructor.
+       * \param tag Descriptor tag.
+       * \param data Descriptor data (following the tag and length bytes).
+       * \param len Length of the data.
+       */
+      RawDesc(ui8 tag, const ui8 *data, ui8 len) :
+         Descriptor(tag, len),
+         data(data, data + len) { }
+      RawDesc() = delete;
+
+      virtual void buildSections(Section &s) const {
+         Descriptor::buildSections(s);
+         s.setBits( data );
+      }
+
+      /*!
+       * \brief Checks a serialized descriptor loop: tag / length headers
+       * that add up to exactly len bytes.
+       * \param data Descriptor loop bytes.
+       * \param len Length of the loop.
+       */
+      static bool isValidLoop(const ui8 *data, ui16 len);
+
+#ifdef ENABLE_DUMP
+      virtual void dump(std::ostream &o) const;
+#endif
+
+   private:
+      std::vector<ui8> data;
+   };
+
+
    /*!
     * \brief Abstract Multilingual Text Descriptor base class.
     */
@@ -165,7 +231,7 @@ namespace sigen {
        * \param lang Language code as per ISO 639-2.
        * \param text Text to add.
        */
-      bool addText(const LanguageCode& lang, const std::string& text);
+      bool addText(const LanguageCode& lang, StrView text);
 
       [[deprecated("replaced by addText()")]] bool addLanguage(const LanguageCode& lang,
                                                                const std::string& text) {
@@ -187,7 +253,7 @@ namespace sigen {
          std::string data;
 
          // constructor
-         Text(const LanguageCode& c, const std::string &t) : code(c), data(t) { }
+         Text(const LanguageCode& c, std::string &&t) : code(c), data(std::move(t)) { }
          Text() = delete;
 
          ui16 length() const { return BASE_LEN + data.length(); }
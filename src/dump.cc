@@ -21,406 +21,747 @@
 // library if ENABLE_DUMP is defined in the Makefile
 // -----------------------------------
 
-#include <iostream>
-#include <iomanip>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ios>
+#include <ostream>
+#include <streambuf>
 #include <string>
-#include <map>
-#include <sstream>
+#include <unistd.h>
 #include "dump.h"
 #include "language_code.h"
 #include "utc.h"
 
 namespace sigen
 {
-   // used for display
-   static uint_fast8_t level = 0;
-   static const uint_fast8_t LINE_WIDTH = 16;
-   static const uint_fast8_t T_STR_W = 20;
+   namespace dump_priv
+   {
+      // used for display
+      const uint_fast8_t LINE_WIDTH = 16;
+      const uint_fast8_t T_STR_W = 20;
+
+      enum DumpFormat { AUTO, DEC, HEX, DECHEX, TABLE, FIELDS, DESC };
+      struct Label {
+         STRID id;
+         const char* str;
+         DumpFormat format = AUTO;
+      };
+
+      //
+      // output strings
+      // indexed by STRID
+      constexpr Label out_str[] = {
+         { IGNORE_S, "" },
+
+         // identifier strings
+         { ADAP_FLD_DATA_IDENT_S, "Adapt. field data ident.", DECHEX },
+         { ADDITIONAL_INFO_S, "Additional info" },
+         { ALIGNMENT_TYPE_S, "Alignment type" },
+         { ANCILLARY_DATA_IDENT_S, "Ancill. data idnt." },
+         { ANCILLARY_PAGE_ID_S, "Ancillary pg. id", HEX },
+         { ANNOUNCEMENT_SUPPORT_IND_S, "Announc. sup. ind." },
+         { ANNOUNCEMENT_TYPE_S, "Announcement type" },
+         { ASVC_S, "asvc" },
+         { ASVC_FLAG_S, "asvc flag" },
+         { AUDIO_TYPE_S, "Audio type" },
+         { BANDWIDTH_S, "Bandwidth" },
+         { BOUND_VALID_F_S, "Bound valid flag" },
+         { BOUQUET_ID_S, "Bouquet id" },
+         { BOUQUET_DESC_LEN_S, "Bouquet desc len", DECHEX },
+         { BOUQUET_NAME_S, "Bouquet name" },
+         { BOUQUET_NAME_LEN_S, "Bouquet name len", DECHEX },
+         { BSID_S, "bsid" },
+         { BSID_FLAG_S, "bsid_flag" },
+         { CA_PID_S, "CA PID", DECHEX },
+         { CA_SYSTEM_ID_S, "CA system id", DECHEX },
+         { CELL_ID_S, "Cell id" },
+         { CELL_ID_EXT_S, "Cell id ext." },
+         { CELL_LATITUDE_S, "Cell latitude", DECHEX },
+         { CELL_LONGITUDE_S, "Cell longitude", DECHEX },
+         { CELL_EXT_LAT_S, "Cell ext. of lat.", DECHEX },
+         { CELL_EXT_LON_S, "Cell ext. of lon.", DECHEX },
+         { CHROMA_FORMAT_S, "Chroma format" },
+         { CLOCK_ACCURACY_EXP_S, "Clock accuracy exp" },
+         { CLOCK_ACCURACY_INT_S, "Clock accuracy int" },
+         { CLOSED_GOP_F_S, "Closed gop flag" },
+         { CODE_S, "ISO 639 Code" },
+         { CODING_TYPE_S, "Coding type" },
+         { COMPONENT_TAG_S, "Component tag" },
+         { COMPONENT_TYPE_S, "Component type" },
+         { COMPONENT_TYPE_FLAG_S, "Component type flag" },
+         { COMPOSITION_PAGE_ID_S, "Compositn. pg. id", HEX },
+         { CONNECTION_TYPE_S, "Connection type" },
+         { CONSTELLATION_S, "Constellation" },
+         { CONSTR_PARAM_FLAG_S, "Cnstr. param. flag" },
+         { CONTENT_NL_1, "Content nbl lvl 1" },
+         { CONTENT_NL_2, "Content nbl lvl 2" },
+         { CORE_NUM_S, "Core number" },
+         { CORE_NUM_LEN_S, "Core number len", DECHEX },
+         { COUNTRY_AVAIL_FLAG_S, "Cntry avail. flag" },
+         { COUNTRY_CODE_S, "Country code" },
+         { COUNTRY_PREFIX_S, "Country prefix" },
+         { COUNTRY_PREFIX_LEN_S, "Country prefix len", DECHEX },
+         { COUNTRY_REGION_ID_S, "Country region id" },
+         { COPYRIGHT_IDENT_S, "Copyright ident", DECHEX },
+         { COPYRIGHT_INFO_S, "Copyright info" },
+         { CR_HP_STREAM_S, "Code rate HP stream" },
+         { CR_LP_STREAM_S, "Code rate LP stream" },
+         { CURR_NEXT_IND_S, "Current next ind." },
+         { DATA_S, "Data" },
+         { DATA_BCAST_ID_S, "Data broadcast id", DECHEX },
+         { DESC_LEN_S, "Desc. len", DECHEX },
+         { DESC_LOOP_LEN_S, "Desc. loop len", DECHEX },
+         { DESC_NUM_S, "Desc. num" },
+         { DESCRPTN_S, "Description" },
+         { DESCRPTN_LEN_S, "Description len", DECHEX },
+         { DURATION_S, "Duration" },
+         { EIT_PF_F_S, "EIT p/f" },
+         { EIT_SCHED_FLAG_S, "EIT sched. flag" },
+         { ELEM_PID_S, "Elementary PID", DECHEX },
+         { ES_INFO_LEN_S, "ES info len", DECHEX },
+         { EVENT_ID_S, "Event id" },
+         { EVENT_NAME_S, "Event name" },
+         { EVENT_NAME_LEN_S, "Event name len", DECHEX },
+         { EXT_CLOCK_REF_IND_S, "Ext clock ref ind" },
+         { FEC_I_S, "FEC inner" },
+         { FEC_O_S, "FEC outer" },
+         { FOREIGN_AVAIL_S, "Foreign avail." },
+         { FORMAT_IDENT_S, "Format identifier" },
+         { FRM_RATE_CODE_S, "Frame rate code" },
+         { FRM_RATE_EXT_FLAG_S, "Frame rate ext flag" },
+         { FREE_CA_MODE_S, "Free CA mode" },
+         { FREE_FRMT_FLAG_S, "Free format flag" },
+         { FREQ_S, "Frequency", DECHEX },
+         { GUARD_INTERV_S, "Guard interval" },
+         { HAND_OVER_TYPE_S, "Hand-over type" },
+         { H_EMBEDDED_LAYER_S, "Hierarchy emb layer" },
+         { H_INFO_S, "Hierarchy info" },
+         { H_LAYER_IDX_S, "Hierarchy layer idx" },
+         { H_PRIORITY_S, "Hierarchy priority" },
+         { H_TYPE_S, "Hierarchy type" },
+         { HORIZ_OFFSET_S, "Horizontal offset" },
+         { HORIZ_SIZE_S, "Horizontal size" },
+         { ID_S, "Id" },
+         { IDENT_INFO_S, "Identification info" },
+         { IDENTICAL_GOP_F_S, "Identical gop flag" },
+         { INITIAL_SERV_ID_S, "Initial service id", DECHEX },
+         { INTNL_AC_S, "Intnl area code" },
+         { INTNL_AC_LEN_S, "Intnl a/c len", DECHEX },
+         { ITEM_S, "Item" },
+         { ITEM_LEN_S, "Item len", DECHEX },
+         { LANGUAGE_CODE_S, "Language code" },
+         { LAST_DESC_NUM_S, "Last desc num" },
+         { LAYER_S, "Layer" },
+         { LEAK_VALID_FLAG_S, "Leak valid flag" },
+         { LEN_S, "Length", DECHEX },
+         { LENGTH_OF_ITEMS_S, "Length of items", DECHEX },
+         { LINKAGE_TYPE_S, "Linkage type" },
+         { LOCAL_TIME_OFFSET_S, "Local time offset", DECHEX },
+         { LTO_POLARITY_S, "Lcl time offset pol" },
+         { LTW_OFFSET_LB_S, "LTW offset low bnd" },
+         { LTW_OFFSET_UB_S, "LTW offset upp bnd" },
+         { MAGAZINE_NUM_S, "Magazine number" },
+         { MAINID_S, "mainid" },
+         { MAINID_FLAG_S, "mainid flag" },
+         { MAX_BITRATE_S, "Maximum bitrate", DECHEX },
+         { MAX_GOP_LEN_S, "Max gop len", DECHEX },
+         { MAX_OS_BUFFER_S, "Max over. smth. buf" },
+         { MDV_VALID_FLAG_S, "Mdv valid flag" },
+         { MIN_OS_RATE_S, "Min over. smth. rate" },
+         { MIXINFO_EXISTS_FLAG_S, "Mix-info exists flag" },
+         { MOD_S, "Modulation" },
+         { MOD_SYS_S, "Modulation system" },
+         { MPE_FEC_IND_S, "MPE-FEC ind." },
+         { MPEG_1_ONLY_FLAG_S, "MPEG1 only flag" },
+         { MPLEX_DELAY_VAR_S, "Mplex delay var" },
+         { MPLEX_STRATEGY_S, "Mplex strategy" },
+         { MULT_FRM_RATE_FLAG_S, "Mult. frm. rt flag" },
+         { NAME_LEN_S, "Name length", DECHEX },
+         { NTNL_AC_S, "Ntnl area code" },
+         { NTNL_AC_LEN_S, "Ntnl a/c len", DECHEX },
+         { NETWORK_DESC_LEN_S, "Network desc. len", DECHEX },
+         { NETWORK_ID_S, "Network id", DECHEX },
+         { NETWORK_NAME_S, "Network name" },
+         { NEW_SERV_ID_S, "New service id", DECHEX },
+         { NEXT_TIME_OFFSET_S, "Next time offset", DECHEX },
+         { OPERATOR_CODE_S, "Operator code" },
+         { OPERATOR_CODE_LEN_S, "Operator code len" },
+         { ORB_POS_S, "Orbital position" },
+         { ORIGIN_TYPE_S, "Origin type" },
+         { ORIG_NETWORK_ID_S, "Orig. network id", DECHEX },
+         { OTHER_FREQ_FLAG_S, "Other freq flag" },
+         { OUI_S, "OUI" },
+         { OUI_DATA_LEN_S, "OUI data len", DECHEX },
+         { PAGE_NUM_S, "Page number" },
+         { PCR_PID_S, "PCR Pid", DECHEX },
+         { PEAK_RATE_S, "Peak rate" },
+         { PEL_ASPECT_R_S, "Pel aspect ratio" },
+         { PID_S, "Pid", DECHEX },
+         { POL_S, "Polarisation" },
+         { PRIORITY_S, "Priority" },
+         { PROF_LVL_IND_S, "Prof/level ind." },
+         { PROG_IDENT_LABEL_S, "Programme idnt. lbl" },
+         { PROGRAM_INFO_LEN_S, "Program info len", DECHEX },
+         { PROGRAM_NUM_S, "Program number", DECHEX },
+         { PROV_NAME_S, "Provider name" },
+         { PROV_NAME_LEN_S, "Provider name len", DECHEX },
+         { PVT_DATA_S, "Private data" },
+         { PVT_DATA_IND_S, "Private data ind", DECHEX },
+         { RATING_S, "Rating" },
+         { REF_EVENT_ID_S, "Ref. event id" },
+         { REF_SID_S, "Ref. service id" },
+         { REF_TYPE_S, "Ref. type" },
+         { RESERVED_S, "reserved", HEX },
+         { RESERVED_FU_S, "rsvrd. future use", HEX },
+         { ROLLOFF_S, "Rolloff" },
+         { RUNNING_STATUS_S, "Running status" },
+         { SB_LEAK_RATE_S, "SB leak rate", DECHEX },
+         { SB_SIZE_S, "SB size" },
+         { SECT_SYNTAX_IND_S, "Section syn. ind." },
+         { SELECTOR_S, "Selector" },
+         { SELECTOR_LEN_S, "Selector len", DECHEX },
+         { SERVICE_ID_S, "Service id", DECHEX },
+         { SERVICE_NAME_S, "Service name" },
+         { SERVICE_NAME_LEN_S, "Service name len", DECHEX },
+         { SRC_ID_S, "Source id" },
+         { SRC_NAME_S, "Source name" },
+         { SRC_NAME_LEN_S, "Source name len", DECHEX },
+         { START_TIME_S, "Start time" },
+         { STILL_PICT_FLAG_S, "Still pic flag" },
+         { STREAM_CONTENT_S, "Stream content" },
+         { STREAM_TYPE_S, "Stream type" },
+         { SUBCELL_INFO_LOOP_LEN_S, "Subcell loop len", DECHEX },
+         { SUBCELL_LAT_S, "Subcell lat." },
+         { SUBCELL_LON_S, "Subcell lon." },
+         { SUBCELL_EXT_LAT_S, "Subcell ext. of lat." },
+         { SUBCELL_EXT_LON_S, "Subcell ext. of lon." },
+         { SUBSTREAM_1_S, "Substream 1" },
+         { SUBSTREAM_1_FLAG_S, "Substream 1 flag" },
+         { SUBSTREAM_2_S, "Substream 2" },
+         { SUBSTREAM_2_FLAG_S, "Substream 2 flag" },
+         { SUBSTREAM_3_S, "Substream 3" },
+         { SUBSTREAM_3_FLAG_S, "Substream 3 flag" },
+         { SYM_RATE_S, "Symbol rate" },
+         { TAG_S, "Tag", HEX },
+         { TID_S, "Table id" },
+         { TABLE_LEN_S, "Table length", DECHEX },
+         { TABLE_TYPE_S, "Table type" },
+         { TEXT_S, "Text" },
+         { TEXT_LEN_S, "Text len", DECHEX },
+         { TIME_SLICE_IND_S, "Time slicing ind." },
+         { TRANS_MODE_S, "Transmission mode" },
+         { TYPE_S, "Type" },
+         { UPDATE_TYPE_S, "Update type" },
+         { UPDATE_VER_FLAG_S, "Update vers. flg" },
+         { UPDATE_VER_S, "Update version" },
+         { USER_NL_1, "User nibble 1", HEX },
+         { USER_NL_2, "User nibble 2", HEX },
+         { UTC_S, "UTC" },
+         { VAR_RATE_AUD_IND_S, "Variable rate audio ind." },
+         { VER_NUM_S, "Version number" },
+         { VERT_OFFSET_S, "Vertical offset" },
+         { VERT_SIZE_S, "Vertical size" },
+         { WEST_EAST_S, "West/east flag" },
+         { WIN_PRIORITY_S, "Window priority" },
+         { XPORT_DESC_LEN_S, "Xport desc len", DECHEX },
+         { XPORT_STREAM_ID_S, "Xport stream id", DECHEX },
+         { XS_LOOP_LEN_S, "Xprt str loop len", DECHEX },
+         { XPOSER_FREQ_S, "Xposer frequency", DECHEX },
+
+         // table strings
+         { BAT_DUMP_S, "- BAT Dump -", TABLE },
+         { CAT_DUMP_S, "- CAT Dump -", TABLE },
+         { EIT_PF_ACTUAL_S, "- EIT PF Dump (Actual) -", TABLE },
+         { EIT_PF_OTHER_S, "- EIT PF Dump (Other) -", TABLE },
+         { EIT_ES_ACTUAL_S, "- EIT ES (Actual) -", TABLE },
+         { EIT_ES_OTHER_S, "- EIT ES (Other) -", TABLE },
+         { NIT_DUMP_ACTUAL_S, "- NIT Dump (Actual) -", TABLE },
+         { NIT_DUMP_OTHER_S, "- NIT Dump (Other) -", TABLE },
+         { PAT_DUMP_S, "- PAT Dump -", TABLE },
+         { PMT_DUMP_S, "- PMT Dump -", TABLE },
+         { RST_DUMP_S, "- RST Dump -", TABLE },
+         { SDT_DUMP_ACTUAL_S, "- SDT Dump (Actual) -", TABLE },
+         { SDT_DUMP_OTHER_S, "- SDT Dump (Other) -", TABLE },
+         { ST_DUMP_S, "- ST Dump -", TABLE },
+         { TDT_DUMP_S, "- TDT Dump -", TABLE },
+         { TOT_DUMP_S, "- TOT Dump -", TABLE },
+
+         { F_EVENT_LIST_S, "-* Following Event List *-", FIELDS },
+         { P_EVENT_LIST_S, "-* Present Event List *-", FIELDS },
+         { SERVICE_LIST_S, "-* Service List *-", FIELDS },
+         { STREAM_LIST_S, "-* Stream List *-", FIELDS },
+         { XPORT_STREAM_S, "*-- Transport Stream --*", FIELDS },
+
+         // descriptor strings
+         { AC3_D_S, "AC-3", DESC },
+         { ADAPTATION_FIELD_DATA_S, "Adaptation Field Data", DESC },
+         { ANCILLARY_DATA_D_S, "Ancillary Data", DESC },
+         { ANNOUNCEMENT_SUPPORT_D_S, "Announcement Support", DESC },
+         { AUDIO_STREAM_D_S, "Audio Stream", DESC },
+         { BOUQUET_NAME_D_S, "Bouquet name", DESC },
+         { CA_D_S, "CA", DESC },
+         { CA_IDENT_D_S, "CA Identifier", DESC },
+         { CABLE_DEL_SYS_D_S, "Cable Delivery System", DESC },
+         { CELL_FREQ_LINK_D_S, "Cell Frequency Link", DESC },
+         { CELL_LIST_D_S, "Cell List", DESC },
+         { COMPONENT_D_S, "Component", DESC },
+         { CONTENT_D_S, "Content", DESC },
+         { COPYRIGHT_D_S, "Copyright", DESC },
+         { COUNTRY_AVAIL_D_S, "Country Availability", DESC },
+         { DATA_BCAST_D_S, "Data Broadcast", DESC },
+         { DATA_BCAST_ID_D_S, "Data Broadcast Id", DESC },
+         { DATA_STREAM_ALIGNMENT_D_S, "Data Stream Alignment", DESC },
+         { DSNG_D_S, "DSNG", DESC },
+         { EXTENDED_AC3_D_S, "Extended AC-3", DESC },
+         { EXTENDED_EVENT_D_S, "Extended Event", DESC },
+         { FREQ_LIST_D_S, "Frequency List", DESC },
+         { HIERARCHY_D_S, "Hierarchy", DESC },
+         { IBP_D_S, "IBP", DESC },
+         { ISO_639_LANG_D_S, "ISO 639 Language", DESC },
+         { LINKAGE_D_S, "Linkage", DESC },
+         { LOCAL_TIME_OFFSET_D_S, "Local Time Offset", DESC },
+         { MAXIMUM_BITRATE_D_S, "Maximum Bitrate", DESC },
+         { MULTILING_BOUQUET_NAME_D_S, "Multilingual Bouquet Name", DESC },
+         { MULTILING_COMPONENT_D_S, "Multilingual Component", DESC },
+         { MULTILING_NET_NAME_D_S, "Multilingual Network Name", DESC },
+         { MULTILING_SERV_NAME_D_S, "Multilingual Service Name", DESC },
+         { MULTIPLEX_BUF_UTIL_D_S, "Multiplex Buff Utilization", DESC },
+         { NETWORK_NAME_D_S, "Network Name", DESC },
+         { NVOD_REF_D_S, "NVOD Reference", DESC },
+         { PARENTAL_RATING_D_S, "Parental Rating", DESC },
+         { PARTIAL_TS_D_S, "Partial Transport Stream", DESC },
+         { PDC_D_S, "PDC", DESC },
+         { PVT_DATA_IND_D_S, "Private Data Indicator", DESC },
+         { PVT_DATA_SPEC_D_S, "Private Data Specifier", DESC },
+         { RAW_D_S, "Raw", DESC },
+         { REGISTRATION_D_S, "Registration", DESC },
+         { SAT_DEL_SYS_D_S, "Satellite Delivery System", DESC },
+         { SERV_D_S, "Service", DESC },
+         { SERV_LIST_D_S, "Service List", DESC },
+         { SERV_MOVE_D_S, "Service Move", DESC },
+         { SHORT_EVENT_D_S, "Short Event", DESC },
+         { SHORT_SMTHNG_BUF_D_S, "Short Smoothing Buffer", DESC },
+         { SMOOTHING_BUF_D_S, "Smoothing Buffer", DESC },
+         { STD_D_S, "STD", DESC },
+         { STREAM_IDENT_D_S, "Stream Identifier", DESC },
+         { STUFFING_D_S, "Stuffing", DESC },
+         { SUBTITLING_D_S, "Subtitling", DESC },
+         { SYSTEM_CLOCK_D_S, "System Clock", DESC },
+         { TARGET_BACKGROUND_GRID_D_S, "Target Background Grid", DESC },
+         { TELEPHONE_D_S, "Telephone", DESC },
+         { TELETEXT_D_S, "Teletext", DESC },
+         { TER_DEL_SYS_D_S, "Terrestrial Delivery System", DESC },
+         { TIME_SHIFTED_SERV_D_S, "Time Shifted Service", DESC },
+         { TIME_SHIFTED_EVENT_D_S, "Time Shifted Event", DESC },
+         { VIDEO_STREAM_D_S, "Video Stream", DESC },
+         { VIDEO_WINDOW_D_S, "Video Window", DESC },
+         { XPORT_STREAM_D_S, "Transport Stream", DESC },
+      };
+
+      enum { NUM_LABELS = sizeof(out_str) / sizeof(out_str[0]) };
+
+      // each label has to sit at its STRID's index
+      constexpr bool labelsOrdered()
+      {
+         for (int i = 0; i < NUM_LABELS; i++) {
+            if (out_str[i].id != i)
+               return false;
+         }
+         return true;
+      }
+      static_assert(NUM_LABELS == XPORT_STREAM_D_S + 1, "a STRID is missing its label");
+      static_assert(labelsOrdered(), "labels are not in STRID order");
+
+      //
+      // the indentation level is kept in the stream being dumped to, so
+      // each dump has its own regardless of the thread it runs on
+      int levelIndex()
+      {
+         static const int idx = std::ios_base::xalloc();
+         return idx;
+      }
 
-   enum DumpFormat { AUTO, DEC, HEX, DECHEX, TABLE, FIELDS, DESC };
-   struct Label {
-      std::string str;
-      DumpFormat format = AUTO;
-   };
+      // the stream's record writer (DumpStream JSON / TLV), if any
+      int writerIndex()
+      {
+         static const int idx = std::ios_base::xalloc();
+         return idx;
+      }
 
-   //
-   // output strings
-   static const std::map<STRID, Label> out_str = {
-      { IGNORE_S, { "" } },
-
-      // identifier strings
-      { ADAP_FLD_DATA_IDENT_S, { "Adapt. field data ident.", DECHEX } },
-      { ADDITIONAL_INFO_S, { "Additional info" } },
-      { ALIGNMENT_TYPE_S, { "Alignment type" } },
-      { ANCILLARY_DATA_IDENT_S, { "Ancill. data idnt." } },
-      { ANCILLARY_PAGE_ID_S, { "Ancillary pg. id", HEX } },
-      { ANNOUNCEMENT_SUPPORT_IND_S, { "Announc. sup. ind." } },
-      { ANNOUNCEMENT_TYPE_S, { "Announcement type" } },
-      { ASVC_S, { "asvc" } },
-      { ASVC_FLAG_S, { "asvc flag" } },
-      { AUDIO_TYPE_S, { "Audio type" } },
-      { BANDWIDTH_S, { "Bandwidth" } },
-      { BOUND_VALID_F_S, { "Bound valid flag" } },
-      { BOUQUET_ID_S, { "Bouquet id" } },
-      { BOUQUET_DESC_LEN_S, { "Bouquet desc len", DECHEX } },
-      { BOUQUET_NAME_S, { "Bouquet name" } },
-      { BOUQUET_NAME_LEN_S, { "Bouquet name len", DECHEX } },
-      { BSID_S, { "bsid" } },
-      { BSID_FLAG_S, { "bsid_flag" } },
-      { CA_PID_S, { "CA PID", DECHEX } },
-      { CA_SYSTEM_ID_S, { "CA system id", DECHEX } },
-      { CELL_ID_S, { "Cell id" } },
-      { CELL_ID_EXT_S, { "Cell id ext." } },
-      { CELL_LATITUDE_S, { "Cell latitude", DECHEX } },
-      { CELL_LONGITUDE_S, { "Cell longitude", DECHEX } },
-      { CELL_EXT_LAT_S, { "Cell ext. of lat.", DECHEX } },
-      { CELL_EXT_LON_S, { "Cell ext. of lon.", DECHEX } },
-      { CHROMA_FORMAT_S, { "Chroma format" } },
-      { CLOCK_ACCURACY_EXP_S, { "Clock accuracy exp" } },
-      { CLOCK_ACCURACY_INT_S, { "Clock accuracy int" } },
-      { CLOSED_GOP_F_S, { "Closed gop flag" } },
-      { CODE_S, { "ISO 639 Code" } },
-      { CODING_TYPE_S, { "Coding type" } },
-      { COMPONENT_TAG_S, { "Component tag" } },
-      { COMPONENT_TYPE_S, { "Component type" } },
-      { COMPONENT_TYPE_FLAG_S, { "Component type flag" } },
-      { COMPOSITION_PAGE_ID_S, { "Compositn. pg. id", HEX } },
-      { CONNECTION_TYPE_S, { "Connection type" } },
-      { CONSTELLATION_S, { "Constellation" } },
-      { CONSTR_PARAM_FLAG_S, { "Cnstr. param. flag" } },
-      { CONTENT_NL_1, { "Content nbl lvl 1" } },
-      { CONTENT_NL_2, { "Content nbl lvl 2" } },
-      { CORE_NUM_S, { "Core number" } },
-      { CORE_NUM_LEN_S, { "Core number len", DECHEX } },
-      { COUNTRY_AVAIL_FLAG_S, { "Cntry avail. flag" } },
-      { COUNTRY_CODE_S, { "Country code" } },
-      { COUNTRY_PREFIX_S, { "Country prefix" } },
-      { COUNTRY_PREFIX_LEN_S, { "Country prefix len", DECHEX } },
-      { COUNTRY_REGION_ID_S, { "Country region id" } },
-      { COPYRIGHT_IDENT_S, { "Copyright ident", DECHEX } },
-      { COPYRIGHT_INFO_S, { "Copyright info" } },
-      { CR_HP_STREAM_S, { "Code rate HP stream" } },
-      { CR_LP_STREAM_S, { "Code rate LP stream" } },
-      { CURR_NEXT_IND_S, { "Current next ind." } },
-      { DATA_S, { "Data" } },
-      { DATA_BCAST_ID_S, { "Data broadcast id", DECHEX } },
-      { DESC_LEN_S, { "Desc. len", DECHEX } },
-      { DESC_LOOP_LEN_S, { "Desc. loop len", DECHEX } },
-      { DESC_NUM_S, { "Desc. num" } },
-      { DESCRPTN_S, { "Description" } },
-      { DESCRPTN_LEN_S, { "Description len", DECHEX } },
-      { DURATION_S, { "Duration" } },
-      { EIT_PF_F_S, { "EIT p/f" } },
-      { EIT_SCHED_FLAG_S, { "EIT sched. flag" } },
-      { ELEM_PID_S, { "Elementary PID", DECHEX } },
-      { ES_INFO_LEN_S, { "ES info len", DECHEX } },
-      { EVENT_ID_S, { "Event id" } },
-      { EVENT_NAME_S, { "Event name" } },
-      { EVENT_NAME_LEN_S, { "Event name len", DECHEX } },
-      { EXT_CLOCK_REF_IND_S, { "Ext clock ref ind" } },
-      { FEC_I_S, { "FEC inner" } },
-      { FEC_O_S, { "FEC outer" } },
-      { FOREIGN_AVAIL_S, { "Foreign avail." } },
-      { FORMAT_IDENT_S, { "Format identifier" } },
-      { FRM_RATE_CODE_S, { "Frame rate code" } },
-      { FRM_RATE_EXT_FLAG_S, { "Frame rate ext flag" } },
-      { FREE_CA_MODE_S, { "Free CA mode" } },
-      { FREE_FRMT_FLAG_S, { "Free format flag" } },
-      { FREQ_S, { "Frequency", DECHEX } },
-      { GUARD_INTERV_S, { "Guard interval" } },
-      { HAND_OVER_TYPE_S, { "Hand-over type" } },
-      { H_EMBEDDED_LAYER_S, { "Hierarchy emb layer" } },
-      { H_INFO_S, { "Hierarchy info" } },
-      { H_LAYER_IDX_S, { "Hierarchy layer idx" } },
-      { H_PRIORITY_S, { "Hierarchy priority" } },
-      { H_TYPE_S, { "Hierarchy type" } },
-      { HORIZ_OFFSET_S, { "Horizontal offset" } },
-      { HORIZ_SIZE_S, { "Horizontal size" } },
-      { ID_S, { "Id" } },
-      { IDENT_INFO_S, { "Identification info" } },
-      { IDENTICAL_GOP_F_S, { "Identical gop flag" } },
-      { INITIAL_SERV_ID_S, { "Initial service id", DECHEX } },
-      { INTNL_AC_S, { "Intnl area code" } },
-      { INTNL_AC_LEN_S, { "Intnl a/c len", DECHEX } },
-      { ITEM_S, { "Item" } },
-      { ITEM_LEN_S, { "Item len", DECHEX } },
-      { LANGUAGE_CODE_S, { "Language code" } },
-      { LAST_DESC_NUM_S, { "Last desc num" } },
-      { LAYER_S, { "Layer" } },
-      { LEAK_VALID_FLAG_S, { "Leak valid flag" } },
-      { LEN_S, { "Length", DECHEX } },
-      { LENGTH_OF_ITEMS_S, { "Length of items", DECHEX } },
-      { LINKAGE_TYPE_S, { "Linkage type" } },
-      { LOCAL_TIME_OFFSET_S, { "Local time offset", DECHEX } },
-      { LTO_POLARITY_S, { "Lcl time offset pol" } },
-      { LTW_OFFSET_LB_S, { "LTW offset low bnd" } },
-      { LTW_OFFSET_UB_S, { "LTW offset upp bnd" } },
-      { MAGAZINE_NUM_S, { "Magazine number" } },
-      { MAINID_S, { "mainid" } },
-      { MAINID_FLAG_S, { "mainid flag" } },
-      { MAX_BITRATE_S, { "Maximum bitrate", DECHEX } },
-      { MAX_GOP_LEN_S, { "Max gop len", DECHEX } },
-      { MAX_OS_BUFFER_S, { "Max over. smth. buf" } },
-      { MDV_VALID_FLAG_S, { "Mdv valid flag" } },
-      { MIN_OS_RATE_S, { "Min over. smth. rate" } },
-      { MIXINFO_EXISTS_FLAG_S, { "Mix-info exists flag" } },
-      { MOD_S, { "Modulation" } },
-      { MOD_SYS_S, { "Modulation system" } },
-      { MPE_FEC_IND_S, { "MPE-FEC ind." } },
-      { MPEG_1_ONLY_FLAG_S, { "MPEG1 only flag" } },
-      { MPLEX_DELAY_VAR_S, { "Mplex delay var" } },
-      { MPLEX_STRATEGY_S, { "Mplex strategy" } },
-      { MULT_FRM_RATE_FLAG_S, { "Mult. frm. rt flag" } },
-      { NAME_LEN_S, { "Name length", DECHEX } },
-      { NTNL_AC_S, { "Ntnl area code" } },
-      { NTNL_AC_LEN_S, { "Ntnl a/c len", DECHEX } },
-      { NETWORK_DESC_LEN_S, { "Network desc. len", DECHEX } },
-      { NETWORK_ID_S, { "Network id", DECHEX } },
-      { NETWORK_NAME_S, { "Network name" } },
-      { NEW_SERV_ID_S, { "New service id", DECHEX } },
-      { NEXT_TIME_OFFSET_S, { "Next time offset", DECHEX } },
-      { OPERATOR_CODE_S, { "Operator code" } },
-      { OPERATOR_CODE_LEN_S, { "Operator code len" } },
-      { ORB_POS_S, { "Orbital position" } },
-      { ORIGIN_TYPE_S, { "Origin type" } },
-      { ORIG_NETWORK_ID_S, { "Orig. network id", DECHEX } },
-      { OTHER_FREQ_FLAG_S, { "Other freq flag" } },
-      { OUI_S, { "OUI" } },
-      { OUI_DATA_LEN_S, { "OUI data len", DECHEX } },
-      { PAGE_NUM_S, { "Page number" } },
-      { PCR_PID_S, { "PCR Pid", DECHEX } },
-      { PEAK_RATE_S, { "Peak rate" } },
-      { PEL_ASPECT_R_S, { "Pel aspect ratio" } },
-      { PID_S, { "Pid", DECHEX } },
-      { POL_S, { "Polarisation" } },
-      { PRIORITY_S, { "Priority" } },
-      { PROF_LVL_IND_S, { "Prof/level ind." } },
-      { PROG_IDENT_LABEL_S, { "Programme idnt. lbl" } },
-      { PROGRAM_INFO_LEN_S, { "Program info len", DECHEX } },
-      { PROGRAM_NUM_S, { "Program number", DECHEX } },
-      { PROV_NAME_S, { "Provider name" } },
-      { PROV_NAME_LEN_S, { "Provider name len", DECHEX } },
-      { PVT_DATA_S, { "Private data" } },
-      { PVT_DATA_IND_S, { "Private data ind", DECHEX } },
-      { RATING_S, { "Rating" } },
-      { REF_EVENT_ID_S, { "Ref. event id" } },
-      { REF_SID_S, { "Ref. service id" } },
-      { REF_TYPE_S, { "Ref. type" } },
-      { RESERVED_S, { "reserved", HEX } },
-      { RESERVED_FU_S, { "rsvrd. future use", HEX } },
-      { ROLLOFF_S, { "Rolloff" } },
-      { RUNNING_STATUS_S, { "Running status" } },
-      { SB_LEAK_RATE_S, { "SB leak rate", DECHEX } },
-      { SB_SIZE_S, { "SB size" } },
-      { SECT_SYNTAX_IND_S, { "Section syn. ind." } },
-      { SELECTOR_S, { "Selector" } },
-      { SELECTOR_LEN_S, { "Selector len", DECHEX } },
-      { SERVICE_ID_S, { "Service id", DECHEX } },
-      { SERVICE_NAME_S, { "Service name" } },
-      { SERVICE_NAME_LEN_S, { "Service name len", DECHEX } },
-      { SRC_ID_S, { "Source id" } },
-      { SRC_NAME_S, { "Source name" } },
-      { SRC_NAME_LEN_S, { "Source name len", DECHEX } },
-      { START_TIME_S, { "Start time" } },
-      { STILL_PICT_FLAG_S, { "Still pic flag" } },
-      { STREAM_CONTENT_S, { "Stream content" } },
-      { STREAM_TYPE_S, { "Stream type" } },
-      { SUBCELL_INFO_LOOP_LEN_S, { "Subcell loop len", DECHEX } },
-      { SUBCELL_LAT_S, { "Subcell lat." } },
-      { SUBCELL_LON_S, { "Subcell lon." } },
-      { SUBCELL_EXT_LAT_S, { "Subcell ext. of lat." } },
-      { SUBCELL_EXT_LON_S, { "Subcell ext. of lon." } },
-      { SUBSTREAM_1_S, { "Substream 1" } },
-      { SUBSTREAM_1_FLAG_S, { "Substream 1 flag" } },
-      { SUBSTREAM_2_S, { "Substream 2" } },
-      { SUBSTREAM_2_FLAG_S, { "Substream 2 flag" } },
-      { SUBSTREAM_3_S, { "Substream 3" } },
-      { SUBSTREAM_3_FLAG_S, { "Substream 3 flag" } },
-      { SYM_RATE_S, { "Symbol rate" } },
-      { TAG_S, { "Tag", HEX } },
-      { TID_S, { "Table id" } },
-      { TABLE_LEN_S, { "Table length", DECHEX } },
-      { TABLE_TYPE_S, { "Table type" } },
-      { TEXT_S, { "Text" } },
-      { TEXT_LEN_S, { "Text len", DECHEX } },
-      { TIME_SLICE_IND_S, { "Time slicing ind." } },
-      { TRANS_MODE_S, { "Transmission mode" } },
-      { TYPE_S, { "Type" } },
-      { UPDATE_TYPE_S, { "Update type" } },
-      { UPDATE_VER_FLAG_S, { "Update vers. flg" } },
-      { UPDATE_VER_S, { "Update version" } },
-      { USER_NL_1, { "User nibble 1", HEX } },
-      { USER_NL_2, { "User nibble 2", HEX } },
-      { UTC_S, { "UTC" } },
-      { VAR_RATE_AUD_IND_S, { "Variable rate audio ind." } },
-      { VER_NUM_S, { "Version number" } },
-      { VERT_OFFSET_S, { "Vertical offset" } },
-      { VERT_SIZE_S, { "Vertical size" } },
-      { WEST_EAST_S, { "West/east flag" } },
-      { WIN_PRIORITY_S, { "Window priority" } },
-      { XPORT_DESC_LEN_S, { "Xport desc len", DECHEX } },
-      { XPORT_STREAM_ID_S, { "Xport stream id", DECHEX } },
-      { XS_LOOP_LEN_S, { "Xprt str loop len", DECHEX } },
-      { XPOSER_FREQ_S, { "Xposer frequency", DECHEX } },
-
-      // table strings
-      { BAT_DUMP_S, { "- BAT Dump -", TABLE } },
-      { CAT_DUMP_S, { "- CAT Dump -", TABLE } },
-      { EIT_PF_ACTUAL_S, { "- EIT PF Dump (Actual) -", TABLE } },
-      { EIT_PF_OTHER_S, { "- EIT PF Dump (Other) -", TABLE } },
-      { EIT_ES_ACTUAL_S, { "- EIT ES (Actual) -", TABLE } },
-      { EIT_ES_OTHER_S, { "- EIT ES (Other) -", TABLE } },
-      { NIT_DUMP_ACTUAL_S, { "- NIT Dump (Actual) -", TABLE } },
-      { NIT_DUMP_OTHER_S, { "- NIT Dump (Other) -", TABLE } },
-      { PAT_DUMP_S, { "- PAT Dump -", TABLE } },
-      { PMT_DUMP_S, { "- PMT Dump -", TABLE } },
-      { RST_DUMP_S, { "- RST Dump -", TABLE } },
-      { SDT_DUMP_ACTUAL_S, { "- SDT Dump (Actual) -", TABLE } },
-      { SDT_DUMP_OTHER_S, { "- SDT Dump (Other) -", TABLE } },
-      { ST_DUMP_S, { "- ST Dump -", TABLE } },
-      { TDT_DUMP_S, { "- TDT Dump -", TABLE } },
-      { TOT_DUMP_S, { "- TOT Dump -", TABLE } },
-
-      { F_EVENT_LIST_S, { "-* Following Event List *-", FIELDS } },
-      { P_EVENT_LIST_S, { "-* Present Event List *-", FIELDS } },
-      { SERVICE_LIST_S, { "-* Service List *-", FIELDS } },
-      { STREAM_LIST_S, { "-* Stream List *-", FIELDS } },
-      { XPORT_STREAM_S, { "*-- Transport Stream --*" , FIELDS} },
-
-      // descriptor name strings
-      { AC3_D_S, { "AC-3", DESC } },
-      { ADAPTATION_FIELD_DATA_S, { "Adaptation Field Data", DESC } },
-      { ANCILLARY_DATA_D_S, { "Ancillary Data", DESC } },
-      { ANNOUNCEMENT_SUPPORT_D_S, { "Announcement Support", DESC } },
-      { AUDIO_STREAM_D_S, { "Audio Stream", DESC } },
-      { BOUQUET_NAME_D_S, { "Bouquet name", DESC } },
-      { CA_D_S, { "CA", DESC } },
-      { CA_IDENT_D_S, { "CA Identifier", DESC } },
-      { CABLE_DEL_SYS_D_S, { "Cable Delivery System", DESC } },
-      { CELL_FREQ_LINK_D_S, { "Cell Frequency Link", DESC } },
-      { CELL_LIST_D_S, { "Cell List", DESC } },
-      { COMPONENT_D_S, { "Component", DESC } },
-      { CONTENT_D_S, { "Content", DESC } },
-      { COPYRIGHT_D_S, { "Copyright", DESC } },
-      { COUNTRY_AVAIL_D_S, { "Country Availability", DESC } },
-      { DATA_BCAST_D_S, { "Data Broadcast", DESC } },
-      { DATA_BCAST_ID_D_S, { "Data Broadcast Id", DESC } },
-      { DATA_STREAM_ALIGNMENT_D_S, { "Data Stream Alignment", DESC } },
-      { DSNG_D_S, { "DSNG", DESC } },
-      { EXTENDED_AC3_D_S, { "Extended AC-3", DESC } },
-      { EXTENDED_EVENT_D_S, { "Extended Event", DESC } },
-      { FREQ_LIST_D_S, { "Frequency List", DESC } },
-      { HIERARCHY_D_S, { "Hierarchy", DESC } },
-      { IBP_D_S, { "IBP", DESC } },
-      { ISO_639_LANG_D_S, { "ISO 639 Language", DESC } },
-      { LINKAGE_D_S, { "Linkage", DESC } },
-      { LOCAL_TIME_OFFSET_D_S, { "Local Time Offset", DESC } },
-      { MAXIMUM_BITRATE_D_S, { "Maximum Bitrate", DESC } },
-      { MULTILING_BOUQUET_NAME_D_S, { "Multilingual Bouquet Name", DESC } },
-      { MULTILING_COMPONENT_D_S, { "Multilingual Component", DESC } },
-      { MULTILING_NET_NAME_D_S, { "Multilingual Network Name", DESC } },
-      { MULTILING_SERV_NAME_D_S, { "Multilingual Service Name", DESC } },
-      { MULTIPLEX_BUF_UTIL_D_S, { "Multiplex Buff Utilization", DESC } },
-      { NETWORK_NAME_D_S, { "Network Name", DESC } },
-      { NVOD_REF_D_S, { "NVOD Reference", DESC } },
-      { PARENTAL_RATING_D_S, { "Parental Rating", DESC } },
-      { PARTIAL_TS_D_S, { "Partial Transport Stream", DESC } },
-      { PDC_D_S, { "PDC", DESC } },
-      { PVT_DATA_IND_D_S, { "Private Data Indicator", DESC } },
-      { PVT_DATA_SPEC_D_S, { "Private Data Specifier", DESC } },
-      { REGISTRATION_D_S, { "Registration", DESC } },
-      { SAT_DEL_SYS_D_S, { "Satellite Delivery System", DESC } },
-      { SERV_D_S, { "Service", DESC } },
-      { SERV_LIST_D_S, { "Service List", DESC } },
-      { SERV_MOVE_D_S, { "Service Move", DESC } },
-      { SHORT_EVENT_D_S, { "Short Event", DESC } },
-      { SHORT_SMTHNG_BUF_D_S, { "Short Smoothing Buffer", DESC } },
-      { SMOOTHING_BUF_D_S, { "Smoothing Buffer", DESC } },
-      { STD_D_S, { "STD", DESC } },
-      { STREAM_IDENT_D_S, { "Stream Identifier", DESC } },
-      { STUFFING_D_S, { "Stuffing", DESC } },
-      { SUBTITLING_D_S, { "Subtitling", DESC } },
-      { SYSTEM_CLOCK_D_S, { "System Clock", DESC } },
-      { TARGET_BACKGROUND_GRID_D_S, { "Target Background Grid", DESC } },
-      { TELEPHONE_D_S, { "Telephone", DESC } },
-      { TELETEXT_D_S, { "Teletext", DESC } },
-      { TER_DEL_SYS_D_S, { "Terrestrial Delivery System", DESC } },
-      { TIME_SHIFTED_SERV_D_S, { "Time Shifted Service", DESC } },
-      { TIME_SHIFTED_EVENT_D_S, { "Time Shifted Event", DESC } },
-      { VIDEO_STREAM_D_S, { "Video Stream", DESC } },
-      { VIDEO_WINDOW_D_S, { "Video Window", DESC } },
-      { XPORT_STREAM_D_S, { "Transport Stream", DESC } },
-   };
+      //
+      // buffered output to a file descriptor. Text from ostream inserts
+      // is only kept if keep_text is set, records are added with put()
+      class FdBuf : public std::streambuf
+      {
+      public:
+         FdBuf(int fd, bool keep_text) : fd(fd), keep_text(keep_text), ok(true), len(0) {}
+         ~FdBuf() { flush(); }
+
+         void put(const char* s, size_t n) {
+            while (n) {
+               size_t c = std::min(n, sizeof(buf) - len);
+               memcpy(buf + len, s, c);
+               len += c;
+               s += c;
+               n -= c;
+               if (len == sizeof(buf))
+                  flush();
+            }
+         }
+
+      protected:
+         int_type overflow(int_type c) {
+            if (keep_text && !traits_type::eq_int_type(c, traits_type::eof())) {
+               char ch = traits_type::to_char_type(c);
+               put(&ch, 1);
+            }
+            return traits_type::not_eof(c);
+         }
+         std::streamsize xsputn(const char* s, std::streamsize n) {
+            if (keep_text)
+               put(s, n);
+            return n;
+         }
+         int sync() {
+            flush();
+            return ok ? 0 : -1;
+         }
+
+      private:
+         int fd;
+         bool keep_text, ok;
+         char buf[65536];
+         size_t len;
+
+         void flush() {
+            const char* p = buf;
+            while (len && ok) {
+               ssize_t w = ::write(fd, p, len);
+               if (w < 0) {
+                  if (errno != EINTR)
+                     ok = false;
+                  continue;
+               }
+               p += w;
+               len -= w;
+            }
+            len = 0;
+         }
+      };
+
+      //
+      // formats an output line into a fixed buffer, handing it to the
+      // stream in one write (or a few, for very long lines)
+      class Line
+      {
+      public:
+         explicit Line(std::ostream& os) : o(&os), fb(nullptr), len(0) {}
+         explicit Line(FdBuf& b) : o(nullptr), fb(&b), len(0) {}
+         ~Line() { flush(); }
+
+         Line(const Line&) = delete;
+         Line& operator=(const Line&) = delete;
+
+         Line& put(char c) {
+            if (len == sizeof(buf))
+               flush();
+            buf[len++] = c;
+            return *this;
+         }
+         Line& put(const char* s, size_t n) {
+            while (n--)
+               put(*s++);
+            return *this;
+         }
+         Line& put(const char* s) { return put(s, strlen(s)); }
+         Line& put(const std::string& s) { return put(s.data(), s.length()); }
+         Line& fill(char c, int n) {
+            while (n-- > 0)
+               put(c);
+            return *this;
+         }
+
+         // decimal, zero padded to width
+         Line& dec(ui32 v, uint_fast8_t width = 0) { return num(v, 10, width); }
+         // hex, zero padded to width
+         Line& hex(ui32 v, uint_fast8_t width = 0) { return num(v, 16, width); }
+         // hex with a 0x prefix (none for 0)
+         Line& hexBase(ui32 v) {
+            if (v)
+               put("0x", 2);
+            return hex(v);
+         }
+
+         Line& indent() { return fill(' ', o->iword(levelIndex())); }
+         Line& label(const Label& l) {
+            indent();
+            size_t n = strlen(l.str);
+            put(l.str, n);
+            fill(' ', T_STR_W - static_cast<int>(n));
+            return put(": ", 2);
+         }
+         Line& end() { return put('\n'); }
+
+      private:
+         std::ostream* o;
+         FdBuf* fb;
+         char buf[256];
+         size_t len;
+
+         void flush() {
+            if (fb)
+               fb->put(buf, len);
+            else
+               o->write(buf, len);
+            len = 0;
+         }
+
+         Line& num(ui32 v, ui32 base, uint_fast8_t width) {
+            char digits[10];
+            uint_fast8_t n = 0;
+            do {
+               digits[n++] = "0123456789abcdef"[v % base];
+               v /= base;
+            } while (v);
+            fill('0', width - n);
+            while (n)
+               put(digits[--n]);
+            return *this;
+         }
+      };
+
+      //
+      // hh:mm:ss of a bcd time
+      Line& hms(Line& line, const BCDTime& t)
+      {
+         return line.hex(t.getBCDHour(), 2).put(':')
+            .hex(t.getBCDMinute(), 2).put(':')
+            .hex(t.getBCDSecond(), 2);
+      }
 
-   //
-   // dumps a single data line
-   //
-   static void dumpDataLine(std::ostream& o, const ui8* data, ui8 length)
-   {
-      uint_fast8_t i;
+      //
+      // structured record writers used by DumpStream
+      class Writer
+      {
+      public:
+         explicit Writer(FdBuf& b) : fb(b) {}
+         virtual ~Writer() {}
+
+         virtual void header(long level, const Label& l) = 0;
+         virtual void number(long level, const Label& l, ui32 v) = 0;
+         virtual void string(long level, const Label& l, const std::string& s) = 0;
+         virtual void bytes(long level, const Label& l, const ui8* d, size_t n) = 0;
+         virtual void time(long level, const Label& l, const UTC& t) = 0;
+         virtual void time(long level, const Label& l, const BCDTime& t) = 0;
+
+      protected:
+         FdBuf& fb;
+
+         // 0 table, 1 list, 2 descriptor
+         static ui8 kind(const Label& l) {
+            return (l.format == TABLE) ? 0 : ((l.format == DESC) ? 2 : 1);
+         }
+      };
+
+      class JsonWriter : public Writer
+      {
+      public:
+         explicit JsonWriter(FdBuf& b) : Writer(b), first(true) { fb.put("[", 1); }
+         ~JsonWriter() { fb.put("\n]\n", 3); }
+
+         void header(long level, const Label& l) {
+            static const char* const KINDS[] = { "table", "list", "descriptor" };
+            Line line(fb);
+            begin(line, level, l).put(",\"header\":\"").put(KINDS[kind(l)]).put("\"}");
+         }
+         void number(long level, const Label& l, ui32 v) {
+            Line line(fb);
+            begin(line, level, l).put(",\"value\":").dec(v).put('}');
+         }
+         void string(long level, const Label& l, const std::string& s) {
+            Line line(fb);
+            quoted(begin(line, level, l).put(",\"value\":"), s.data(), s.length()).put('}');
+         }
+         void bytes(long level, const Label& l, const ui8* d, size_t n) {
+            Line line(fb);
+            begin(line, level, l).put(",\"value\":\"");
+            while (n--)
+               line.hex(*d++, 2);
+            line.put("\"}");
+         }
+         void time(long level, const Label& l, const UTC& t) {
+            ui16 M, D, Y;
+            t.getMDY(M, D, Y);
+
+            Line line(fb);
+            begin(line, level, l).put(",\"value\":{\"mjd\":").dec(t.mjd)
+               .put(",\"date\":\"").dec(Y, 4).put('-').dec(M, 2).put('-').dec(D, 2)
+               .put("\",\"time\":\"");
+            hms(line, t.time).put("\"}}");
+         }
+         void time(long level, const Label& l, const BCDTime& t) {
+            Line line(fb);
+            hms(begin(line, level, l).put(",\"value\":\""), t).put("\"}");
+         }
+
+      private:
+         bool first;
+
+         Line& begin(Line& line, long level, const Label& l) {
+            line.put(first ? "\n{" : ",\n{");
+            first = false;
+            line.put("\"level\":").dec(level).put(",\"id\":").dec(l.id).put(",\"label\":");
+            return quoted(line, l.str, strlen(l.str));
+         }
+
+         // bytes outside printable ascii are escaped as code points
+         // (i.e., read as latin-1)
+         static Line& quoted(Line& line, const char* s, size_t n) {
+            line.put('"');
+            while (n--) {
+               ui8 c = *s++;
+               if (c == '"' || c == '\\')
+                  line.put('\\').put(c);
+               else if (c < 0x20 || c >= 0x7f)
+                  line.put("\\u00", 4).hex(c, 2);
+               else
+                  line.put(c);
+            }
+            return line.put('"');
+         }
+      };
+
+      class TlvWriter : public Writer
+      {
+      public:
+         enum Type { HEADER = 1, NUMBER, STRING, BYTES, UTC_TIME, BCD_TIME };
+         enum { FORMAT_VERSION = 1 };
+
+         explicit TlvWriter(FdBuf& b) : Writer(b) {
+            const char magic[] = { 'S', 'G', 'T', 'L', FORMAT_VERSION };
+            fb.put(magic, sizeof(magic));
+         }
+
+         void header(long level, const Label& l) {
+            ui8 k = kind(l);
+            record(HEADER, level, l, &k, 1);
+         }
+         void number(long level, const Label& l, ui32 v) {
+            const ui8 b[] = { static_cast<ui8>(v >> 24), static_cast<ui8>(v >> 16),
+                              static_cast<ui8>(v >> 8), static_cast<ui8>(v) };
+            record(NUMBER, level, l, b, sizeof(b));
+         }
+         void string(long level, const Label& l, const std::string& s) {
+            record(STRING, level, l, s.data(), s.length());
+         }
+         void bytes(long level, const Label& l, const ui8* d, size_t n) {
+            record(BYTES, level, l, d, n);
+         }
+         void time(long level, const Label& l, const UTC& t) {
+            ui8 b[UTC::BYTE_LEN];
+            t.getBytes(b);
+            record(UTC_TIME, level, l, b, sizeof(b));
+         }
+         void time(long level, const Label& l, const BCDTime& t) {
+            ui8 b[BCDTime::TIME_LEN];
+            t.getBCD(b);
+            record(BCD_TIME, level, l, b, sizeof(b));
+         }
+
+      private:
+         void record(Type t, long level, const Label& l, const void* d, size_t n) {
+            n = std::min<size_t>(n, 0xffff);
+            const ui8 h[] = { static_cast<ui8>(t), static_cast<ui8>(level),
+                              static_cast<ui8>(l.id >> 8), static_cast<ui8>(l.id),
+                              static_cast<ui8>(n >> 8), static_cast<ui8>(n) };
+            fb.put(reinterpret_cast<const char*>(h), sizeof(h));
+            fb.put(static_cast<const char*>(d), n);
+         }
+      };
+
+      // the structured writer the stream dumps to, null for text
+      Writer* writer(std::ostream& o)
+      {
+         return static_cast<Writer*>(o.pword(writerIndex()));
+      }
+
+      long level(std::ostream& o) { return o.iword(levelIndex()); }
+
+      //
+      // appends the value in the label's format
+      void value(Line& line, DumpFormat format, ui32 data)
+      {
+         if (format == AUTO) {
+            if (data < 10)
+               line.dec(data);
+            else if (data < 256)
+               line.hexBase(data);
+            else
+               line.dec(data).put(" (", 2).hexBase(data).put(')');
+         } else if (format == DEC)
+            line.dec(data);
+         else if (format == DECHEX)
+            line.dec(data).put(" (", 2).hexBase(data).put(')');
+         else
+            line.hexBase(data);
+      }
 
-      o << std::hex;
+      //
+      // dumps a single data line
+      //
+      void dumpDataLine(Line& line, const ui8* data, ui8 length)
+      {
+         uint_fast8_t i;
 
-      // display the data in byte mode
-      for (i = 0; i < length; i++)
-         o << std::setw(2) << static_cast<ui16>(data[i]) << " ";
+         // display the data in byte mode
+         for (i = 0; i < length; i++)
+            line.hex(data[i], 2).put(' ');
 
-      // fill any empty spaces (if length < LINE_WIDTH)
-      for (; i < LINE_WIDTH; i++)
-         o <<  "   ";
+         // fill any empty spaces (if length < LINE_WIDTH)
+         line.fill(' ', 3 * (LINE_WIDTH - i));
 
-      // display the data in char mode
-      o << "  ";
+         // display the data in char mode
+         line.put("  ", 2);
 
-      for (i = 0; i < length; i++) {
-         char c = data[i];
+         for (i = 0; i < length; i++) {
+            char c = data[i];
 
-         // map unprintables to '.'
-         if ((c < ' ') || (c > '~'))
-            c = '.';
+            // map unprintables to '.'
+            if ((c < ' ') || (c > '~'))
+               c = '.';
 
-         o << std::setw(1) << c;
+            line.put(c);
+         }
+         line.end();
       }
-      o << std::endl;
    }
 
-   //
-   // outputs spaces before a line based on the current indent level
-   static void indent(std::ostream& o)
-   {
-      for (uint_fast8_t i = 0; i < level; i++)
-         o << " ";
-      o.setf(std::ios::left | std::ios::showbase);
-      o << std::setfill(' ');
-   }
+   using namespace dump_priv;
 
    //
    // dumps data in binary / char mode
    //
    void dumpData(std::ostream& o, const ui8* data, ui16 length)
    {
-      // set stdout to not show base and pad right with 0's
-      std::ios::fmtflags f = o.flags();
+      if (Writer* w = writer(o)) {
+         w->bytes(level(o), out_str[DATA_S], data, length);
+         return;
+      }
 
-      o.unsetf(std::ios::showbase);
-      o.setf(std::ios::right);
-      o << std::setfill('0');
+      Line line(o);
 
       uint_fast16_t num_lines = (length / LINE_WIDTH) + 1;
       for (uint_fast16_t i = 0, rem = length; i < num_lines; i++, rem -= LINE_WIDTH) {
          // calculate the length of the line
          int len = (rem < LINE_WIDTH) ? rem : LINE_WIDTH;
 
-         o << "[" << std::dec
-           << std::setw(4)
-           << (i * LINE_WIDTH) << "] ";
+         line.put('[').dec(i * LINE_WIDTH, 4).put("] ", 2);
 
          // display it
-         dumpDataLine(o,& data[i * LINE_WIDTH], len);
+         dumpDataLine(line, &data[i * LINE_WIDTH], len);
       }
-      o << std::endl;
-
-      o.flags( f );
+      line.end();
    }
 
    //
@@ -428,118 +769,153 @@ namespace sigen
    //
    void dumpBytes(std::ostream& o, const std::vector<ui8>& v)
    {
-      std::stringstream sout;
-
-      sout << std::setfill('0');
-      for (ui16 byte : v) {
-         sout << std::setw(2) << std::hex << byte;
+      if (Writer* w = writer(o)) {
+         w->bytes(level(o), out_str[DATA_S], v.data(), v.size());
+         return;
       }
-      sout << std::endl;
 
-      o << sout.str();
+      Line line(o);
+
+      for (ui8 byte : v)
+         line.hex(byte, 2);
+      line.end();
    }
 
    //
    // increase / decrease the indentation level
-   void incOutLevel() { level++; }
-   void decOutLevel() { level--; }
+   void incOutLevel(std::ostream& o) { o.iword(levelIndex())++; }
+   void decOutLevel(std::ostream& o)
+   {
+      long& level = o.iword(levelIndex());
+      if (level > 0)
+         level--;
+   }
 
    //
    // functions for displaying a header string
    void headerStr(std::ostream& o, STRID s)
    {
-      const Label& l = out_str.at(s);
-      indent(o);
-      o << "- "
-        << l.str;
+      const Label& l = out_str[s];
+      if (Writer* w = writer(o)) {
+         w->header(level(o), l);
+         return;
+      }
+
+      Line line(o);
+      line.indent().put("- ", 2).put(l.str);
       if (l.format == DESC)
-         o << " Descriptor";
-      o << " -" << std::endl;
+         line.put(" Descriptor");
+      line.put(" -").end();
    }
 
    //
    // functions for displaying identifier strings
-   static inline void identStr(std::ostream& o, const Label& l)
+   void identStr(std::ostream& o, STRID s, ui32 data)
    {
-      indent(o);
-      o << std::setw(T_STR_W) << l.str << ": ";
-   }
+      const Label& l = out_str[s];
+      if (Writer* w = writer(o)) {
+         w->number(level(o), l, data);
+         return;
+      }
 
-   static inline void identStr(std::ostream& o, const Label& l, const std::string& data,
-                               bool cr, bool quotes)
-   {
-      identStr(o, l);
-
-      if (quotes)
-         o << "\"";
-      o << data;
-      if (quotes)
-         o << "\"";
-      if (cr)
-         o << std::endl;
+      Line line(o);
+      line.label(l);
+      value(line, l.format, data);
+      line.end();
    }
 
-   static inline void identStr(std::ostream& o, const Label& l, ui32 data)
+   void identStr(std::ostream& o, STRID s, const std::string& data, bool cr)
    {
-      identStr(o, l);
-      if (l.format == AUTO) {
-         if (data < 10)
-            o << std::dec << data;
-         else if (data < 256)
-            o << std::hex << data;
-         else
-            o << std::dec << data << " (" << std::hex << data << ")";
-      } else if (l.format == DEC)
-         o << std::dec << data;
-      else if (l.format == DECHEX)
-         o << std::dec << data << " (" << std::hex << data << ")";
-      else
-         o << std::hex << data;
-
-      o << std::endl;
-   }
+      if (!data.length())
+         return;
 
-   void identStr(std::ostream& o, STRID s, ui32 data)
-   {
-      identStr(o, out_str.at(s), data);
-   }
+      if (Writer* w = writer(o))
+         w->string(level(o), out_str[s], data);
+      else {
+         Line line(o);
 
-   void identStr(std::ostream& o, STRID s, const std::string& data, bool cr)
-   {
-      if (data.length())
-         identStr(o, out_str.at(s), data, cr, true);
+         line.label(out_str[s]).put('"').put(data).put('"');
+         if (cr)
+            line.end();
+      }
    }
 
    void identStr(std::ostream& o, STRID s, const LanguageCode& lc)
    {
-      identStr(o, out_str.at(s), lc.str(), true, true);
+      if (Writer* w = writer(o)) {
+         w->string(level(o), out_str[s], lc.str());
+         return;
+      }
+
+      Line line(o);
+      line.label(out_str[s]).put('"').put(lc.str()).put('"').end();
    }
 
    void identStr(std::ostream& o, STRID s, const UTC& time)
    {
-      identStr(o, out_str.at(s));
-      o << time << std::endl;
+      if (Writer* w = writer(o)) {
+         w->time(level(o), out_str[s], time);
+         return;
+      }
+
+      ui16 M, D, Y;
+      time.getMDY(M, D, Y);
+
+      Line line(o);
+      line.label(out_str[s]).hexBase(time.mjd)
+         .put(" (", 2).dec(M).put('/').dec(D).put('/').dec(Y).put("), ", 3);
+      hms(line, time.time).end();
    }
 
    void identStr(std::ostream& o, STRID s, const BCDTime& dur)
    {
-      identStr(o, out_str.at(s));
-      o << dur << std::endl;
+      if (Writer* w = writer(o)) {
+         w->time(level(o), out_str[s], dur);
+         return;
+      }
+
+      Line line(o);
+      hms(line.label(out_str[s]), dur).end();
    }
 
    void identStr(std::ostream& o, STRID s, const std::vector<ui8>& data)
    {
-      if (!data.empty()) {
-         std::stringstream data_str;
+      if (data.empty())
+         return;
+
+      if (Writer* w = writer(o))
+         w->bytes(level(o), out_str[s], data.data(), data.size());
+      else {
+         Line line(o);
+
+         line.label(out_str[s]);
+         for (ui8 byte : data)
+            line.hex(byte, 2);
+         line.end();
+      }
+   }
 
-         data_str.unsetf(std::ios::showbase);
-         data_str.setf(std::ios::right);
+   // --------------------------------
+   // dump stream
+   //
+   DumpStream::DumpStream(int fd, Format format) :
+      std::ostream(nullptr),
+      buf(new FdBuf(fd, format == TEXT))
+   {
+      rdbuf(buf.get());
 
-         data_str << std::setfill('0');
-         for (ui16 byte : data)
-            data_str << std::setw(2) << std::hex << byte;
+      if (format == JSON)
+         wr.reset(new JsonWriter(*buf));
+      else if (format == TLV)
+         wr.reset(new TlvWriter(*buf));
+      pword(writerIndex()) = wr.get();
+   }
 
-         identStr(o, out_str.at(s), data_str.str(), true, false);
-      }
+   DumpStream::~DumpStream()
+   {
+      // close off the records before the buffer is flushed
+      pword(writerIndex()) = nullptr;
+      wr.reset();
+      rdbuf(nullptr);
    }
 }
@@ -28,6 +28,7 @@
 #ifdef ENABLE_DUMP
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include "types.h"
@@ -323,6 +324,7 @@ namespace sigen {
       PDC_D_S,            // - PDC Descriptor -
       PVT_DATA_IND_D_S,   // - Private Data Indicator Descriptor -
       PVT_DATA_SPEC_D_S,  // - Private Data Specifier Descriptor -
+      RAW_D_S,            // - Raw Descriptor -
       REGISTRATION_D_S,   // - Registration Descriptor -
       SAT_DEL_SYS_D_S,    // - Satellite Delivery System Descriptor -
       SERV_D_S,           // - Service Descriptor -
@@ -348,8 +350,8 @@ namespace sigen {
    };
 
    // output utility functions
-   void incOutLevel();
-   void decOutLevel();
+   void incOutLevel(std::ostream& o);
+   void decOutLevel(std::ostream& o);
    void headerStr(std::ostream& o, STRID s);
 
    void identStr(std::ostream& o, STRID s, ui32 val);
@@ -361,6 +363,54 @@ namespace sigen {
 
    void dumpData(std::ostream& o, const ui8* data, ui16 len);
    void dumpBytes(std::ostream& o, const std::vector<ui8>& data);
+
+   namespace dump_priv {
+      class FdBuf;
+      class Writer;
+   }
+
+   /*!
+    * \brief Output stream writing dumps straight to a file descriptor.
+    *
+    * TEXT is the usual column format. JSON (an array of objects) and
+    * TLV (binary) write one record per dumped header / field, keyed by
+    * its STRID and indentation level. Output goes through a fixed
+    * buffer, so arbitrarily large dumps are never held in memory. Other
+    * text written to the stream (e.g., blank lines) is only kept in
+    * TEXT.
+    *
+    * JSON records: `{"level":1,"id":<STRID>,"label":"Length","value":26}`,
+    * where value is a number, string, hex string (byte data), "hh:mm:ss"
+    * or `{"mjd":..,"date":"YYYY-MM-DD","time":"hh:mm:ss"}`. Headers have
+    * `"header":"table" | "list" | "descriptor"` instead of a value.
+    *
+    * TLV: "SGTL" + version byte, then records of type (1), level (1),
+    * STRID (2), length (2) and the value - types 1: header (1 byte
+    * kind: 0 table, 1 list, 2 descriptor), 2: 32-bit number, 3: string,
+    * 4: bytes, 5: UTC (5 bytes, as in tables), 6: BCD time (3 bytes).
+    * Multi-byte fields are big endian.
+    */
+   class DumpStream : public std::ostream
+   {
+   public:
+      enum Format { TEXT, JSON, TLV };
+
+      /*!
+       * \brief Constructor.
+       * \param fd File descriptor to write to (not closed by the stream).
+       * \param format Output format.
+       */
+      DumpStream(int fd, Format format = TEXT);
+      ~DumpStream();
+
+      // prohibit
+      DumpStream(const DumpStream&) = delete;
+      DumpStream& operator=(const DumpStream&) = delete;
+
+   private:
+      std::unique_ptr<dump_priv::FdBuf> buf;
+      std::unique_ptr<dump_priv::Writer> wr;
+   };
 } // sigen namespace
 
   // enable dumps to cerr
@@ -62,10 +62,10 @@ namespace sigen
    {
       dumpHeader( o, CA_IDENT_D_S );
 
-      incOutLevel();
+      incOutLevel(o);
       for (ui16 id : id_list)
          identStr(o, CA_SYSTEM_ID_S, id);
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -94,7 +94,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set08Bits( country_availability_flag << 7 | rbits(0x7f) );
+      Layout::write( s, country_availability_flag );
 
       for (const auto& lc : country_list)
          s.setBits( lc );
@@ -110,10 +110,10 @@ namespace sigen
       identStr(o, COUNTRY_AVAIL_FLAG_S, country_availability_flag);
       identStr(o, RESERVED_FU_S, 0x7f);
 
-      incOutLevel();
+      incOutLevel(o);
       for (const auto& lc : country_list)
          identStr(o, COUNTRY_CODE_S, lc);
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -126,10 +126,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set16Bits( data_broadcast_id );
-      s.set08Bits( component_tag );
-
-      s.set08Bits( selector_byte.length() );
+      Layout::write( s, data_broadcast_id, component_tag, selector_byte.length() );
       s.setBits( selector_byte );
 
       s.setBits( code );
@@ -193,15 +190,10 @@ namespace sigen
       for (const auto &offset : time_offset_list) {
          // now set the data
          s.setBits( offset.country_code );
-         s.set08Bits( (offset.country_region_id << 2) |
-                      (rbits(0x01) << 1) |
-                      (offset.local_time_offset_polarity) );
-         s.set16Bits( offset.local_time_offset );
+         OffsetLayout::write( s, offset.country_region_id, offset.local_time_offset_polarity,
+                              offset.local_time_offset );
 
-         s.set16Bits( offset.time_of_change.mjd );
-         s.set08Bits( offset.time_of_change.time.getBCDHour() );
-         s.set08Bits( offset.time_of_change.time.getBCDMinute() );
-         s.set08Bits( offset.time_of_change.time.getBCDSecond() );
+         s.setBits( offset.time_of_change );
 
          s.set16Bits( offset.next_time_offset );
       }
@@ -217,7 +209,7 @@ namespace sigen
       dumpHeader(o, LOCAL_TIME_OFFSET_D_S);
 
       // write the offset loop
-      incOutLevel();
+      incOutLevel(o);
       for (const auto &offset : time_offset_list) {
          o << std::endl;
 
@@ -231,7 +223,7 @@ namespace sigen
          o << std::hex;
          identStr(o, NEXT_TIME_OFFSET_S, offset.next_time_offset);
       }
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -264,12 +256,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set24Bits( rbits(0xc00000) |
-                   peak_rate );
-      s.set24Bits( rbits(0xc00000) |
-                   min_overall_smoothing_rate );
-      s.set16Bits( rbits(0xc000) |
-                   max_overall_smoothing_buffer );
+      Layout::write( s, peak_rate, min_overall_smoothing_rate, max_overall_smoothing_buffer );
    }
 
 #ifdef ENABLE_DUMP
@@ -311,10 +298,8 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      for (const auto &service : service_list) {
-         s.set16Bits( service.id );
-         s.set08Bits( service.type );
-      }
+      for (const auto &service : service_list)
+         ServiceLayout::write( s, service.id, service.type );
    }
 
 
@@ -324,13 +309,13 @@ namespace sigen
       dumpHeader( o, SERV_LIST_D_S );
 
       // dump the descriptor's data
-      incOutLevel();
+      incOutLevel(o);
 
       for (const auto &service : service_list) {
          identStr(o, SERVICE_ID_S, service.id);
          identStr(o, TYPE_S, service.type);
       }
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -378,16 +363,10 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set08Bits( rbits(0xc0) |
-                   (foreign_availability << 5) |
-                   connection_type );
-      s.set08Bits( rbits(0x80) |
-                   (country_prefix.length() << 5) |
-                   (international_area_code.length() << 2) |
-                   operator_code.length());
-      s.set08Bits( rbits(0x80) |
-                   (national_area_code.length() << 4) |
-                   core_number.length());
+      Layout::write( s, foreign_availability, connection_type,
+                     country_prefix.length(), international_area_code.length(),
+                     operator_code.length(), national_area_code.length(),
+                     core_number.length() );
 
       // now set the strings
       s.setBits( country_prefix );
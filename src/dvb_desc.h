@@ -95,6 +95,11 @@ namespace sigen {
    public:
       enum { TAG = 0x49 };
 
+      //! \brief Layout of the fixed fields, followed by the country codes.
+      struct Layout : BitLayout<Field<1>, Reserved<7>> {
+         enum { COUNTRY_AVAILABILITY_FLAG };
+      };
+
       /*!
        * \brief Constructor.
        * \param country_availability_f `true`: Service reception intended for include country codes; `false`: otherwise.
@@ -132,6 +137,11 @@ namespace sigen {
    public:
       enum { TAG = 0x64 };
 
+      //! \brief Layout of the fixed fields, followed by the selector bytes.
+      struct Layout : BitLayout<Field<16>, Field<8>, Field<8>> {
+         enum { DATA_BROADCAST_ID, COMPONENT_TAG, SELECTOR_LENGTH };
+      };
+
       /*!
        * \brief Constructor using a component tag.
        * \param db_id Data broadcast id as per ETSI TS 101 162.
@@ -202,6 +212,11 @@ namespace sigen {
    public:
       enum { TAG = 0x58 };
 
+      //! \brief Layout of the fields after each offset's country code.
+      struct OffsetLayout : BitLayout<Field<6>, Reserved<1>, Field<1>, Field<16>> {
+         enum { COUNTRY_REGION_ID, LOCAL_TIME_OFFSET_POLARITY, LOCAL_TIME_OFFSET };
+      };
+
       //! \brief Constructor.
       LocalTimeOffsetDesc() : Descriptor(TAG) {}
 
@@ -304,6 +319,12 @@ namespace sigen {
    public:
       enum { TAG = 0x63 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Reserved<2>, Field<22>, Reserved<2>, Field<22>, Reserved<2>,
+                                Field<14>> {
+         enum { PEAK_RATE, MIN_OVERALL_SMOOTHING_RATE, MAX_OVERALL_SMOOTHING_BUFFER };
+      };
+
       /*!
        * \brief Constructor.
        * \param pk_rate Max. momentary tansport packet rate.
@@ -362,6 +383,11 @@ namespace sigen {
    public:
       enum { TAG = 0x41 };
 
+      //! \brief Layout of each service entry.
+      struct ServiceLayout : BitLayout<Field<16>, Field<8>> {
+         enum { SERVICE_ID, SERVICE_TYPE };
+      };
+
       //! \brief Constructor.
       ServiceListDesc() : Descriptor(TAG) { }
 
@@ -459,6 +485,14 @@ namespace sigen {
    public:
       enum { TAG = 0x57 };
 
+      //! \brief Layout of the fixed fields, followed by the number strings.
+      struct Layout : BitLayout<Reserved<2>, Field<1>, Field<5>, Reserved<1>, Field<2>, Field<3>,
+                                Field<2>, Reserved<1>, Field<3>, Field<4>> {
+         enum { FOREIGN_AVAILABILITY, CONNECTION_TYPE, COUNTRY_PREFIX_LENGTH,
+                INTERNATIONAL_AREA_CODE_LENGTH, OPERATOR_CODE_LENGTH,
+                NATIONAL_AREA_CODE_LENGTH, CORE_NUMBER_LENGTH };
+      };
+
       /*!
        * \brief Constructor.
        * \param foreign_avail `true`: can be called from outside the country specified by `country_prefix`
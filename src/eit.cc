@@ -22,6 +22,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
 #include <list>
@@ -81,7 +82,7 @@ namespace sigen
    void EIT::dumpEventList(std::ostream &o, const std::list<ListItem*>& list) const
    {
       // display the event list
-      incOutLevel();
+      incOutLevel(o);
 
       for (const ListItem* item : list) {
          const Event* event = dynamic_cast<const Event*>(item);
@@ -100,7 +101,7 @@ namespace sigen
 
          o << std::endl;
       }
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -119,113 +120,39 @@ namespace sigen
                           ui8 last_tid, ui8 cur_sec, ui8 last_sec_num, ui8 segm_last_sec_num,
                           ui16& sec_bytes) const
    {
-      bool done = false, exit = false;
-
-      while (!exit)
-      {
-         switch (run.op_state)
-         {
-           case INIT:
-              run.ev_iter = list.begin();
-              run.op_state = WRITE_HEAD;
-
-           case WRITE_HEAD:
-              // common data for every section
-              // if table's length is > available space, we'll
-              // overwrite the section length later on
-              writeSectionHeader(section);
-
-              // section count information
-              section.set08Bits(cur_sec);
-
-              // we don't know the last section number yet, so
-              // for now set it to 0,
-              section.set08Bits(last_sec_num);
-
-              section.set16Bits(xport_stream_id);
-              section.set16Bits(original_network_id);
-
-              // standard calls for set values for these on PF
-              section.set08Bits( segm_last_sec_num ); // segment last section num
-              section.set08Bits( last_tid );          // last_table_id
-
-              sec_bytes = BASE_LENGTH; // the minimum section size
-              run.op_state = (!run.event ? GET_EVENT : WRITE_EVENT);
-              break;
-
-           case GET_EVENT:
-              // fetch the next event
-              if (run.ev_iter != list.end()) {
-                 run.event = (*run.ev_iter++);
-
-                 if (!run.event->descriptors.list().empty()) {
-                    const Descriptor *d = run.event->descriptors.front().get();
-
-                    // check if we can fit it with at least one descriptor
-                    if (sec_bytes + Event::BASE_LEN + d->length() >
-                        getMaxDataLen()) {
-                       // we can't, so let's get another section to write
-                       // this event to
-                       run.op_state = WRITE_HEAD;
-                       exit = true;
-                       break;
-                    }
-                 }
-                 else {
-                    // no descriptors.. can we add the empty event?
-                    if ( (sec_bytes + Event::BASE_LEN) > getMaxDataLen() ) {
-                       // no soup for you
-                       run.op_state = WRITE_HEAD;
-                       exit = true;
-                       break;
-                    }
-                 }
-                 // we can add it
-                 run.op_state = WRITE_EVENT;
-              }
-              else {
-                 // done with all services.. all sections are done!
-                 run = Context();
-                 exit = done = true;
-                 break;
-              }
-              break;
-
-           case WRITE_EVENT:
-              // try to write it
-              if (!(*run.event).write_section(section, getMaxDataLen(), sec_bytes)) {
-                 run.op_state = WRITE_HEAD;
-                 exit = true;
-                 break;
-              }
-              run.op_state = GET_EVENT;
-              break;
-         }
-      }
-      return done;
+      return run.write(section, sec_bytes, BASE_LENGTH, getMaxDataLen(),
+                       [&](Section& s) {
+                          // common data for every section
+                          // if table's length is > available space, we'll
+                          // overwrite the section length later on
+                          writeSectionHeader(s);
+
+                          // section count information
+                          s.set08Bits(cur_sec);
+
+                          s.set08Bits(last_sec_num);
+
+                          s.set16Bits(xport_stream_id);
+                          s.set16Bits(original_network_id);
+
+                          // standard calls for set values for these on PF
+                          s.set08Bits( segm_last_sec_num ); // segment last section num
+                          s.set08Bits( last_tid );          // last_table_id
+                       },
+                       nullptr, &list);
    }
 
 
    //
    // data writers for EIT::Event
    //
-   ui8 EIT::Event::write_header(Section& section) const
+   void EIT::Event::write_header(Section& section) const
    {
       // write the event data
       section.set16Bits(id);
 
-      // start utc
-      section.set16Bits(utc.mjd);
-      section.set08Bits(utc.time.getBCDHour());
-      section.set08Bits(utc.time.getBCDMinute());
-      section.set08Bits(utc.time.getBCDSecond());
-
-      // duration
-      section.set08Bits(duration.getBCDHour());
-      section.set08Bits(duration.getBCDMinute());
-      section.set08Bits(duration.getBCDSecond());
-
-      return EIT::Event::BASE_LEN - 2;
+      // start utc + duration
+      section.setBits(time_data, sizeof(time_data));
    }
 
    void EIT::Event::write_desc_loop_len(Section& section, ui8* pos, ui16 len) const
@@ -236,6 +163,26 @@ namespace sigen
                          (len & LEN_MASK) );
    }
 
+   //
+   // finds the event in a built section by skipping from header to
+   // header, then patches running_status (top 3 bits of byte 10)
+   //
+   bool EIT::setRunningStatus(Section& s, ui16 ev_id, ui8 running_status)
+   {
+      enum { EVENT_LOOP_POS = 14, RS_POS = 10 };
+
+      const ui8* data = s.getBinaryData();
+      ui16 end = s.length() - (s.hasCRC() ? Section::CRC_LEN : 0);
+
+      for (ui16 i = EVENT_LOOP_POS; i + Event::BASE_LEN <= end; ) {
+         if (((data[i] << 8) | data[i + 1]) == ev_id)
+            return s.patchBits(i + RS_POS, running_status << 5, 0xe0);
+
+         i += Event::BASE_LEN + (((data[i + RS_POS] << 8) | data[i + RS_POS + 1]) & LEN_MASK);
+      }
+      return false;
+   }
+
    //
    // controls the table building.. eit's need special section builders
    // because of the DVB standard.. PF can't be sectionable and Present
@@ -247,24 +194,208 @@ namespace sigen
    //
    void PF_EIT::buildSections(TStream& strm) const
    {
-      ui16 sec_bytes;
-
       // build the present & following sections
-      for (ui8 cur_sec = 0, last_sec = 1; cur_sec <= 1; cur_sec++) {
+      for (ui8 cur_sec = 0; cur_sec <= 1; cur_sec++) {
          // allocate space for the section (use getMaxSectionLen() to include
          // room for CRC)
-         Section *s = strm.getNewSection(getMaxSectionLen());
+         buildSection(*strm.getNewSection(getMaxSectionLen()), cur_sec);
+      }
+   }
+
+   void PF_EIT::buildSection(Section& s, ui8 cur_sec) const
+   {
+      const ui8 last_sec = 1;
+      ui16 sec_bytes;
+
+      // write the section
+      writeSection(s, items[cur_sec], getId(), // id is table_id
+                   cur_sec, last_sec, last_sec, sec_bytes);
+
+      // adjust the length, and calculate the crc
+      s.set16Bits(1, buildLengthData(sec_bytes));
+      s.calcCrc();
+   }
+
+   //
+   // p/f is always two sections, so no sizing pass is needed
+   //
+   class PF_EIT::Generator : public SectionGenerator::Source
+   {
+   public:
+      explicit Generator(const PF_EIT& t) : table(t), cur_sec(0) {}
+
+      bool next(Section& s) {
+         if (cur_sec > 1)
+            return false;
+
+         s.reset();
+         table.buildSection(s, cur_sec++);
+         return true;
+      }
+
+   private:
+      const PF_EIT& table;
+      ui8 cur_sec;
+   };
+
+   SectionGenerator PF_EIT::sections() const
+   {
+      return SectionGenerator(new Generator(*this));
+   }
+
+
+
+   // ---------------------------
+   // EIT schedule
+   //
+
+   //
+   // assigns the (start time ordered) events to 3-hour segments and the
+   // segments' events to up to 8 sections each. Sections only keep the
+   // range of events they hold, so building one later is a straight copy
+   //
+   void ES_EIT::layout(Layout& l) const
+   {
+      enum { NONE = 0xffffffff };
+      const ui16 max_len = getMaxDataLen();
+      const ui32 max_seg = MAX_TABLES * TABLE_SEGMENTS;
+
+      l.sections.clear();
+      std::fill(l.last_section_number, l.last_section_number + MAX_TABLES, 0);
+
+      ui32 open = NONE;     // segment being filled
+      ui16 sec_bytes = 0;
+      bool seg_full = false;
+
+      for (ui32 i = 0; i < events.size(); i++) {
+         const ui16 mjd = events.getStartMJD(i);
+         if (mjd < first_mjd)
+            continue;
+
+         const ui32 seg = ((mjd - first_mjd) * 24 + events.getStartHour(i)) / SEGMENT_HOURS;
+         if (seg >= max_seg)
+            break;
+
+         if (seg != open) {
+            // empty segments before this one in its table, and an empty
+            // first segment for tables with no events at all
+            for (ui32 e = (open == NONE) ? 0 : open + 1; e < seg; e++) {
+               if (e / TABLE_SEGMENTS == seg / TABLE_SEGMENTS ||
+                   (e % TABLE_SEGMENTS == 0 && (open == NONE || e / TABLE_SEGMENTS != open / TABLE_SEGMENTS))) {
+                  const ui8 sn = (e % TABLE_SEGMENTS) * SEGMENT_SECTIONS;
+                  l.sections.push_back({ ui8(e / TABLE_SEGMENTS), sn, sn, i, i });
+               }
+            }
+
+            const ui8 sn = (seg % TABLE_SEGMENTS) * SEGMENT_SECTIONS;
+            l.sections.push_back({ ui8(seg / TABLE_SEGMENTS), sn, sn, i, i });
+            open = seg;
+            sec_bytes = BASE_LENGTH;
+            seg_full = false;
+         }
 
-         // write the section
-         writeSection(*s, items[cur_sec], getId(), // id is table_id
-                      cur_sec, last_sec, last_sec, sec_bytes);
+         if (seg_full)
+            continue;
 
-         // adjust the length, and calculate the crc
-         s->set16Bits(1, buildLengthData(sec_bytes));
-         s->calcCrc();
+         const ui16 len = events.length(i);
+         if (BASE_LENGTH + len > max_len) {
+            // can never fit - buildSection() skips it
+            l.sections.back().end = i + 1;
+            continue;
+         }
+
+         if (sec_bytes + len > max_len) {
+            SectionRef& cur = l.sections.back();
+            if ((cur.section_number % SEGMENT_SECTIONS) == SEGMENT_SECTIONS - 1) {
+               // out of sections, drop the rest of the segment
+               seg_full = true;
+               continue;
+            }
+            l.sections.push_back({ cur.table, ui8(cur.section_number + 1), 0, i, i });
+            sec_bytes = BASE_LENGTH;
+         }
+         l.sections.back().end = i + 1;
+         sec_bytes += len;
+      }
+
+      if (l.sections.empty())
+         l.sections.push_back({ 0, 0, 0, 0, 0 });
+
+      // each segment's last section number, working backwards
+      ui32 seg = NONE;
+      ui8 seg_last = 0;
+      for (auto it = l.sections.rbegin(); it != l.sections.rend(); ++it) {
+         const ui32 s = it->table * TABLE_SEGMENTS + it->section_number / SEGMENT_SECTIONS;
+         if (s != seg) {
+            seg = s;
+            seg_last = it->section_number;
+         }
+         it->segment_last_section_number = seg_last;
+         l.last_section_number[it->table] = std::max(l.last_section_number[it->table],
+                                                     it->section_number);
+      }
+      l.last_table = l.sections.back().table;
+   }
+
+   void ES_EIT::buildSection(Section& s, const Layout& l, const SectionRef& ref) const
+   {
+      writeSectionHeader(s);
+      s.set08Bits(0, getId() + ref.table);  // table_id
+
+      s.set08Bits(ref.section_number);
+      s.set08Bits(l.last_section_number[ref.table]);
+      s.set16Bits(xport_stream_id);
+      s.set16Bits(original_network_id);
+      s.set08Bits(ref.segment_last_section_number);
+      s.set08Bits(getId() + l.last_table);
+
+      for (ui32 i = ref.first; i < ref.end; i++) {
+         if (BASE_LENGTH + events.length(i) <= getMaxDataLen())
+            events.write(i, s);
+      }
+
+      // everything after the length field, including the crc
+      s.set16Bits(1, buildLengthData(s.length() - 3 + Section::CRC_LEN));
+      s.calcCrc();
+   }
+
+   void ES_EIT::buildSections(TStream& strm) const
+   {
+      Layout l;
+      layout(l);
+
+      for (const SectionRef& ref : l.sections) {
+         buildSection(*strm.getNewSection(getMaxSectionLen()), l, ref);
       }
    }
 
+   //
+   // the layout is worked out up front, then one section built per call
+   //
+   class ES_EIT::Generator : public SectionGenerator::Source
+   {
+   public:
+      explicit Generator(const ES_EIT& t) : table(t), cur(0) { table.layout(l); }
+
+      bool next(Section& s) {
+         if (cur >= l.sections.size())
+            return false;
+
+         s.reset();
+         table.buildSection(s, l, l.sections[cur++]);
+         return true;
+      }
+
+   private:
+      const ES_EIT& table;
+      Layout l;
+      size_t cur;
+   };
+
+   SectionGenerator ES_EIT::sections() const
+   {
+      return SectionGenerator(new Generator(*this));
+   }
 
 
 #ifdef ENABLE_DUMP
@@ -273,16 +404,16 @@ namespace sigen
    void PF_EIT::dumpEvents(std::ostream &o) const
    {
       // display the present event list
-      incOutLevel();
+      incOutLevel(o);
       headerStr(o, P_EVENT_LIST_S);
       dumpEventList(o, present);
-      decOutLevel();
+      decOutLevel(o);
 
       // display the following event list
-      incOutLevel();
+      incOutLevel(o);
       headerStr(o, F_EVENT_LIST_S);
       dumpEventList(o, following);
-      decOutLevel();
+      decOutLevel(o);
    }
 
    //
@@ -293,6 +424,42 @@ namespace sigen
                            ((getId() == ACTUAL) ? EIT_PF_ACTUAL_S : EIT_PF_OTHER_S),
                            SERVICE_ID_S);
    }
+
+   //
+   // schedule event dumps
+   void ES_EIT::dumpEvents(std::ostream &o) const
+   {
+      incOutLevel(o);
+
+      for (size_t i = 0; i < events.size(); i++) {
+         ui8 bcd[BCDTime::TIME_LEN];
+         memcpy(bcd, events.getStartTime(i) + 2, sizeof(bcd));
+
+         o << std::hex;
+         identStr(o, EVENT_ID_S, events.getId(i));
+         identStr(o, START_TIME_S, UTC(events.getStartMJD(i), bcd));
+         identStr(o, DURATION_S, BCDTime(events.getDuration(i)));
+         identStr(o, RUNNING_STATUS_S, events.getRunningStatus(i));
+         identStr(o, FREE_CA_MODE_S, events.getFreeCAMode(i));
+
+         identStr(o, DESC_LOOP_LEN_S, events.getDescLoopLen(i));
+         o << std::endl;
+
+         // descriptors are only kept serialized
+         if (events.getDescLoopLen(i))
+            dumpData(o, events.getDescData(i), events.getDescLoopLen(i));
+
+         o << std::endl;
+      }
+      decOutLevel(o);
+   }
+
+   void ES_EIT::dumpHeader(std::ostream &o) const
+   {
+      PSITable::dumpHeader(o,
+                           ((getId() == ACTUAL) ? EIT_ES_ACTUAL_S : EIT_ES_OTHER_S),
+                           SERVICE_ID_S);
+   }
 #endif
 
 } // namespace sigen
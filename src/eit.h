@@ -24,6 +24,9 @@
 
 #include <memory>
 #include <list>
+#include <vector>
+#include "event_store.h"
+#include "section_writer.h"
 #include "table.h"
 #include "utc.h"
 
@@ -48,6 +51,18 @@ namespace sigen {
       // utility
       virtual void buildSections(TStream& ts) const = 0;
 
+      /*!
+       * \brief Change the running status of an event in a built section.
+       *
+       * Walks the event headers and patches the 3 bits in place, the
+       * CRC is updated from the changed bits only.
+       * \param s EIT section to patch.
+       * \param ev_id Id identifying the event.
+       * \param running_status Running status of the event. See sigen::Dvb::RunningStatus_t.
+       * \return `false` if the event is not in the section.
+       */
+      static bool setRunningStatus(Section& s, ui16 ev_id, ui8 running_status);
+
 #ifdef ENABLE_DUMP
       virtual void dump(std::ostream& o) const;
 #endif
@@ -63,7 +78,7 @@ namespace sigen {
       { }
 
       // the private event class
-      struct Event : public ExtPSITable::ListItem {
+      struct Event final : public ExtPSITable::LoopItem<Event> {
          enum { BASE_LEN = 12 };
 
          // instance variables
@@ -73,6 +88,9 @@ namespace sigen {
          ui8 running_status : 3;
          bool free_CA_mode;
 
+         // start_time + duration fields, precomputed in wire format
+         ui8 time_data[UTC::BYTE_LEN + BCDTime::TIME_LEN];
+
          // constructor
          Event(ui16 evid, const UTC& time, const BCDTime& dur, ui8 rs, bool fcam)
             : id(evid),
@@ -80,16 +98,19 @@ namespace sigen {
             duration(dur),
             running_status(rs),
             free_CA_mode(fcam)
-         { }
+         {
+            utc.getBytes(time_data);
+            duration.getBCD(time_data + UTC::BYTE_LEN);
+         }
          Event() = delete;
 
          virtual ui16 length() const { return 12; }
          virtual bool equals(ui16 ev_id) const { return ev_id == id; }
 
-         // writes item header bytes, returns num bytes written
-         virtual ui8 write_header(Section& sec) const;
+         // writes item header bytes
+         void write_header(Section& sec) const;
          // writes the 2-byte desc loop len
-         virtual void write_desc_loop_len(Section& sec, ui8* pos, ui16 len) const;
+         void write_desc_loop_len(Section& sec, ui8* pos, ui16 len) const;
       };
 
       // common EIT data members begin here
@@ -117,14 +138,7 @@ namespace sigen {
       bool writeSection(Section& s, ui8, ui16& sec_bytes) const { return false; }
 
    private:
-      enum State_t { INIT, WRITE_HEAD, GET_EVENT, WRITE_EVENT };
-      mutable struct Context {
-         Context() : op_state(INIT), event(nullptr) {}
-
-         State_t op_state;
-         const ListItem* event;
-         std::list<ListItem*>::const_iterator ev_iter;
-      } run;
+      mutable SectionWriter<Event, std::list<ListItem*> > run;
    };
 
    /*!
@@ -165,6 +179,18 @@ namespace sigen {
       bool addPresentEventDesc(ui16 ev_id, Descriptor& desc) {
          return addItemDesc(present, ev_id, desc);
       }
+      /*!
+       * \brief Construct a Descriptor in place and add it to the present event specified.
+       *
+       * The `D` is built in the table's arena instead of being allocated
+       * on its own, e.g. `eit.emplacePresentEventDesc<ShortEventDesc>(ev_id, lang, name, text)`.
+       * \param ev_id Id identifying the event.
+       * \param args Arguments for the `D` constructor.
+       */
+      template <class D, class... Args>
+      bool emplacePresentEventDesc(ui16 ev_id, Args&&... args) {
+         return emplaceItemDesc<D>(present, ev_id, std::forward<Args>(args)...);
+      }
       /*!
        * \brief Add a following event.
        * \param ev_id Unique id of the event within the service.
@@ -190,9 +216,19 @@ namespace sigen {
       bool addFollowingEventDesc(ui16 ev_id, Descriptor& desc) {
          return addItemDesc(following, ev_id, desc);
       }
+      /*!
+       * \brief Construct a Descriptor in place and add it to the following event specified.
+       * \param ev_id Id identifying the event.
+       * \param args Arguments for the `D` constructor.
+       */
+      template <class D, class... Args>
+      bool emplaceFollowingEventDesc(ui16 ev_id, Args&&... args) {
+         return emplaceItemDesc<D>(following, ev_id, std::forward<Args>(args)...);
+      }
 
       // top-level table builder
       void buildSections(TStream& ts) const;
+      SectionGenerator sections() const;
 
    protected:
       // protected constructor
@@ -206,6 +242,12 @@ namespace sigen {
       void dumpHeader(std::ostream& o) const;
       void dumpEvents(std::ostream& o) const;
 #endif
+
+   private:
+      class Generator;
+
+      // writes the present (0) or following (1) section
+      void buildSection(Section& s, ui8 cur_sec) const;
    };
    //! @}
 
@@ -253,25 +295,124 @@ namespace sigen {
    //! @}
    //! @}
 
-#if 0
-   // ========================================================================
-   //
-   // event schedule EIT's
+   /*! \addtogroup abstract
+    *  @{
+    */
 
-   // NOT YET IMPLEMENTED
+   /*!
+    * \brief Abstract base class for EIT-Schedule, sectioned straight
+    * from an EventStore.
+    *
+    * Events are grouped into 3-hour segments from midnight of the first
+    * day, 32 segments (4 days) per table_id and up to 8 sections per
+    * segment; events that don't fit (or are more than 64 days out) are
+    * left out. Empty segments up to the last one with events in a
+    * table_id are sent as a single empty section. The store is not
+    * copied and must not change while the table is in use.
+    */
    class ES_EIT : public EIT
    {
-   private:
-      enum { ACTUAL_BASE = 0x50, OTHER_BASE_0x60 };
-
-//   ES_EIT(ui16 sid, ui16 xsid, ui16 onid, ui8 ver, bool cni = true) :
-//       EIT(TID, sid, xsid, onid, ver, cni) { }
    public:
+      enum Type { ACTUAL = 0x50, OTHER = 0x60 };
+      enum {
+         SEGMENT_HOURS = 3,
+         TABLE_SEGMENTS = 32,        // per table_id
+         SEGMENT_SECTIONS = 8,       // max sections per segment
+         MAX_TABLES = 16             // table_id's per service
+      };
+
+      // top-level table builder
+      void buildSections(TStream& ts) const;
+      SectionGenerator sections() const;
+
+   protected:
+      // protected constructor
+      ES_EIT(const EventStore& events, ui16 sid, ui16 xsid, ui16 onid, ES_EIT::Type type,
+             ui16 first_mjd, ui8 ver, bool cni = true)
+         : EIT(0, type, sid, xsid, onid, ver, cni),
+           events(events), first_mjd(first_mjd)
+      { }
 
 #ifdef ENABLE_DUMP
       void dumpHeader(std::ostream& o) const;
+      void dumpEvents(std::ostream& o) const;
 #endif
+
+   private:
+      class Generator;
+
+      // a section and the range of events in it
+      struct SectionRef {
+         ui8 table;
+         ui8 section_number;
+         ui8 segment_last_section_number;
+         ui32 first, end;
+      };
+      struct Layout {
+         std::vector<SectionRef> sections;
+         ui8 last_section_number[MAX_TABLES];
+         ui8 last_table;
+      };
+
+      const EventStore& events;
+      ui16 first_mjd;
+
+      // the sizing pass: assigns the events to sections
+      void layout(Layout& l) const;
+      void buildSection(Section& s, const Layout& l, const SectionRef& ref) const;
+   };
+   //! @}
+
+   /*! \addtogroup table
+    *  @{
+    */
+
+   /*! \addtogroup DVB
+    *  @{
+    */
+
+   /*!
+    * \brief Event Information %Table, Schedule - Actual, as per ETSI EN 300 468.
+    */
+   struct ES_EITActual : public ES_EIT
+   {
+      /*!
+       * \brief Constructor.
+       * \param events The service's events.
+       * \param sid Id to identify the service.
+       * \param xs_id Id to identify the transport stream.
+       * \param on_id Id to identify the bouquet.
+       * \param first_mjd Day the first segment starts on (at 00:00).
+       * \param version_number Version number to use the subtable.
+       * \param current_next_indicator `true`: version curently applicable, `false`: next applicable.
+       */
+      ES_EITActual(const EventStore& events, ui16 sid, ui16 xs_id, ui16 on_id, ui16 first_mjd,
+                   ui8 version_number, bool current_next_indicator = true)
+         : ES_EIT(events, sid, xs_id, on_id, ES_EIT::ACTUAL, first_mjd, version_number,
+                  current_next_indicator) { }
    };
-#endif // if 0
+
+   /*!
+    * \brief Event Information %Table, Schedule - Other, as per ETSI EN 300 468.
+    */
+   struct ES_EITOther : public ES_EIT
+   {
+      /*!
+       * \brief Constructor.
+       * \param events The service's events.
+       * \param sid Id to identify the service.
+       * \param xs_id Id to identify the transport stream.
+       * \param on_id Id to identify the bouquet.
+       * \param first_mjd Day the first segment starts on (at 00:00).
+       * \param version_number Version number to use the subtable.
+       * \param current_next_indicator `true`: version curently applicable, `false`: next applicable.
+       */
+      ES_EITOther(const EventStore& events, ui16 sid, ui16 xs_id, ui16 on_id, ui16 first_mjd,
+                  ui8 version_number, bool current_next_indicator = true)
+         : ES_EIT(events, sid, xs_id, on_id, ES_EIT::OTHER, first_mjd, version_number,
+                  current_next_indicator) { }
+   };
+   //! @}
+   //! @}
 
 } // sigen namespace
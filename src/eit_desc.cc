@@ -50,9 +50,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set08Bits( rbits(0xf0) | stream_content );
-      s.set08Bits( component_type );
-      s.set08Bits( component_tag );
+      Layout::write( s, stream_content, component_type, component_tag );
       s.setBits( language_code );
       s.setBits( text );
    }
@@ -100,10 +98,9 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      for (const auto &content : content_list) {
-         s.set08Bits( (content.nibble_level_1 << 4) | content.nibble_level_2 );
-         s.set08Bits( (content.user_nibble_1 << 4) | content.user_nibble_2 );
-      }
+      for (const auto &content : content_list)
+         ContentLayout::write( s, content.nibble_level_1, content.nibble_level_2,
+                               content.user_nibble_1, content.user_nibble_2 );
    }
 
 
@@ -114,14 +111,14 @@ namespace sigen
    {
       dumpHeader(o, CONTENT_D_S);
 
-      incOutLevel();
+      incOutLevel(o);
       for (const auto &content : content_list) {
          identStr(o, CONTENT_NL_1, content.nibble_level_1);
          identStr(o, CONTENT_NL_2, content.nibble_level_2);
          identStr(o, USER_NL_1, content.user_nibble_1);
          identStr(o, USER_NL_2, content.user_nibble_2);
       }
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -134,19 +131,19 @@ namespace sigen
    //
    // adds an item to the loop
    //
-   bool ExtendedEventDesc::addItem(const std::string& desc, const std::string& name)
+   bool ExtendedEventDesc::addItem(StrView desc, StrView name)
    {
       // this descriptor is kind of funky because we need to store more
       // data than the usual 255 as it can span across multiple extended
       // event descriptors sent.  however, each item's total length can't
       // exceed 255 either.. so to simplify things, if an item exceeds
       // the 255 limit, we reject it off the bat..
-      std::unique_ptr<Item> item(new Item(desc, name));
+      const size_t len = Item::BASE_LEN + desc.length() + name.length();
 
-      if ( !incLength( item->length() ) )
+      if ( len > MAX_LEN || !incLength( static_cast<ui8>(len) ) )
          return false;
 
-      item_list.push_back( std::move(item) );
+      item_list.emplace_back( new Item(desc, name) );
       return true;
    }
 
@@ -167,7 +164,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set08Bits( (descriptor_number << 4) | last_descriptor_number );
+      Layout::write( s, descriptor_number, last_descriptor_number );
       s.setBits( language_code );
       s.set08Bits( itemListSize() );
 
@@ -200,7 +197,7 @@ namespace sigen
       identStr(o, LENGTH_OF_ITEMS_S, itemListSize());
 
       // the loop of items
-      incOutLevel();
+      incOutLevel(o);
 
       for (const auto& item : item_list) {
          identStr(o, DESCRPTN_LEN_S, item->description.length());
@@ -208,7 +205,7 @@ namespace sigen
          identStr(o, ITEM_LEN_S, item->name.length());
          identStr(o, ITEM_S, item->name);
       }
-      decOutLevel();
+      decOutLevel(o);
 
       // finally the text
       identStr(o, TEXT_LEN_S, text.length());
@@ -217,6 +214,233 @@ namespace sigen
 #endif
 
 
+   //
+   // Extended Event Descriptor splitter
+   // ---------------------------------------
+
+   //
+   // adds an item, tracking how many descriptors the item loop
+   // alone takes up so it can be rejected if it won't fit
+   bool ExtendedEventSplitter::addItem(const std::string& desc, const std::string& name)
+   {
+      // items aren't split so each one must fit in a single descriptor
+      size_t len = desc.length() + name.length() + 2;
+      if (len > MAX_PAYLOAD)
+         return false;
+
+      // place it after the previous items
+      ui8 descs = item_descs;
+      ui16 tail = item_tail;
+      if (descs == 0 || tail + len > MAX_PAYLOAD) {
+         descs++;
+         tail = 0;
+      }
+      if (descs > ExtendedEventDesc::MAX_DESC_IDX)
+         return false;
+
+      items.push_back( { item_data.length(),
+                         static_cast<ui8>(desc.length()),
+                         static_cast<ui8>(name.length()) } );
+      item_data.append(desc).append(name);
+
+      item_descs = descs;
+      item_tail = tail + len;
+      return true;
+   }
+
+
+   //
+   // clears the event data - string and vector capacities are kept
+   void ExtendedEventSplitter::reset(Encoding enc)
+   {
+      encoding = enc;
+      text.clear();
+      item_data.clear();
+      items.clear();
+      item_descs = 0;
+      item_tail = 0;
+   }
+
+
+   //
+   // length of the Annex A character table selector at the start of
+   // the text (DVB encoding only)
+   ui8 ExtendedEventSplitter::selectorLength() const
+   {
+      if (encoding == UTF8 || text.empty())
+         return 0;
+
+      ui8 len;
+      switch (static_cast<ui8>(text[0]))
+      {
+        case 0x10:            // 0x10 0x00 0x0n: ISO/IEC 8859-n
+           len = 3;
+           break;
+        case 0x1f:            // 0x1f + encoding_type_id
+           len = 2;
+           break;
+        default:
+           len = (static_cast<ui8>(text[0]) < 0x20) ? 1 : 0;
+           break;
+      }
+      return (text.length() < len) ? text.length() : len;
+   }
+
+
+   //
+   // returns how many bytes of text starting at pos fit in avail
+   // bytes without splitting a character
+   ui16 ExtendedEventSplitter::charsFit(size_t pos, ui16 avail) const
+   {
+      size_t rem = text.length() - pos;
+      if (rem <= avail)
+         return rem;
+
+      ui8 table = (encoding == UTF8) ? static_cast<ui8>(UTF8_SELECTOR)
+         : (selectorLength() ? static_cast<ui8>(text[0]) : 0);
+      const ui8* p = reinterpret_cast<const ui8*>(text.data()) + pos;
+      ui16 n = avail;
+
+      switch (table)
+      {
+        case UTF8_SELECTOR:
+           // back up to the start of a sequence
+           while (n > 0 && (p[n] & 0xc0) == 0x80)
+              n--;
+           return n;
+
+        case 0x11:            // ISO/IEC 10646 BMP, 2-byte chars
+           return n & ~1;
+
+        case 0x00:            // ISO/IEC 6937 - diacritical marks precede the letter
+        case 0x12:            // KS X 1001, GB-2312 and Big5 - high bit
+        case 0x13:            // set on the first of two bytes
+        case 0x14:
+        {
+           ui16 i = 0;
+           while (i < n) {
+              ui8 step = ((table == 0x00) ? (p[i] >= 0xc1 && p[i] <= 0xcf) : (p[i] >= 0x80)) ? 2 : 1;
+              if (i + step > n)
+                 break;
+              i += step;
+           }
+           return i;
+        }
+
+        default:              // single byte tables
+           return n;
+      }
+   }
+
+
+   //
+   // lays out the descriptor chain: items first, each descriptor
+   // filled as far as possible, then the text continues in the space
+   // left after the last item
+   void ExtendedEventSplitter::split() const
+   {
+      const ui8 sel_len = selectorLength();
+      const ui8 prefix_len = (encoding == UTF8) ? 1 : sel_len;
+      ui16 used = 0;
+
+      chunks.clear();
+
+      for (ui16 i = 0; i < items.size(); i++) {
+         if (chunks.empty() || used + items[i].length() > MAX_PAYLOAD) {
+            chunks.push_back( { i, i, 0, 0 } );
+            used = 0;
+         }
+         chunks.back().item_last = i + 1;
+         used += items[i].length();
+      }
+
+      size_t pos = sel_len;
+      while (pos < text.length()) {
+         if (chunks.empty() || chunks.back().text_len ||
+             used + prefix_len >= MAX_PAYLOAD) {
+            // no room - truncate if we've hit the descriptor limit
+            if (chunks.size() == ExtendedEventDesc::MAX_DESC_IDX)
+               break;
+
+            ui16 idx = items.size();
+            chunks.push_back( { idx, idx, 0, 0 } );
+            used = 0;
+         }
+
+         ui16 n = charsFit(pos, MAX_PAYLOAD - used - prefix_len);
+         if (n == 0) {
+            // a broken sequence that won't fit an empty descriptor
+            if (used == 0)
+               break;
+            used = MAX_PAYLOAD;
+            continue;
+         }
+
+         chunks.back().text_pos = pos;
+         chunks.back().text_len = n;
+         used += prefix_len + n;
+         pos += n;
+      }
+   }
+
+
+   //
+   // number of descriptors in the chain
+   ui8 ExtendedEventSplitter::count() const
+   {
+      if (text.length() <= selectorLength())
+         return item_descs;
+
+      split();
+      return chunks.size();
+   }
+
+
+   //
+   // allocates the descriptor chain
+   std::vector<std::unique_ptr<ExtendedEventDesc> > ExtendedEventSplitter::build() const
+   {
+      std::vector<std::unique_ptr<ExtendedEventDesc> > descs;
+
+      split();
+      if (chunks.empty())
+         return descs;
+
+      const ui8 sel_len = selectorLength();
+      const ui8 last = chunks.size() - 1;
+      descs.reserve(chunks.size());
+
+      for (ui8 i = 0; i <= last; i++) {
+         const Chunk& c = chunks[i];
+
+         // each chunk of text carries its own table selector
+         std::string chunk_text;
+         if (c.text_len) {
+            chunk_text.reserve( ((encoding == UTF8) ? 1 : sel_len) + c.text_len );
+            if (encoding == UTF8)
+               chunk_text.push_back( static_cast<char>(UTF8_SELECTOR) );
+            else
+               chunk_text.append( text, 0, sel_len );
+            chunk_text.append( text, c.text_pos, c.text_len );
+         }
+
+         std::unique_ptr<ExtendedEventDesc> d(new ExtendedEventDesc(language_code, std::move(chunk_text),
+                                                                    i, last));
+
+         // items are sliced straight from the shared buffer
+         for (ui16 j = c.item_first; j < c.item_last; j++) {
+            const Item& item = items[j];
+            const char* data = item_data.data() + item.pos;
+            d->addItem( StrView(data, item.desc_len),
+                        StrView(data + item.desc_len, item.name_len) );
+         }
+         descs.push_back( std::move(d) );
+      }
+      return descs;
+   }
+
+
+
    //
    // Multilingual Component Descriptor
    // ---------------------------------------
@@ -233,7 +457,7 @@ namespace sigen
    void MultilingualComponentDesc::buildSections(Section &s) const
    {
       Descriptor::buildSections(s);
-      s.set08Bits(component_tag);
+      Layout::write( s, component_tag );
       buildLoopData(s);
    }
 
@@ -288,12 +512,12 @@ namespace sigen
    {
       dumpHeader(o, PARENTAL_RATING_D_S);
 
-      incOutLevel();
+      incOutLevel(o);
       for (const auto &rating : rating_list) {
          identStr(o, CODE_S, rating.country_code);
          identStr(o, RATING_S, static_cast<ui16>(rating.value));
       }
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -307,8 +531,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.setBits( rbits(0xf00000) |
-                 programme_identification_label );
+      Layout::write( s, programme_identification_label );
    }
 
 #ifdef ENABLE_DUMP
@@ -325,8 +548,7 @@ namespace sigen
    //
    // Short Event Descriptor
    // ---------------------------------------
-   ShortEventDesc::ShortEventDesc(const std::string &code, const std::string &ev_name,
-                                  const std::string &ev_text) :
+   ShortEventDesc::ShortEventDesc(const std::string &code, StrView ev_name, StrView ev_text) :
       Descriptor(TAG, 5),
       language_code(code), name( incLength(ev_name) ),
       text( incLength(ev_text) )
@@ -389,7 +611,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set08Bits( (sb_size << 6) | sb_leak_rate );
+      Layout::write( s, sb_size, sb_leak_rate );
       s.setBits( DVB_reserved );
    }
 
@@ -415,8 +637,7 @@ namespace sigen
    void TimeShiftedEventDesc::buildSections(Section &s) const
    {
       Descriptor::buildSections(s);
-      s.set16Bits(ref_service_id);
-      s.set16Bits(ref_event_id);
+      Layout::write( s, ref_service_id, ref_event_id );
    }
 
 #ifdef ENABLE_DUMP
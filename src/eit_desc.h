@@ -25,6 +25,8 @@
 #include <memory>
 #include <list>
 #include <string>
+#include <utility>
+#include <vector>
 #include "descriptor.h"
 
 namespace sigen {
@@ -39,6 +41,11 @@ namespace sigen {
    public:
       enum { TAG = 0x50 };
 
+      //! \brief Layout of the fixed fields, followed by the language code and text.
+      struct Layout : BitLayout<Reserved<4>, Field<4>, Field<8>, Field<8>> {
+         enum { STREAM_CONTENT, COMPONENT_TYPE, COMPONENT_TAG };
+      };
+
       // constructor
       ComponentDesc(ui8 sc, ui8 ctype, ui8 ctag,
                     const std::string& code, const std::string& text);
@@ -68,6 +75,11 @@ namespace sigen {
    public:
       enum { TAG = 0x54 };
 
+      //! \brief Layout of each content entry.
+      struct ContentLayout : BitLayout<Field<4>, Field<4>, Field<4>, Field<4>> {
+         enum { CONTENT_NIBBLE_LEVEL_1, CONTENT_NIBBLE_LEVEL_2, USER_NIBBLE_1, USER_NIBBLE_2 };
+      };
+
       // constructor
       ContentDesc() : Descriptor(TAG) { }
 
@@ -108,8 +120,13 @@ namespace sigen {
    public:
       enum { TAG = 0x4e, MAX_DESC_IDX = 16 };
 
+      //! \brief Layout of the fixed fields, followed by the language code and items.
+      struct Layout : BitLayout<Field<4>, Field<4>> {
+         enum { DESCRIPTOR_NUMBER, LAST_DESCRIPTOR_NUMBER };
+      };
+
       // constructor
-      ExtendedEventDesc(const std::string& lang_code, const std::string& evtext,
+      ExtendedEventDesc(const std::string& lang_code, StrView evtext,
                         ui8 desc_num, ui8 last_desc_num = 0) :
          Descriptor(TAG, 6 ),
          language_code( lang_code ),
@@ -117,6 +134,18 @@ namespace sigen {
          descriptor_number( desc_num ),
          last_descriptor_number( last_desc_num ) // this may have to be re-set later
       { }
+      ExtendedEventDesc(const std::string& lang_code, std::string&& evtext,
+                        ui8 desc_num, ui8 last_desc_num = 0) :
+         Descriptor(TAG, 6 ),
+         language_code( lang_code ),
+         text( incLength(std::move(evtext)) ),
+         descriptor_number( desc_num ),
+         last_descriptor_number( last_desc_num )
+      { }
+      ExtendedEventDesc(const std::string& lang_code, const char* evtext,
+                        ui8 desc_num, ui8 last_desc_num = 0) :
+         ExtendedEventDesc(lang_code, StrView(evtext), desc_num, last_desc_num)
+      { }
       ExtendedEventDesc() = delete;
 
       // use to replace the descriptor count value
@@ -124,9 +153,9 @@ namespace sigen {
          last_descriptor_number = last_desc_num;
       }
 
-      // adds an item to the loop.. we pass by value cause we might need to
-      // modify the strings
-      bool addItem(const std::string& desc, const std::string& item);
+      // adds an item to the loop, copying the viewed text once. Fails if
+      // the item doesn't fit
+      bool addItem(StrView desc, StrView item);
       virtual void buildSections(Section&) const;
 
 #ifdef ENABLE_DUMP
@@ -142,8 +171,8 @@ namespace sigen {
          std::string name;
 
          // constructor
-         Item(const std::string &d, const std::string& n) :
-            description(d), name(n) { }
+         Item(StrView d, StrView n) :
+            description(d.str()), name(n.str()) { }
          Item() = delete;
 
          ui16 length() const {
@@ -163,6 +192,86 @@ namespace sigen {
    };
 
 
+   // ---------------------------
+   // Extended Event Descriptor splitter - support class to spread an
+   // event's item list and (arbitrarily long) text across the minimal
+   // chain of ExtendedEventDesc's, setting descriptor_number and
+   // last_descriptor_number on each. Items are never split; text is
+   // split on character boundaries and any character table selector
+   // is repeated at the start of every chunk. The object can be
+   // reset() and reused for the next event to keep its buffers.
+   //
+   class ExtendedEventSplitter
+   {
+   public:
+      // DVB: text is already encoded as per EN 300 468 Annex A (the
+      // selector, if any, is detected from the leading bytes). UTF8:
+      // raw UTF-8 with no selector - 0x15 is prepended to every chunk
+      enum Encoding { DVB, UTF8 };
+
+      // constructor
+      ExtendedEventSplitter(const std::string& lang_code, Encoding enc = DVB) :
+         language_code(lang_code), encoding(enc) { }
+      ExtendedEventSplitter() = delete;
+
+      // sets the event text
+      void setText(const std::string& evtext) { text.assign(evtext); }
+      // adds an item to the loop. Fails if the item can't fit in a
+      // single descriptor or the items alone would need more than
+      // MAX_DESC_IDX descriptors
+      bool addItem(const std::string& desc, const std::string& item);
+      // clears items and text, keeping the allocated buffers
+      void reset(Encoding enc);
+      void reset() { reset(encoding); }
+
+      // number of descriptors build() will return
+      ui8 count() const;
+      // allocates the descriptor chain. Text that does not fit in
+      // MAX_DESC_IDX descriptors is truncated. Each descriptor is
+      // release()'d to the table it is added to
+      std::vector<std::unique_ptr<ExtendedEventDesc> > build() const;
+
+   private:
+      enum {
+         // room for items + text: Descriptor::incLength() tops out at
+         // 254 bytes, less desc_num, lang code, item & text length bytes
+         MAX_PAYLOAD = 248,
+         UTF8_SELECTOR = 0x15
+      };
+
+      // an item stored as offsets in the shared buffer
+      struct Item {
+         size_t pos;
+         ui8 desc_len;
+         ui8 name_len;
+
+         ui16 length() const { return desc_len + name_len + 2; }
+      };
+
+      // a descriptor in the chain
+      struct Chunk {
+         ui16 item_first, item_last;
+         size_t text_pos;
+         ui16 text_len;
+      };
+
+      std::string language_code;
+      Encoding encoding;
+      std::string text;
+      std::string item_data;
+      std::vector<Item> items;
+      ui8 item_descs = 0;   // descriptors used by the items alone
+      ui16 item_tail = 0;   // bytes used by items in the last one
+
+      // layout scratch, reused across calls
+      mutable std::vector<Chunk> chunks;
+
+      ui8 selectorLength() const;
+      ui16 charsFit(size_t pos, ui16 avail) const;
+      void split() const;
+   };
+
+
 
    // ---------------------------
    // Multilingual Component Descriptor
@@ -175,6 +284,11 @@ namespace sigen {
    public:
       enum { TAG = 0x5e };
 
+      //! \brief Layout of the fixed fields, followed by the text loop.
+      struct Layout : BitLayout<Field<8>> {
+         enum { COMPONENT_TAG };
+      };
+
       // constructor
       MultilingualComponentDesc(ui8 ctag) :
          MultilingualTextDesc(TAG, 1),
@@ -241,6 +355,11 @@ namespace sigen {
    public:
       enum { TAG = 0x69 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Reserved<4>, Field<20>> {
+         enum { PROGRAMME_IDENTIFICATION_LABEL };
+      };
+
       // constructor
       PDCDesc(ui32 pil) :
          Descriptor(TAG, 3),
@@ -270,8 +389,7 @@ namespace sigen {
       enum { TAG = 0x4d };
 
       // constructor
-      ShortEventDesc(const std::string& code, const std::string& ev_name,
-                     const std::string& text);
+      ShortEventDesc(const std::string& code, StrView ev_name, StrView text);
       ShortEventDesc() = delete;
 
       // utility
@@ -297,6 +415,11 @@ namespace sigen {
    public:
       enum { TAG = 0x61 };
 
+      //! \brief Layout of the fixed fields, followed by the reserved bytes.
+      struct Layout : BitLayout<Field<2>, Field<6>> {
+         enum { SB_SIZE, SB_LEAK_RATE };
+      };
+
       // constructor
       ShortSmoothingBufferDesc(ui8 size, ui8 leak_rate,
                                const std::string& dvb_reserved = "");
@@ -327,6 +450,11 @@ namespace sigen {
    public:
       enum { TAG = 0x4f };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Field<16>, Field<16>> {
+         enum { REFERENCE_SERVICE_ID, REFERENCE_EVENT_ID };
+      };
+
       // constructor
       TimeShiftedEventDesc(ui16 sid,  ui16 evid) :
          Descriptor(TAG, 4),
@@ -0,0 +1,161 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// event_store.cc: packed, structure of arrays store of EIT events
+// -----------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include "descriptor.h"
+#include "event_store.h"
+
+namespace sigen
+{
+   void EventStore::reserve(size_t events, size_t desc_bytes)
+   {
+      ids.reserve(events);
+      start_times.reserve(events * UTC::BYTE_LEN);
+      durations.reserve(events * BCDTime::TIME_LEN);
+      flags.reserve(events);
+      desc_end.reserve(events);
+      desc_arena.reserve(desc_bytes);
+   }
+
+   void EventStore::clear()
+   {
+      ids.clear();
+      start_times.clear();
+      durations.clear();
+      flags.clear();
+      desc_end.clear();
+      desc_arena.clear();
+   }
+
+   size_t EventStore::memoryUsage() const
+   {
+      return ids.capacity() * sizeof(ui16) +
+         start_times.capacity() + durations.capacity() + flags.capacity() +
+         desc_end.capacity() * sizeof(ui32) +
+         desc_arena.capacity();
+   }
+
+
+   //
+   // adds an event, keeping the store sorted by start time. The
+   // packed start times compare in time order byte by byte
+   //
+   bool EventStore::addEvent(ui16 ev_id, const UTC &start_time, const BCDTime &duration,
+                             ui8 running_status, bool free_CA_mode)
+   {
+      ui8 st[UTC::BYTE_LEN];
+      start_time.getBytes(st);
+
+      if (!empty() && memcmp(st, getStartTime(size() - 1), UTC::BYTE_LEN) < 0)
+         return false;
+
+      ids.push_back(ev_id);
+      start_times.insert(start_times.end(), st, st + UTC::BYTE_LEN);
+
+      ui8 dur[BCDTime::TIME_LEN];
+      duration.getBCD(dur);
+      durations.insert(durations.end(), dur, dur + BCDTime::TIME_LEN);
+
+      flags.push_back(((running_status & 0x7) << 5) | (free_CA_mode << 4));
+      desc_end.push_back(desc_arena.size());
+      return true;
+   }
+
+   //
+   // bulk load: validates the batch, then appends each array in turn
+   //
+   bool EventStore::addEvents(const EventInfo* events, size_t count)
+   {
+      ui8 last[UTC::BYTE_LEN] = { 0 };
+      if (!empty())
+         memcpy(last, getStartTime(size() - 1), UTC::BYTE_LEN);
+
+      size_t desc_bytes = 0;
+      for (size_t i = 0; i < count; i++) {
+         ui8 st[UTC::BYTE_LEN];
+         events[i].start_time.getBytes(st);
+
+         if (memcmp(st, last, UTC::BYTE_LEN) < 0 || events[i].desc_len > MAX_LOOP_LEN ||
+             !RawDesc::isValidLoop(events[i].desc_data, events[i].desc_len))
+            return false;
+
+         memcpy(last, st, UTC::BYTE_LEN);
+         desc_bytes += events[i].desc_len;
+      }
+
+      // grow geometrically so many small batches stay linear
+      const size_t n = size() + count;
+      if (n > ids.capacity())
+         reserve(std::max(n, 2 * size()),
+                 std::max(desc_arena.size() + desc_bytes, 2 * desc_arena.size()));
+
+      for (size_t i = 0; i < count; i++) {
+         const EventInfo& ev = events[i];
+         ids.push_back(ev.id);
+
+         start_times.resize(start_times.size() + UTC::BYTE_LEN);
+         ev.start_time.getBytes(&start_times[start_times.size() - UTC::BYTE_LEN]);
+         durations.resize(durations.size() + BCDTime::TIME_LEN);
+         ev.duration.getBCD(&durations[durations.size() - BCDTime::TIME_LEN]);
+
+         flags.push_back(((ev.running_status & 0x7) << 5) | (ev.free_CA_mode << 4));
+         desc_arena.insert(desc_arena.end(), ev.desc_data, ev.desc_data + ev.desc_len);
+         desc_end.push_back(desc_arena.size());
+      }
+      return true;
+   }
+
+   bool EventStore::addEventDesc(const Descriptor &desc)
+   {
+      scratch.reset();
+      desc.buildSections(scratch);
+      return addEventDesc(scratch.getBinaryData(), scratch.length());
+   }
+
+   bool EventStore::addEventDesc(const ui8 *data, ui16 len)
+   {
+      if (empty() || getDescLoopLen(size() - 1) + len > MAX_LOOP_LEN ||
+          !RawDesc::isValidLoop(data, len))
+         return false;
+
+      desc_arena.insert(desc_arena.end(), data, data + len);
+      desc_end.back() += len;
+      return true;
+   }
+
+
+   //
+   // writes the event header and descriptor loop as-is
+   //
+   void EventStore::write(size_t i, Section &s) const
+   {
+      const ui16 loop_len = getDescLoopLen(i);
+
+      s.set16Bits(ids[i]);
+      s.setBits(getStartTime(i), UTC::BYTE_LEN);
+      s.setBits(getDuration(i), BCDTime::TIME_LEN);
+      s.set16Bits((flags[i] << 8) | loop_len);
+      s.setBits(getDescData(i), loop_len);
+   }
+
+} // sigen namespace
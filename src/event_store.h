@@ -0,0 +1,155 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// event_store.h: packed, structure of arrays store of EIT events
+// -----------------------------------
+
+#pragma once
+
+#include <vector>
+#include "types.h"
+#include "tstream.h"
+#include "utc.h"
+
+namespace sigen {
+
+   class Descriptor;
+
+   /*!
+    * \brief Compact store of a service's events for large schedules,
+    * sectioned directly by ES_EIT.
+    *
+    * Each field is kept in its own array in the format sent in the
+    * EIT: 2-byte ids, 5-byte start times, 3-byte durations and a byte
+    * for running_status / free_CA_mode, plus the end offset of the
+    * event's descriptors in a shared byte arena. That's 15 bytes per
+    * event, plus the descriptors' own bytes, with no per-event
+    * allocation. Descriptors are serialized when added, so the caller
+    * keeps ownership of (and may reuse) the Descriptor objects.
+    *
+    * Events must be added in start time order.
+    */
+   class EventStore
+   {
+   public:
+      enum { EVENT_BYTES = 15 };   // per event storage, excluding descriptors
+
+      //! \brief An event for addEvents().
+      struct EventInfo {
+         ui16 id;                  //!< Unique id of the event within the service.
+         UTC start_time;           //!< Start time.
+         BCDTime duration;         //!< Duration.
+         ui8 running_status;       //!< See sigen::Dvb::RunningStatus_t.
+         bool free_CA_mode;        //!< One or more components are scrambled.
+         const ui8* desc_data;     //!< Serialized descriptor loop (may be `nullptr`).
+         ui16 desc_len;            //!< Length of the descriptor loop.
+      };
+
+      EventStore() : scratch(MAX_DESC_LEN) { }
+
+      // prohibit
+      EventStore(const EventStore &) = delete;
+      EventStore &operator=(const EventStore &) = delete;
+
+      /*!
+       * \brief Reserve space to load a schedule without reallocating.
+       * \param events Number of events.
+       * \param desc_bytes Total descriptor bytes.
+       */
+      void reserve(size_t events, size_t desc_bytes = 0);
+      //! \brief Remove all events.
+      void clear();
+
+      /*!
+       * \brief Add an event.
+       * \param ev_id Unique id of the event within the service.
+       * \param start_time Start time, not before the last event's.
+       * \param duration Duration of the event.
+       * \param running_status Running status of the event. See sigen::Dvb::RunningStatus_t.
+       * \param free_CA_mode `false`: no event components are scrambled; `true`: one ore more controlled by CA system.
+       * \return `false` if it starts before the last event added.
+       */
+      bool addEvent(ui16 ev_id, const UTC &start_time, const BCDTime &duration,
+                    ui8 running_status, bool free_CA_mode);
+      /*!
+       * \brief Add a batch of events with their descriptors, reserving
+       * the space for them up front.
+       *
+       * The batch is checked first and added entirely or not at all.
+       * \param events Events to add, in start time order.
+       * \param count Number of events.
+       * \return `false` if an event is out of order or a descriptor loop
+       * is malformed or too long.
+       */
+      bool addEvents(const EventInfo* events, size_t count);
+      /*!
+       * \brief Add a Descriptor to the last added event. The descriptor
+       * is copied in its wire format.
+       * \param desc Descriptor to add.
+       */
+      bool addEventDesc(const Descriptor &desc);
+      /*!
+       * \brief Add already serialized descriptor(s) to the last added
+       * event.
+       * \param data Descriptor bytes (tag, length, data).
+       * \param len Number of bytes.
+       */
+      bool addEventDesc(const ui8 *data, ui16 len);
+
+      // accessors
+      size_t size() const { return ids.size(); }
+      bool empty() const { return ids.empty(); }
+      //! \brief Bytes allocated for the store.
+      size_t memoryUsage() const;
+
+      ui16 getId(size_t i) const { return ids[i]; }
+      const ui8 *getStartTime(size_t i) const { return &start_times[i * UTC::BYTE_LEN]; }
+      ui16 getStartMJD(size_t i) const { return (getStartTime(i)[0] << 8) | getStartTime(i)[1]; }
+      ui8 getStartHour(size_t i) const { return BCDTime::fromBCD(getStartTime(i)[2]); }
+      const ui8 *getDuration(size_t i) const { return &durations[i * BCDTime::TIME_LEN]; }
+      ui8 getRunningStatus(size_t i) const { return flags[i] >> 5; }
+      bool getFreeCAMode(size_t i) const { return (flags[i] >> 4) & 0x1; }
+      const ui8 *getDescData(size_t i) const { return desc_arena.data() + descStart(i); }
+      ui16 getDescLoopLen(size_t i) const { return desc_end[i] - descStart(i); }
+
+      //! \brief Event header and descriptor bytes, as written to a section.
+      ui16 length(size_t i) const { return EVENT_HEADER_LEN + getDescLoopLen(i); }
+      //! \brief Write an event to a section (which must have room for it).
+      void write(size_t i, Section &s) const;
+
+   private:
+      enum {
+         EVENT_HEADER_LEN = 12,
+         MAX_DESC_LEN = 257,    // tag, length + 255 bytes
+         MAX_LOOP_LEN = 0x0fff  // 12 bit descriptors_loop_length
+      };
+
+      std::vector<ui16> ids;
+      std::vector<ui8> start_times;  // UTC::BYTE_LEN per event
+      std::vector<ui8> durations;    // BCDTime::TIME_LEN per event
+      std::vector<ui8> flags;        // running_status (3), free_CA_mode (1), 0 (4)
+      std::vector<ui32> desc_end;    // end of each event's descriptors in desc_arena
+      std::vector<ui8> desc_arena;
+
+      Section scratch;               // for serializing descriptors
+
+      ui32 descStart(size_t i) const { return i ? desc_end[i - 1] : 0; }
+   };
+
+} // sigen namespace
@@ -0,0 +1,217 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// file_sink.cc: memory mapped transport stream file output
+// -----------------------------------
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "file_sink.h"
+
+namespace sigen
+{
+   MappedFileSink::MappedFileSink(const std::string &file_name, off_t preallocate,
+                                  size_t win_size) :
+      fd(-1),
+      ok(false),
+      allocated(0),
+      window(nullptr),
+      window_off(0),
+      window_pos(0),
+      syncing(0),
+      stopping(false)
+   {
+      // windows are mapped at page aligned offsets
+      const size_t page = sysconf(_SC_PAGESIZE);
+      window_size = std::max<size_t>(page, (win_size + page - 1) / page * page);
+
+      fd = ::open(file_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) {
+         std::cerr << "MappedFileSink::MappedFileSink(): can't open " << file_name << ": "
+                   << strerror(errno) << ".. writes disabled" << std::endl;
+         return;
+      }
+
+      ok = allocate(std::max<off_t>(preallocate, window_size));
+      if (!ok) {
+         std::cerr << "MappedFileSink::MappedFileSink(): can't allocate " << file_name << ": "
+                   << strerror(errno) << ".. writes disabled" << std::endl;
+         return;
+      }
+      syncer = std::thread(&MappedFileSink::syncLoop, this);
+   }
+
+   MappedFileSink::~MappedFileSink()
+   {
+      close();
+   }
+
+
+   //
+   // sets the file size, reserving the blocks where supported
+   //
+   bool MappedFileSink::allocate(off_t size)
+   {
+#ifdef __linux__
+      if (fallocate(fd, 0, 0, size) == 0) {
+         allocated = size;
+         return true;
+      }
+      if (errno != EOPNOTSUPP)
+         return false;
+#endif
+      // sparse file, blocks allocated on the first write
+      if (ftruncate(fd, size) != 0)
+         return false;
+      allocated = size;
+      return true;
+   }
+
+   bool MappedFileSink::mapWindow()
+   {
+      if (window_off + static_cast<off_t>(window_size) > allocated &&
+          !allocate(window_off + window_size)) {
+         std::cerr << "MappedFileSink::write(): can't grow file: " << strerror(errno)
+                   << ".. writes disabled" << std::endl;
+         return false;
+      }
+
+      void *m = mmap(nullptr, window_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, window_off);
+      if (m == MAP_FAILED) {
+         std::cerr << "MappedFileSink::write(): mmap failed: " << strerror(errno)
+                   << ".. writes disabled" << std::endl;
+         return false;
+      }
+      madvise(m, window_size, MADV_SEQUENTIAL);
+
+      window = static_cast<ui8 *>(m);
+      window_pos = 0;
+      return true;
+   }
+
+   //
+   // hands the current window to the sync thread, waiting if it's behind
+   //
+   void MappedFileSink::retireWindow()
+   {
+      std::unique_lock<std::mutex> lock(mutex);
+      cond.wait(lock, [this] { return pending.size() < MAX_PENDING; });
+      pending.push_back({ window, window_size });
+      cond.notify_all();
+
+      window_off += window_size;
+      window = nullptr;
+      window_pos = 0;
+   }
+
+   void MappedFileSink::syncLoop()
+   {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true) {
+         cond.wait(lock, [this] { return stopping || !pending.empty(); });
+         if (pending.empty())
+            break;
+
+         Window w = pending.front();
+         pending.pop_front();
+         syncing++;
+         cond.notify_all();
+
+         lock.unlock();
+         if (msync(w.addr, w.len, MS_SYNC) != 0)
+            ok = false;
+         munmap(w.addr, w.len);
+         lock.lock();
+
+         syncing--;
+         cond.notify_all();
+      }
+   }
+
+
+   //
+   // copies the packets into the mapping, moving on to the next window
+   // when full - packets may straddle windows
+   //
+   void MappedFileSink::write(const ui8 *packets, size_t count)
+   {
+      size_t len = count * PACKET_SIZE;
+
+      while (len > 0 && ok) {
+         if (!window && !(ok = mapWindow()))
+            return;
+
+         const size_t n = std::min(len, window_size - window_pos);
+         memcpy(window + window_pos, packets, n);
+         window_pos += n;
+         packets += n;
+         len -= n;
+
+         if (window_pos == window_size)
+            retireWindow();
+      }
+   }
+
+   void MappedFileSink::flush()
+   {
+      if (fd < 0)
+         return;
+
+      {
+         std::unique_lock<std::mutex> lock(mutex);
+         cond.wait(lock, [this] { return pending.empty() && syncing == 0; });
+      }
+
+      // the window start is page aligned
+      if (window && window_pos > 0 && msync(window, window_pos, MS_SYNC) != 0)
+         ok = false;
+   }
+
+   bool MappedFileSink::close()
+   {
+      if (fd < 0)
+         return ok;
+
+      const off_t size = bytesWritten();
+      if (window)
+         retireWindow();
+      if (syncer.joinable()) {
+         {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+         }
+         cond.notify_all();
+         syncer.join();
+      }
+
+      // drop the unused preallocation
+      if (ftruncate(fd, size) != 0 || ::close(fd) != 0)
+         ok = false;
+      fd = -1;
+      window_off = size;
+      window_pos = 0;
+      return ok;
+   }
+
+} // sigen namespace
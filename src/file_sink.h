@@ -0,0 +1,115 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// file_sink.h: memory mapped transport stream file output
+// -----------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <sys/types.h>
+#include "sink.h"
+
+namespace sigen {
+
+   /*!
+    * \brief PacketSink writing straight into a memory mapped file.
+    *
+    * The file is preallocated (fallocate) and mapped one window at a
+    * time. Packets are copied into the mapping, and each filled window
+    * is msync'ed and unmapped by a background thread, so long carousel
+    * files are written at memory speed without a system call per
+    * packet. The file is grown a window at a time when the
+    * preallocation runs out, and trimmed to the written size on
+    * close().
+    *
+    * write() must be called from one thread at a time.
+    */
+   class MappedFileSink : public PacketSink
+   {
+   public:
+      enum {
+         DEFAULT_WINDOW = 64 << 20,  //!< Bytes mapped at once.
+         MAX_PENDING = 2             //!< Filled windows waiting for msync.
+      };
+
+      /*!
+       * \brief Constructor - creates (truncates) the file.
+       * \param file_name Output file.
+       * \param preallocate Expected file size in bytes, allocated up front.
+       * \param window_size Bytes mapped at once, rounded up to whole pages.
+       */
+      MappedFileSink(const std::string &file_name, off_t preallocate = 0,
+                     size_t window_size = DEFAULT_WINDOW);
+      ~MappedFileSink();
+
+      // prohibit
+      MappedFileSink(const MappedFileSink &) = delete;
+      MappedFileSink &operator=(const MappedFileSink &) = delete;
+
+      void write(const ui8 *packets, size_t count);
+      //! \brief Waits until all written packets are synced to the file.
+      void flush();
+
+      /*!
+       * \brief Syncs and unmaps everything, truncates the file to the
+       * bytes written and closes it. Called by the destructor.
+       * \return `false` if any write to the file failed.
+       */
+      bool close();
+
+      //! \brief `false` if the file couldn't be opened, grown or mapped.
+      bool good() const { return ok; }
+      //! \brief Bytes written so far.
+      off_t bytesWritten() const { return window_off + window_pos; }
+
+   private:
+      struct Window {
+         ui8 *addr;
+         size_t len;
+      };
+
+      int fd;
+      std::atomic<bool> ok;
+      size_t window_size;
+      off_t allocated;     // file size
+      ui8 *window;         // current mapping, or nullptr
+      off_t window_off;    // file offset of the current window
+      size_t window_pos;   // bytes written into it
+
+      // windows being synced in the background
+      std::thread syncer;
+      std::mutex mutex;
+      std::condition_variable cond;
+      std::deque<Window> pending;
+      size_t syncing;
+      bool stopping;
+
+      bool allocate(off_t size);
+      bool mapWindow();
+      void retireWindow();
+      void syncLoop();
+   };
+
+} // sigen namespace
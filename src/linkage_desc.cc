@@ -75,10 +75,7 @@ namespace sigen {
    {
       Descriptor::buildSections(s);
 
-      s.set16Bits(xport_stream_id);
-      s.set16Bits(original_network_id);
-      s.set16Bits(service_id);
-      s.set08Bits(linkage_type);
+      Layout::write( s, xport_stream_id, original_network_id, service_id, linkage_type );
 
       s.setBits( private_data );
    }
@@ -126,9 +123,7 @@ namespace sigen {
    {
       LinkageDesc::buildSections(s);
 
-      s.set08Bits( hand_over_type << 4 |
-                   rbits(0x7) << 1 |
-                   origin_type );
+      HandOverLayout::write( s, hand_over_type, origin_type );
 
       if (hand_over_type != MobileHandoverLinkageDesc::HO_RESERVED)
          s.set16Bits( network_id );
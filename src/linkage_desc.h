@@ -46,6 +46,11 @@ namespace sigen {
    public:
       enum { TAG = 0x4a };
 
+      //! \brief Layout of the fixed fields, followed by the private data.
+      struct Layout : BitLayout<Field<16>, Field<16>, Field<16>, Field<8>> {
+         enum { TRANSPORT_STREAM_ID, ORIGINAL_NETWORK_ID, SERVICE_ID, LINKAGE_TYPE };
+      };
+
       /*!
        * \enum  Linkage_t
        *
@@ -127,6 +132,11 @@ namespace sigen {
    class MobileHandoverLinkageDesc : public LinkageDesc
    {
    public:
+      //! \brief Layout of the first field after LinkageDesc::Layout.
+      struct HandOverLayout : BitLayout<Field<4>, Reserved<3>, Field<1>> {
+         enum { HAND_OVER_TYPE, ORIGIN_TYPE };
+      };
+
       /*!
        * \enum  Handover_t
        *
@@ -0,0 +1,96 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// live_time.cc: in place time updates for the TDT / TOT
+// -----------------------------------
+
+#include "descriptor.h"
+#include "live_time.h"
+#include "packetizer.h"
+#include "tdt.h"
+#include "tot.h"
+#include "tstream.h"
+#include "utc.h"
+
+namespace sigen
+{
+   LiveTimeTable::LiveTimeTable(const TDT &tdt, ui8 cont_count)
+   {
+      build(tdt, cont_count);
+   }
+
+   LiveTimeTable::LiveTimeTable(const TOT &tot, ui8 cont_count)
+   {
+      build(tot, cont_count);
+   }
+
+   LiveTimeTable::~LiveTimeTable() = default;
+
+   //
+   // builds the single section in place
+   //
+   void LiveTimeTable::build(const STable &table, ui8 cont_count)
+   {
+      table.buildSection(section);
+
+      MpgPacketizer packetizer(cont_count);
+      packetizer.packetize(section, TDT::PID, packets);
+      continuity_count = cont_count;
+   }
+
+   //
+   // patches the utc (and crc) bytes
+   //
+   void LiveTimeTable::setUTC(const UTC &utc)
+   {
+      ui8 buf[UTC::BYTE_LEN];
+      utc.getBytes(buf);
+
+      section.patch(UTC_POS, buf, UTC::BYTE_LEN);
+      copyToPackets(UTC_POS, UTC::BYTE_LEN);
+
+      if (section.hasCRC())
+         copyToPackets(section.length() - Section::CRC_LEN, Section::CRC_LEN);
+   }
+
+   //
+   // stamps the continuity counters for this emission
+   //
+   const std::vector<ui8> &LiveTimeTable::nextPackets()
+   {
+      for (size_t i = 3; i < packets.size(); i += MpgPacketizer::PACKET_SIZE)
+         packets[i] = (packets[i] & 0xf0) | (continuity_count++ & 0x0f);
+      return packets;
+   }
+
+   //
+   // copies section bytes to the packets holding them - the first
+   // packet's payload starts with the pointer field
+   //
+   void LiveTimeTable::copyToPackets(ui16 idx, ui16 len)
+   {
+      const ui8 *data = section.getBinaryData();
+
+      for (ui16 i = idx; i < idx + len; i++) {
+         size_t p = i + 1;
+         packets[ (p / MpgPacketizer::PKT_DATA_SIZE) * MpgPacketizer::PACKET_SIZE +
+                  MpgPacketizer::HEADER_SIZE + p % MpgPacketizer::PKT_DATA_SIZE ] = data[i];
+      }
+   }
+} // namespace
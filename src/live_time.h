@@ -0,0 +1,101 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// live_time.h: in place time updates for the TDT / TOT
+// -----------------------------------
+
+#pragma once
+
+#include <vector>
+#include "tot.h"
+#include "tstream.h"
+#include "types.h"
+
+namespace sigen
+{
+   class STable;
+   class TDT;
+   class UTC;
+
+   /*! \addtogroup table
+    *  @{
+    */
+
+   /*! \addtogroup DVB
+    *  @{
+    */
+
+   /*!
+    * \brief Live time mode for the TDT and TOT.
+    *
+    * The table is built and packetized once; each tick only patches the
+    * 5 UTC bytes in the section and its packets. For the TOT the CRC is
+    * updated from the changed bytes, so the local time offset loop is
+    * never rebuilt or rescanned.
+    */
+   class LiveTimeTable
+   {
+   public:
+      /*!
+       * \brief Constructor from a TDT.
+       * \param tdt Table to build the section from.
+       * \param cont_count Initial packet continuity counter.
+       */
+      LiveTimeTable(const TDT &tdt, ui8 cont_count = 0);
+      /*!
+       * \brief Constructor from a TOT.
+       * \param tot Table to build the section from.
+       * \param cont_count Initial packet continuity counter.
+       */
+      LiveTimeTable(const TOT &tot, ui8 cont_count = 0);
+      ~LiveTimeTable();
+
+      // prohibit
+      LiveTimeTable(const LiveTimeTable &) = delete;
+      LiveTimeTable &operator=(const LiveTimeTable &) = delete;
+
+      /*!
+       * \brief Set the time carried in the section and packets.
+       * \param utc New UTC time.
+       */
+      void setUTC(const UTC &utc);
+
+      /*!
+       * \brief Returns the TS packets for the next transmission.
+       *
+       * Advances the continuity counters, so call once per emission.
+       */
+      const std::vector<ui8> &nextPackets();
+
+      // accessors
+      const Section &getSection() const { return section; }
+
+   private:
+      enum { UTC_POS = 3 };
+
+      InlineSection<TOT::MAX_SEC_LEN> section;
+      std::vector<ui8> packets;
+      ui8 continuity_count;
+
+      void build(const STable &table, ui8 cont_count);
+      void copyToPackets(ui16 idx, ui16 len);
+   };
+   //! @}
+   //! @}
+} // namespace
@@ -38,11 +38,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set08Bits( (free_format_flag << 7) |
-                   (id << 6) |
-                   (layer << 4) |
-                   (variable_rate_indicator << 3) |
-                   rbits(0x7) );
+      Layout::write( s, free_format_flag, id, layer, variable_rate_indicator );
    }
 
 
@@ -73,8 +69,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set16Bits( CA_system_id );
-      s.set16Bits( rbits(0xe000) | CA_pid );
+      Layout::write( s, CA_system_id, CA_pid );
 
       s.setBits( private_data );
    }
@@ -102,7 +97,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set32Bits( identifier );
+      Layout::write( s, identifier );
       s.setBits( info );
    }
 
@@ -129,10 +124,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set08Bits( rbits(0xf0) | type );
-      s.set08Bits( rbits(0xc0) | layer_index );
-      s.set08Bits( rbits(0xc0) | embedded_layer );
-      s.set08Bits( rbits(0xc0) | priority );
+      Layout::write( s, type, layer_index, embedded_layer, priority );
    }
 
 
@@ -163,9 +155,7 @@ namespace sigen
    {
       Descriptor::buildSections( s );
 
-      s.set16Bits( (closed_gop_flag << 15) |
-                   (identical_gop_flag << 14) |
-                   max_gop_len );
+      Layout::write( s, closed_gop_flag, identical_gop_flag, max_gop_len );
    }
 
 #ifdef ENABLE_DUMP
@@ -221,12 +211,12 @@ namespace sigen
    {
       dumpHeader(o, ISO_639_LANG_D_S);
 
-      incOutLevel();
+      incOutLevel(o);
       for (const auto& lang : language_list) {
          identStr(o, LANGUAGE_CODE_S, lang.code);
          identStr(o, AUDIO_TYPE_S, lang.audio_type);
       }
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -240,7 +230,7 @@ namespace sigen
    void MaximumBitrateDesc::buildSections(Section &s) const
    {
       Descriptor::buildSections(s);
-      s.set24Bits( (rbits(0x03) << 22) | maximum_bitrate );
+      Layout::write( s, maximum_bitrate );
    }
 
 
@@ -268,10 +258,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set16Bits( (bound_valid_flag << 15) |
-                   LTW_offset_lb );
-      s.set16Bits( rbits(0x8000) |
-                   LTW_offset_ub );
+      Layout::write( s, bound_valid_flag, LTW_offset_lb, LTW_offset_ub );
    }
 
 
@@ -297,7 +284,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set32Bits( identifier );
+      Layout::write( s, identifier );
       s.setBits( info );
    }
 
@@ -323,8 +310,7 @@ namespace sigen
    {
       Descriptor::buildSections( s );
 
-      s.set24Bits( (rbits(0xc0) << 16) | sb_leak_rate );
-      s.set24Bits( (rbits(0xc0) << 16) | sb_size );
+      Layout::write( s, sb_leak_rate, sb_size );
    }
 
 #ifdef ENABLE_DUMP
@@ -349,7 +335,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set08Bits( rbits(0xe) | leak_valid_flag );
+      Layout::write( s, leak_valid_flag );
    }
 
 
@@ -378,11 +364,8 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set08Bits( (external_clock_reference_indicator << 7) |
-                   rbits(0x70) |
-                   clock_accuracy_integer );
-      s.set08Bits( (clock_accuracy_exponent << 5) |
-                   rbits(0x01f) );
+      Layout::write( s, external_clock_reference_indicator,
+                     clock_accuracy_integer, clock_accuracy_exponent );
    }
 
 
@@ -413,9 +396,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set32Bits( (horizontal_size << 18) |
-                   (vertical_size << 4) |
-                   pel_aspect_ratio );
+      Layout::write( s, horizontal_size, vertical_size, pel_aspect_ratio );
    }
 
 
@@ -444,18 +425,12 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set08Bits( (multiple_frame_rate_flag << 7) |
-                   (frame_rate_code << 3) |
-                   (MPEG_1_only_flag << 2) |
-                   (constrained_parameter_flag << 1) |
-                   (still_picture_flag) );
+      Layout::write( s, multiple_frame_rate_flag, frame_rate_code, MPEG_1_only_flag,
+                     constrained_parameter_flag, still_picture_flag );
 
-      if (!MPEG_1_only_flag) {
-         s.set08Bits( profile_and_level_indication );
-         s.set08Bits( (chroma_format << 6) |
-                      (frame_rate_extension_flag << 5) |
-                      rbits(0x1f) );
-      }
+      if (!MPEG_1_only_flag)
+         Mpeg2Layout::write( s, profile_and_level_indication, chroma_format,
+                             frame_rate_extension_flag );
    }
 
 
@@ -492,9 +467,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set32Bits( (horizontal_offset << 18) |
-                   (vertical_offset << 4) |
-                   window_priority );
+      Layout::write( s, horizontal_offset, vertical_offset, window_priority );
    }
 
 
@@ -47,6 +47,11 @@ namespace sigen {
    public:
       enum { TAG = 3 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Field<1>, Field<1>, Field<2>, Field<1>, Reserved<3>> {
+         enum { FREE_FORMAT_FLAG, ID, LAYER, VARIABLE_RATE_INDICATOR };
+      };
+
       /*!
        * \brief Constructor.
        * \param free_fmt_f Free format flag.
@@ -81,6 +86,11 @@ namespace sigen {
    public:
       enum { TAG = 9 };
 
+      //! \brief Layout of the fixed fields, followed by the private data.
+      struct Layout : BitLayout<Field<16>, Reserved<3>, Field<13>> {
+         enum { CA_SYSTEM_ID, CA_PID };
+      };
+
       /*!
        * \brief Constructor.
        * \param casid CA System ID.
@@ -115,6 +125,11 @@ namespace sigen {
    public:
       enum { TAG = 13 };
 
+      //! \brief Layout of the fixed fields, followed by the info.
+      struct Layout : BitLayout<Field<32>> {
+         enum { IDENTIFIER };
+      };
+
       /*!
        * \brief Constructor.
        * \param cr_identifier Identifier from the Registration Authority.
@@ -177,6 +192,12 @@ namespace sigen {
    public:
       enum { TAG = 4 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Reserved<4>, Field<4>, Reserved<2>, Field<6>,
+                                Reserved<2>, Field<6>, Reserved<2>, Field<6>> {
+         enum { TYPE, LAYER_INDEX, EMBEDDED_LAYER, PRIORITY };
+      };
+
       enum HierarcyType {
          SPATIAL_SCALABILITY = 1,
          SNR_SCALABILITY,
@@ -224,6 +245,11 @@ namespace sigen {
    public:
       enum { TAG = 18 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Field<1>, Field<1>, Field<14>> {
+         enum { CLOSED_GOP_FLAG, IDENTICAL_GOP_FLAG, MAX_GOP_LEN };
+      };
+
       /*!
        * \brief Constructor.
        * \param closed_gop_f Closed gop flag.
@@ -305,6 +331,11 @@ namespace sigen {
    public:
       enum { TAG = 14 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Reserved<2>, Field<22>> {
+         enum { MAXIMUM_BITRATE };
+      };
+
       /*!
        * \brief Constructor.
        * \param max_br Maximum bitrate that will be encountered on thir program or service.
@@ -333,6 +364,11 @@ namespace sigen {
    {
    public:
       enum { TAG = 12 };
+
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Field<1>, Field<15>, Reserved<1>, Field<15>> {
+         enum { BOUND_VALID_FLAG, LTW_OFFSET_LB, LTW_OFFSET_UB };
+      };
       enum Strategy_t { EARLY = 1, LATE, MIDDLE };
 
       /*!
@@ -388,6 +424,11 @@ namespace sigen {
    public:
       enum { TAG = 5 };
 
+      //! \brief Layout of the fixed fields, followed by the info.
+      struct Layout : BitLayout<Field<32>> {
+         enum { IDENTIFIER };
+      };
+
       /*!
        * \brief Constructor.
        * \param format_ident Format identifier as per ISO/IEC JTC 1/SC 29.
@@ -418,6 +459,11 @@ namespace sigen {
    public:
       enum { TAG = 16 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Reserved<2>, Field<22>, Reserved<2>, Field<22>> {
+         enum { SB_LEAK_RATE, SB_SIZE };
+      };
+
       /*!
        * \brief Constructor.
        * \param sb_lk_rate Smoothing buffer leak rate.
@@ -448,6 +494,11 @@ namespace sigen {
    public:
       enum { TAG = 17 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Reserved<7>, Field<1>> {
+         enum { LEAK_VALID_FLAG };
+      };
+
       /*!
        * \brief Constructor.
        * \param lvf Leak-valid flag.
@@ -477,6 +528,11 @@ namespace sigen {
    public:
       enum { TAG = 11 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Field<1>, Reserved<1>, Field<6>, Field<3>, Reserved<5>> {
+         enum { EXTERNAL_CLOCK_REFERENCE_INDICATOR, CLOCK_ACCURACY_INTEGER, CLOCK_ACCURACY_EXPONENT };
+      };
+
       /*!
        * \brief Constructor.
        * \param ext_clk_ref_indic `true`: System clock is derived from external frequency reference.
@@ -511,6 +567,11 @@ namespace sigen {
    public:
       enum { TAG = 7 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Field<14>, Field<14>, Field<4>> {
+         enum { HORIZONTAL_SIZE, VERTICAL_SIZE, PEL_ASPECT_RATIO };
+      };
+
       /*!
        * \brief Constructor.
        * \param horiz_size Horizontal size of background grid in pixels.
@@ -543,6 +604,16 @@ namespace sigen {
    public:
       enum { TAG = 2 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Field<1>, Field<4>, Field<1>, Field<1>, Field<1>> {
+         enum { MULTIPLE_FRAME_RATE_FLAG, FRAME_RATE_CODE, MPEG_1_ONLY_FLAG, CONSTRAINED_PARAMETER_FLAG, STILL_PICTURE_FLAG };
+      };
+
+      //! \brief Layout of the fields following Layout when MPEG_1_ONLY_FLAG is 0.
+      struct Mpeg2Layout : BitLayout<Field<8>, Field<2>, Field<1>, Reserved<5>> {
+         enum { PROFILE_AND_LEVEL_INDICATION, CHROMA_FORMAT, FRAME_RATE_EXTENSION_FLAG };
+      };
+
       /*!
        * \brief Constructor for descriptors where MPEG_1_only_flag must be set to `1`.
        * \param mult_frame_rate_f Multiple frame rate flag.
@@ -609,6 +680,11 @@ namespace sigen {
    public:
       enum { TAG = 8 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Field<14>, Field<14>, Field<4>> {
+         enum { HORIZONTAL_OFFSET, VERTICAL_OFFSET, WINDOW_PRIORITY };
+      };
+
       /*!
        * \brief Constructor.
        * \param horiz_offset Horizontal position of the display top-left.
@@ -0,0 +1,833 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// multiplex.cc: transport stream SI model owning and versioning its tables
+// -----------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "descriptor.h"
+#include "dvb_desc.h"
+#include "eit.h"
+#include "eit_desc.h"
+#include "multiplex.h"
+#include "nit_bat.h"
+#include "nit_desc.h"
+#include "pat.h"
+#include "pmt.h"
+#include "published_table.h"
+#include "sdt.h"
+#include "sdt_desc.h"
+#include "tstream.h"
+
+namespace sigen
+{
+   namespace multiplex_priv {
+      enum { MIN_PID = 0x20, MAX_PID = 0x1ffe, NULL_PID = 0x1fff };
+
+      bool validPid(ui16 pid) { return pid >= MIN_PID && pid <= MAX_PID; }
+
+      //
+      // snapshot format
+      //
+      const char MAGIC[4] = { 'S', 'G', 'M', 'X' };
+      enum {
+         FORMAT_VERSION = 1,
+         HEADER_LEN = 16,
+         RECORD_HEADER_LEN = 8,
+         ALIGN = 4
+      };
+      enum Record {
+         MUX_R = 1,       // ids, network name - always first
+         SERVICE_R,       // service and its elementary streams
+         EVENT_R,         // present / following event
+         BOUQUET_R,       // bouquet and its services
+         TABLE_R,         // published sub-table and its sections
+         DIRTY_R,         // sub-tables with pending changes
+         END_R = 0xffff   // complete file
+      };
+
+      // big endian serializer
+      class Writer
+      {
+      public:
+         std::vector<ui8> buf;
+
+         void put8(ui8 v) { buf.push_back(v); }
+         void put16(ui16 v) { put8(v >> 8); put8(v & 0xff); }
+         void put32(ui32 v) { put16(v >> 16); put16(v & 0xffff); }
+         void put(const ui8 *d, size_t len) { buf.insert(buf.end(), d, d + len); }
+         void put(const std::string &str) {
+            put16(str.size());
+            put(reinterpret_cast<const ui8 *>(str.data()), str.size());
+         }
+         void set32(size_t at, ui32 v) {
+            buf[at] = v >> 24; buf[at + 1] = v >> 16; buf[at + 2] = v >> 8; buf[at + 3] = v;
+         }
+
+         // records are closed by the next begin() or end()
+         void begin(Record r) {
+            close();
+            rec = buf.size();
+            put16(r);
+            put16(0);
+            put32(0);
+            count++;
+         }
+         void end() {
+            begin(END_R);
+            close();
+            set32(8, buf.size());
+            set32(12, count);
+         }
+
+      private:
+         size_t rec = 0;
+         ui32 count = 0;
+
+         void close() {
+            if (!rec)
+               return;
+            set32(rec + 4, buf.size() - rec - RECORD_HEADER_LEN);
+            while (buf.size() % ALIGN)
+               put8(0);
+         }
+      };
+
+      // bounds checked big endian reader over a mapped file
+      class Reader
+      {
+      public:
+         Reader(const ui8 *d, size_t len) : p(d), end(d + len), ok(true) {}
+
+         bool good() const { return ok; }
+         bool atEnd() const { return p >= end; }
+         size_t left() const { return end - p; }
+
+         ui8 get8() { return have(1) ? *p++ : 0; }
+         ui16 get16() { ui16 v = get8() << 8; return v | get8(); }
+         ui32 get32() { ui32 v = get16() << 16; return v | get16(); }
+         const ui8 *get(size_t len) {
+            if (!have(len))
+               return nullptr;
+            const ui8 *d = p;
+            p += len;
+            return d;
+         }
+         std::string getStr() {
+            const ui16 len = get16();
+            const ui8 *d = get(len);
+            return d ? std::string(reinterpret_cast<const char *>(d), len) : std::string();
+         }
+
+      private:
+         const ui8 *p, *end;
+         bool ok;
+
+         bool have(size_t len) {
+            if (static_cast<size_t>(end - p) < len)
+               ok = false;
+            return ok;
+         }
+      };
+
+      void putEvent(Writer &w, ui16 sid, ui8 slot, const Multiplex::Event &ev)
+      {
+         ui8 time[UTC::BYTE_LEN + BCDTime::TIME_LEN];
+         ev.start_time.getBytes(time);
+         ev.duration.getBCD(time + UTC::BYTE_LEN);
+
+         w.begin(EVENT_R);
+         w.put16(sid);
+         w.put8(slot);
+         w.put16(ev.id);
+         w.put(time, sizeof(time));
+         w.put8(ev.running_status);
+         w.put8(ev.free_CA_mode);
+         w.put(ev.language);
+         w.put(ev.name);
+         w.put(ev.text);
+      }
+
+      // read-only mapping of a file, unmapped when done
+      class MappedFile
+      {
+      public:
+         explicit MappedFile(const std::string &file_name) : data(nullptr), len(0) {
+            int fd = ::open(file_name.c_str(), O_RDONLY);
+            if (fd < 0)
+               return;
+
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0) {
+               void *m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+               if (m != MAP_FAILED) {
+                  data = static_cast<const ui8 *>(m);
+                  len = st.st_size;
+               }
+            }
+            ::close(fd);
+         }
+         ~MappedFile() {
+            if (data)
+               munmap(const_cast<ui8 *>(data), len);
+         }
+
+         const ui8 *data;
+         size_t len;
+      };
+   }
+
+   using namespace multiplex_priv;
+
+   Multiplex::Multiplex(ui16 nid, ui16 xsid, ui16 onid)
+      : network_id(nid), xs_id(xsid), on_id(onid)
+   {
+      dirty.insert(key(PAT_ST, 0));
+      dirty.insert(key(SDT_ST, 0));
+      dirty.insert(key(NIT_ST, 0));
+   }
+
+   Multiplex::~Multiplex()
+   {
+   }
+
+
+   //
+   // model changes - each marks the sub-tables it affects
+   //
+   void Multiplex::setNetworkName(const std::string &name)
+   {
+      network_name = name;
+      dirty.insert(key(NIT_ST, 0));
+   }
+
+   bool Multiplex::addService(ui16 sid, ui16 pmt_pid, ui16 pcr_pid, ui8 type,
+                              const std::string &provider, const std::string &name)
+   {
+      // program_number 0 is the PAT's network pid entry
+      if (sid == 0 || services.count(sid) ||
+          !validPid(pmt_pid) || !(validPid(pcr_pid) || pcr_pid == NULL_PID))
+         return false;
+
+      Service &s = services[sid];
+      s.pmt_pid = pmt_pid;
+      s.pcr_pid = pcr_pid;
+      s.type = type;
+      s.running_status = Dvb::RUNNING_RS;
+      s.free_CA_mode = false;
+      s.provider = provider;
+      s.name = name;
+
+      dirty.insert(key(PMT_ST, sid));
+      serviceListChanged(sid);
+      return true;
+   }
+
+   bool Multiplex::removeService(ui16 sid)
+   {
+      if (!services.count(sid))
+         return false;
+
+      serviceListChanged(sid);
+      for (auto &b : bouquets) {
+         b.second.services.erase(sid);
+      }
+      services.erase(sid);
+
+      // rebuild() drops them
+      dirty.insert(key(PMT_ST, sid));
+      dirty.insert(key(PF_EIT_ST, sid));
+      return true;
+   }
+
+   bool Multiplex::addElemStream(ui16 sid, ui8 type, ui16 elem_pid)
+   {
+      auto it = services.find(sid);
+      if (it == services.end() || !validPid(elem_pid))
+         return false;
+
+      it->second.streams.emplace_back(type, elem_pid);
+      dirty.insert(key(PMT_ST, sid));
+      return true;
+   }
+
+   bool Multiplex::setServiceName(ui16 sid, const std::string &provider, const std::string &name)
+   {
+      auto it = services.find(sid);
+      if (it == services.end())
+         return false;
+
+      it->second.provider = provider;
+      it->second.name = name;
+      dirty.insert(key(SDT_ST, 0));
+      return true;
+   }
+
+   bool Multiplex::setServiceStatus(ui16 sid, ui8 running_status, bool free_CA_mode)
+   {
+      auto it = services.find(sid);
+      if (it == services.end())
+         return false;
+
+      it->second.running_status = running_status;
+      it->second.free_CA_mode = free_CA_mode;
+      dirty.insert(key(SDT_ST, 0));
+      return true;
+   }
+
+   bool Multiplex::setPresentFollowing(ui16 sid, const Event *present, const Event *following)
+   {
+      auto it = services.find(sid);
+      if (it == services.end())
+         return false;
+
+      Service &s = it->second;
+      const bool had_pf = s.present || s.following;
+
+      s.present.reset(present ? new Event(*present) : nullptr);
+      s.following.reset(following ? new Event(*following) : nullptr);
+      dirty.insert(key(PF_EIT_ST, sid));
+
+      // the SDT's EIT_present_following_flag
+      if (had_pf != (present || following))
+         dirty.insert(key(SDT_ST, 0));
+      return true;
+   }
+
+   bool Multiplex::addBouquet(ui16 bouquet_id, const std::string &name)
+   {
+      if (bouquets.count(bouquet_id))
+         return false;
+
+      bouquets[bouquet_id].name = name;
+      dirty.insert(key(BAT_ST, bouquet_id));
+      return true;
+   }
+
+   bool Multiplex::addBouquetService(ui16 bouquet_id, ui16 sid)
+   {
+      auto it = bouquets.find(bouquet_id);
+      if (it == bouquets.end() || !services.count(sid))
+         return false;
+
+      if (it->second.services.insert(sid).second)
+         dirty.insert(key(BAT_ST, bouquet_id));
+      return true;
+   }
+
+   void Multiplex::serviceListChanged(ui16 sid)
+   {
+      dirty.insert(key(PAT_ST, 0));
+      dirty.insert(key(SDT_ST, 0));
+      dirty.insert(key(NIT_ST, 0));
+      for (const auto &b : bouquets) {
+         if (b.second.services.count(sid))
+            dirty.insert(key(BAT_ST, b.first));
+      }
+   }
+
+
+   //
+   // rebuilds the dirty sub-tables, each on whichever thread gets to
+   // it first. The model is only read here so needs no locking.
+   //
+   size_t Multiplex::rebuild(unsigned threads)
+   {
+      struct Job {
+         Key k;
+         std::shared_ptr<PublishedTable> table;
+         bool built;
+      };
+
+      std::vector<Job> jobs;
+      jobs.reserve(dirty.size());
+      for (Key k : dirty) {
+         auto it = published.find(k);
+         jobs.push_back({ k, (it != published.end()) ? it->second.table
+                                                     : std::make_shared<PublishedTable>(),
+                          false });
+      }
+
+      if (threads == 0)
+         threads = std::max(1u, std::thread::hardware_concurrency());
+      if (threads > jobs.size())
+         threads = jobs.size();
+
+      std::atomic<size_t> next(0);
+      auto work = [&]() {
+         for (size_t i = next++; i < jobs.size(); i = next++) {
+            jobs[i].built = build(jobs[i].k, *jobs[i].table);
+         }
+      };
+
+      std::vector<std::thread> pool;
+      for (unsigned i = 1; i < threads; i++) {
+         pool.emplace_back(work);
+      }
+      work();
+      for (std::thread &t : pool) {
+         t.join();
+      }
+
+      // publish the new sub-tables, drop the removed ones
+      size_t count = 0;
+      for (Job &j : jobs) {
+         if (!j.built) {
+            published.erase(j.k);
+            continue;
+         }
+
+         SubTable type = static_cast<SubTable>(j.k >> 16);
+         ui16 id = j.k & 0xffff;
+         ui16 pid = PAT::PID;
+         switch (type)
+         {
+           case PAT_ST:    pid = PAT::PID; break;
+           case PMT_ST:    pid = services[id].pmt_pid; break;
+           case SDT_ST:    pid = SDT::PID; break;
+           case NIT_ST:    pid = NIT::PID; break;
+           case BAT_ST:    pid = BAT::PID; break;
+           case PF_EIT_ST: pid = EIT::PID; break;
+         }
+         published[j.k] = { type, id, pid, j.table };
+         count++;
+      }
+      dirty.clear();
+      return count;
+   }
+
+   bool Multiplex::build(Key k, PublishedTable &pt) const
+   {
+      const ui16 id = k & 0xffff;
+
+      switch (static_cast<SubTable>(k >> 16))
+      {
+        case PAT_ST:
+        {
+           PAT pat(xs_id, 0);
+           pat.addNetworkPid(NIT::PID);
+           for (const auto &s : services) {
+              pat.addProgram(s.first, s.second.pmt_pid);
+           }
+           pt.publish(pat);
+           return true;
+        }
+
+        case PMT_ST:
+        {
+           auto it = services.find(id);
+           if (it == services.end())
+              return false;
+
+           PMT pmt(id, it->second.pcr_pid, 0);
+           for (const auto &es : it->second.streams) {
+              pmt.addElemStream(es.first, es.second);
+           }
+           pt.publish(pmt);
+           return true;
+        }
+
+        case SDT_ST:
+        {
+           SDTActual sdt(xs_id, on_id, 0);
+           for (const auto &s : services) {
+              const Service &serv = s.second;
+              sdt.addService(s.first, false, serv.present || serv.following,
+                             serv.running_status, serv.free_CA_mode);
+              sdt.addServiceDesc( *new ServiceDesc(serv.type, serv.provider, serv.name) );
+           }
+           pt.publish(sdt);
+           return true;
+        }
+
+        case NIT_ST:
+        {
+           NITActual nit(network_id, 0);
+           if (!network_name.empty())
+              nit.addNetworkDesc( *new NetworkNameDesc(network_name) );
+
+           nit.addXportStream(xs_id, on_id);
+           if (!services.empty()) {
+              ServiceListDesc *sld = new ServiceListDesc;
+              for (const auto &s : services) {
+                 sld->addService(s.first, s.second.type);
+              }
+              nit.addXportStreamDesc(xs_id, *sld);
+           }
+           pt.publish(nit);
+           return true;
+        }
+
+        case BAT_ST:
+        {
+           auto it = bouquets.find(id);
+           if (it == bouquets.end())
+              return false;
+
+           BAT bat(id, 0);
+           bat.addBouquetDesc( *new BouquetNameDesc(it->second.name) );
+           if (!it->second.services.empty()) {
+              bat.addXportStream(xs_id, on_id);
+              ServiceListDesc *sld = new ServiceListDesc;
+              for (ui16 sid : it->second.services) {
+                 sld->addService(sid, services.at(sid).type);
+              }
+              bat.addXportStreamDesc(xs_id, *sld);
+           }
+           pt.publish(bat);
+           return true;
+        }
+
+        case PF_EIT_ST:
+        {
+           auto it = services.find(id);
+           if (it == services.end() || !(it->second.present || it->second.following))
+              return false;
+
+           PF_EITActual eit(id, xs_id, on_id, 0);
+           const Event *ev = it->second.present.get();
+           if (ev) {
+              eit.addPresentEvent(ev->id, ev->start_time, ev->duration,
+                                  ev->running_status, ev->free_CA_mode);
+              if (!ev->name.empty())
+                 eit.addPresentEventDesc( *new ShortEventDesc(ev->language, ev->name, ev->text) );
+           }
+           ev = it->second.following.get();
+           if (ev) {
+              eit.addFollowingEvent(ev->id, ev->start_time, ev->duration,
+                                    ev->running_status, ev->free_CA_mode);
+              if (!ev->name.empty())
+                 eit.addFollowingEventDesc( *new ShortEventDesc(ev->language, ev->name, ev->text) );
+           }
+           pt.publish(eit);
+           return true;
+        }
+      }
+      return false;
+   }
+
+
+   //
+   // sub-tables the model has that weren't in a snapshot
+   //
+   void Multiplex::markUnpublished()
+   {
+      std::vector<Key> keys = { key(PAT_ST, 0), key(SDT_ST, 0), key(NIT_ST, 0) };
+      for (const auto &s : services) {
+         keys.push_back(key(PMT_ST, s.first));
+         if (s.second.present || s.second.following)
+            keys.push_back(key(PF_EIT_ST, s.first));
+      }
+      for (const auto &b : bouquets) {
+         keys.push_back(key(BAT_ST, b.first));
+      }
+
+      for (Key k : keys) {
+         if (!published.count(k))
+            dirty.insert(k);
+      }
+   }
+
+
+   //
+   // snapshots
+   //
+   bool Multiplex::saveSnapshot(const std::string &file_name) const
+   {
+      Writer w;
+      w.put(reinterpret_cast<const ui8 *>(MAGIC), sizeof(MAGIC));
+      w.put16(FORMAT_VERSION);
+      w.put16(0);
+      w.put32(0); // file length
+      w.put32(0); // record count
+
+      w.begin(MUX_R);
+      w.put16(network_id);
+      w.put16(xs_id);
+      w.put16(on_id);
+      w.put(network_name);
+
+      for (const auto &s : services) {
+         const Service &serv = s.second;
+         w.begin(SERVICE_R);
+         w.put16(s.first);
+         w.put16(serv.pmt_pid);
+         w.put16(serv.pcr_pid);
+         w.put8(serv.type);
+         w.put8(serv.running_status);
+         w.put8(serv.free_CA_mode);
+         w.put(serv.provider);
+         w.put(serv.name);
+         w.put16(serv.streams.size());
+         for (const auto &es : serv.streams) {
+            w.put8(es.first);
+            w.put16(es.second);
+         }
+
+         if (serv.present)
+            putEvent(w, s.first, 0, *serv.present);
+         if (serv.following)
+            putEvent(w, s.first, 1, *serv.following);
+      }
+
+      for (const auto &b : bouquets) {
+         w.begin(BOUQUET_R);
+         w.put16(b.first);
+         w.put(b.second.name);
+         w.put16(b.second.services.size());
+         for (ui16 sid : b.second.services) {
+            w.put16(sid);
+         }
+      }
+
+      for (const auto &p : published) {
+         PublishedTable::Snapshot snap = p.second.table->acquire();
+         if (!snap.valid())
+            continue;
+
+         const TStream &ts = snap.stream();
+         w.begin(TABLE_R);
+         w.put8(p.second.type);
+         w.put16(p.second.id);
+         w.put16(p.second.pid);
+         w.put16(ts.getNumSections());
+         for (const Section *sec : ts.section_list) {
+            w.put8(sec->hasCRC());
+            w.put16(sec->length());
+            w.put(sec->getBinaryData(), sec->length());
+         }
+      }
+
+      if (!dirty.empty()) {
+         w.begin(DIRTY_R);
+         w.put16(dirty.size());
+         for (Key k : dirty) {
+            w.put32(k);
+         }
+      }
+      w.end();
+
+      // written aside and renamed over the old snapshot so a failed
+      // save leaves the last good one in place
+      const std::string tmp_name = file_name + ".tmp";
+      int fd = ::open(tmp_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0)
+         return false;
+
+      const ui8 *d = w.buf.data();
+      size_t left = w.buf.size();
+      while (left > 0) {
+         const ssize_t n = ::write(fd, d, left);
+         if (n < 0 && errno == EINTR)
+            continue;
+         if (n <= 0)
+            break;
+         d += n;
+         left -= n;
+      }
+
+      const bool ok = left == 0 && fsync(fd) == 0;
+      if (::close(fd) != 0 || !ok || rename(tmp_name.c_str(), file_name.c_str()) != 0) {
+         unlink(tmp_name.c_str());
+         return false;
+      }
+      return true;
+   }
+
+   std::unique_ptr<Multiplex> Multiplex::loadSnapshot(const std::string &file_name)
+   {
+      MappedFile file(file_name);
+      if (!file.data || file.len < HEADER_LEN || memcmp(file.data, MAGIC, sizeof(MAGIC)))
+         return nullptr;
+
+      Reader hdr(file.data + sizeof(MAGIC), HEADER_LEN - sizeof(MAGIC));
+      const ui16 version = hdr.get16();
+      hdr.get16();
+      if (version != FORMAT_VERSION || hdr.get32() != file.len)
+         return nullptr;
+      const ui32 count = hdr.get32();
+
+      std::unique_ptr<Multiplex> mux;
+      Reader r(file.data + HEADER_LEN, file.len - HEADER_LEN);
+      bool complete = false;
+      ui32 records = 0;
+
+      while (!complete && !r.atEnd()) {
+         const ui16 type = r.get16();
+         r.get16();
+         const ui32 len = r.get32();
+         if (!r.good() || len > r.left())
+            return nullptr;
+
+         const size_t padded = (static_cast<size_t>(len) + ALIGN - 1) & ~static_cast<size_t>(ALIGN - 1);
+         const ui8 *payload = r.get(padded);
+         if (!payload || (type != MUX_R && type != END_R && !mux))
+            return nullptr;
+         records++;
+
+         Reader p(payload, len);
+         switch (type)
+         {
+           case MUX_R:
+           {
+              const ui16 nid = p.get16(), xsid = p.get16(), onid = p.get16();
+              mux.reset(new Multiplex(nid, xsid, onid));
+              mux->dirty.clear();
+              mux->network_name = p.getStr();
+              break;
+           }
+
+           case SERVICE_R:
+           {
+              Service &serv = mux->services[p.get16()];
+              serv.pmt_pid = p.get16();
+              serv.pcr_pid = p.get16();
+              serv.type = p.get8();
+              serv.running_status = p.get8();
+              serv.free_CA_mode = p.get8();
+              serv.provider = p.getStr();
+              serv.name = p.getStr();
+              for (ui16 n = p.get16(); n > 0 && p.good(); n--) {
+                 const ui8 es_type = p.get8();
+                 serv.streams.emplace_back(es_type, p.get16());
+              }
+              break;
+           }
+
+           case EVENT_R:
+           {
+              const ui16 sid = p.get16();
+              const ui8 slot = p.get8();
+              auto it = mux->services.find(sid);
+              if (it == mux->services.end())
+                 return nullptr;
+
+              std::unique_ptr<Event> ev(new Event);
+              ev->id = p.get16();
+              const ui8 *time = p.get(UTC::BYTE_LEN + BCDTime::TIME_LEN);
+              if (!time)
+                 return nullptr;
+              ui8 bcd[BCDTime::TIME_LEN];
+              memcpy(bcd, time + 2, sizeof(bcd));
+              ev->start_time = UTC((time[0] << 8) | time[1], bcd);
+              ev->duration = BCDTime(time + UTC::BYTE_LEN);
+              ev->running_status = p.get8();
+              ev->free_CA_mode = p.get8();
+              ev->language = p.getStr();
+              ev->name = p.getStr();
+              ev->text = p.getStr();
+
+              (slot ? it->second.following : it->second.present) = std::move(ev);
+              break;
+           }
+
+           case BOUQUET_R:
+           {
+              Bouquet &b = mux->bouquets[p.get16()];
+              b.name = p.getStr();
+              for (ui16 n = p.get16(); n > 0 && p.good(); n--) {
+                 b.services.insert(p.get16());
+              }
+              break;
+           }
+
+           case TABLE_R:
+           {
+              Entry e;
+              e.type = static_cast<SubTable>(p.get8());
+              e.id = p.get16();
+              e.pid = p.get16();
+
+              std::unique_ptr<TStream> ts(new TStream);
+              for (ui16 n = p.get16(); n > 0 && p.good(); n--) {
+                 const bool with_crc = p.get8();
+                 const ui16 sec_len = p.get16();
+                 const ui8 *d = p.get(sec_len);
+                 if (!d || !ts->getNewSection(sec_len)->assign(d, sec_len, with_crc))
+                    return nullptr;
+              }
+              if (!p.good())
+                 return nullptr;
+
+              // the first publish keeps the sections' version
+              e.table = std::make_shared<PublishedTable>();
+              e.table->publish(std::move(ts));
+              mux->published[key(e.type, e.id)] = e;
+              break;
+           }
+
+           case DIRTY_R:
+              for (ui16 n = p.get16(); n > 0 && p.good(); n--) {
+                 mux->dirty.insert(p.get32());
+              }
+              break;
+
+           case END_R:
+              complete = true;
+              break;
+
+           default:
+              // unknown records are skipped
+              break;
+         }
+
+         if (!p.good())
+            return nullptr;
+      }
+
+      if (!complete || !mux || !r.good() || records != count)
+         return nullptr;
+
+      mux->markUnpublished();
+      return mux;
+   }
+
+
+   //
+   // published sub-tables
+   //
+   std::shared_ptr<PublishedTable> Multiplex::getTable(SubTable type, ui16 id) const
+   {
+      if (type != PMT_ST && type != BAT_ST && type != PF_EIT_ST)
+         id = 0;
+
+      auto it = published.find(key(type, id));
+      return (it != published.end()) ? it->second.table : nullptr;
+   }
+
+   std::vector<Multiplex::Entry> Multiplex::getTables() const
+   {
+      std::vector<Entry> v;
+      v.reserve(published.size());
+      for (const auto &p : published) {
+         v.push_back(p.second);
+      }
+      return v;
+   }
+
+} // sigen namespace
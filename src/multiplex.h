@@ -0,0 +1,246 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// multiplex.h: transport stream SI model owning and versioning its tables
+// -----------------------------------
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "types.h"
+#include "utc.h"
+
+namespace sigen {
+
+   class PublishedTable;
+
+   /*!
+    * \brief Model of a transport stream's services from which its PAT,
+    * PMTs, SDT actual, NIT actual, BATs and EIT p/f actual are derived.
+    *
+    * The PAT is derived from the services' PMTs, and the services
+    * listed in the SDT, NIT and BATs always match them. Changes mark
+    * only the sub-tables they affect dirty and rebuild() regenerates
+    * those (in parallel) into PublishedTable's, whose version_number is
+    * bumped on each publish. The model must not be changed while
+    * rebuild() runs; the published tables can be read at any time.
+    *
+    * The TOT / TDT are time driven and left to LiveTimeTable.
+    */
+   class Multiplex
+   {
+   public:
+      enum SubTable { PAT_ST, PMT_ST, SDT_ST, NIT_ST, BAT_ST, PF_EIT_ST };
+
+      //! \brief A present or following event.
+      struct Event {
+         ui16 id;                  //!< Event id.
+         UTC start_time;           //!< Start time.
+         BCDTime duration;         //!< Duration.
+         ui8 running_status;       //!< See sigen::Dvb::RunningStatus_t.
+         bool free_CA_mode;        //!< Components are scrambled.
+         std::string language;     //!< ShortEventDesc language code.
+         std::string name;         //!< ShortEventDesc event name (none if empty).
+         std::string text;         //!< ShortEventDesc text.
+      };
+
+      //! \brief A published sub-table and the PID it's sent on.
+      struct Entry {
+         SubTable type;
+         ui16 id;                  //!< service_id (PMT, EIT), bouquet_id (BAT) or 0.
+         ui16 pid;
+         std::shared_ptr<PublishedTable> table;
+      };
+
+      /*!
+       * \brief Constructor.
+       * \param network_id Id of the network, for the NIT.
+       * \param xs_id Id of the transport stream.
+       * \param on_id Id of the originating network.
+       */
+      Multiplex(ui16 network_id, ui16 xs_id, ui16 on_id);
+      ~Multiplex();
+
+      // prohibit
+      Multiplex(const Multiplex &) = delete;
+      Multiplex &operator=(const Multiplex &) = delete;
+
+      /*!
+       * \brief Set the network name, for the NIT's NetworkNameDesc.
+       * \param name Name of the network (none if empty).
+       */
+      void setNetworkName(const std::string &name);
+
+      /*!
+       * \brief Add a service.
+       * \param service_id Unique id of the service (program_number).
+       * \param pmt_pid PID to carry its PMT.
+       * \param pcr_pid PID carrying its PCR.
+       * \param service_type See sigen::Dvb::ServiceType_t.
+       * \param provider Provider name, for the SDT's ServiceDesc.
+       * \param name Service name, for the SDT's ServiceDesc.
+       * \return `false` if the id is taken or a PID is out of range.
+       */
+      bool addService(ui16 service_id, ui16 pmt_pid, ui16 pcr_pid, ui8 service_type,
+                      const std::string &provider, const std::string &name);
+      /*!
+       * \brief Remove a service (and its PMT and EIT) from all tables.
+       * \param service_id Id of the service.
+       */
+      bool removeService(ui16 service_id);
+      /*!
+       * \brief Add an elementary stream to a service's PMT.
+       * \param service_id Id of the service.
+       * \param type Stream type. See PMT::esTypes.
+       * \param elem_pid PID carrying the stream.
+       */
+      bool addElemStream(ui16 service_id, ui8 type, ui16 elem_pid);
+      /*!
+       * \brief Set a service's provider and service names.
+       * \param service_id Id of the service.
+       * \param provider Provider name.
+       * \param name Service name.
+       */
+      bool setServiceName(ui16 service_id, const std::string &provider, const std::string &name);
+      /*!
+       * \brief Set a service's running status and free_CA_mode in the SDT.
+       * \param service_id Id of the service.
+       * \param running_status See sigen::Dvb::RunningStatus_t.
+       * \param free_CA_mode `true`: one or more components are scrambled.
+       */
+      bool setServiceStatus(ui16 service_id, ui8 running_status, bool free_CA_mode);
+      /*!
+       * \brief Set a service's present and following events.
+       * \param service_id Id of the service.
+       * \param present Present event, `nullptr` for none.
+       * \param following Following event, `nullptr` for none.
+       */
+      bool setPresentFollowing(ui16 service_id, const Event *present, const Event *following);
+
+      /*!
+       * \brief Add a bouquet.
+       * \param bouquet_id Unique id of the bouquet.
+       * \param name Bouquet name, for its BouquetNameDesc.
+       */
+      bool addBouquet(ui16 bouquet_id, const std::string &name);
+      /*!
+       * \brief Add a service of this transport stream to a bouquet.
+       * \param bouquet_id Id of the bouquet.
+       * \param service_id Id of the service.
+       */
+      bool addBouquetService(ui16 bouquet_id, ui16 service_id);
+
+      //! \brief `true` if rebuild() has anything to do.
+      bool isDirty() const { return !dirty.empty(); }
+
+      /*!
+       * \brief Build and publish the changed sub-tables.
+       * \param threads Threads to build on, 0 for one per cpu.
+       * \return Number of sub-tables published.
+       */
+      size_t rebuild(unsigned threads = 0);
+
+      /*!
+       * \brief A published sub-table.
+       * \param type Sub-table type.
+       * \param id service_id for PMT_ST and PF_EIT_ST, bouquet_id for
+       * BAT_ST, otherwise ignored.
+       * \return `nullptr` if it's not been built (or no longer exists).
+       */
+      std::shared_ptr<PublishedTable> getTable(SubTable type, ui16 id = 0) const;
+
+      //! \brief All published sub-tables, in type and id order.
+      std::vector<Entry> getTables() const;
+
+      /*!
+       * \brief Save the model, its pending changes and the published
+       * sections to a snapshot file.
+       *
+       * The file is a 16-byte header ("SGMX", u16 format version, u16
+       * reserved, u32 file length, u32 record count) followed by 4-byte
+       * aligned records: u16 type, u16 reserved, u32 payload length and
+       * the payload, big endian like the tables themselves. Built
+       * sections are stored as-is, with their CRCs. The file is written
+       * to `file_name.tmp`, synced and renamed over `file_name`, so a
+       * failed save keeps the previous snapshot.
+       * \param file_name File to write.
+       * \return `false` if the file couldn't be written.
+       */
+      bool saveSnapshot(const std::string &file_name) const;
+
+      /*!
+       * \brief Restore a multiplex from a snapshot file.
+       *
+       * The file is memory mapped and its sections copied from the
+       * mapping and published as stored, without rebuilding, so output
+       * can resume right away. The mapping is dropped once loaded.
+       * Sub-tables with pending changes, or missing from the snapshot,
+       * are dirty and built on the next rebuild(); the others keep
+       * their versions and are only rebuilt when changed.
+       * \param file_name File to read.
+       * \return `nullptr` if the file is missing, truncated or not a
+       * snapshot of this format version.
+       */
+      static std::unique_ptr<Multiplex> loadSnapshot(const std::string &file_name);
+
+   private:
+      struct Service {
+         ui16 pmt_pid;
+         ui16 pcr_pid;
+         ui8 type;
+         ui8 running_status;
+         bool free_CA_mode;
+         std::string provider;
+         std::string name;
+         std::vector<std::pair<ui8, ui16> > streams;
+         std::unique_ptr<Event> present;
+         std::unique_ptr<Event> following;
+      };
+
+      struct Bouquet {
+         std::string name;
+         std::set<ui16> services;
+      };
+
+      typedef ui32 Key;       // SubTable << 16 | id
+      static Key key(SubTable t, ui16 id) { return (t << 16) | id; }
+
+      ui16 network_id;
+      ui16 xs_id;
+      ui16 on_id;
+      std::string network_name;
+      std::map<ui16, Service> services;
+      std::map<ui16, Bouquet> bouquets;
+
+      std::set<Key> dirty;
+      std::map<Key, Entry> published;
+
+      // table set changes: dirties the PAT, SDT, NIT and bouquets
+      void serviceListChanged(ui16 service_id);
+      // builds and publishes a sub-table, false if it no longer exists
+      bool build(Key k, PublishedTable &pt) const;
+      // marks sub-tables the model has but that aren't published
+      void markUnpublished();
+   };
+
+} // sigen namespace
@@ -26,6 +26,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <list>
+#include <unordered_set>
 #include "table.h"
 #include "descriptor.h"
 #include "tstream.h"
@@ -36,7 +37,7 @@ namespace sigen
    //
    // add a network descriptor to the table
    //
-   bool NIT_BAT::addDesc(Descriptor& d)
+   bool NIT_BAT::add_desc(Descriptor& d, bool in_arena)
    {
       ui16 d_len = d.length();
 
@@ -44,7 +45,7 @@ namespace sigen
       if ( !incLength(d_len) )
          return false;
 
-      descriptors.add(d, d_len);
+      descriptors.add(d, d_len, in_arena);
       return true;
    }
 
@@ -71,184 +72,74 @@ namespace sigen
    }
 
    //
-   // handles writing the data to the stream. return true if the table
-   // is done (all sections are completed)
+   // bulk load: checks the batch, then adds it in one pass
    //
-   bool NIT_BAT::writeSection(Section& section, ui8 cur_sec, ui16& sec_bytes) const
+   bool NIT_BAT::addXportStreams(const XportStreamInfo* streams, size_t count)
    {
-      ui8 *nd_loop_len_pos = 0, *ts_loop_len_pos = 0;
-      ui16 d_len, net_desc_len = 0, ts_loop_len = 0;
-      bool done = false, exit = false;
-
-      while (!exit)
-      {
-         switch (run.op_state)
-         {
-           case INIT:
-              // associate the iterators to the lists.. once they reach the
-              // end, they'll take care to reset themselves
-              run.nd_iter = descriptors.begin();
-              run.ts_iter = xs_list.begin();
-              run.op_state = WRITE_HEAD;
-
-           case WRITE_HEAD:
-              // common data for every section
-              // if table's length is > max_section_len, we'll
-              // overwrite the section length later on
-              writeSectionHeader(section);
-
-              // section count information
-              section.set08Bits(cur_sec);
-
-              // we don't know the last section number yet, so
-              // for now set it to 0,
-              section.set08Bits(0);//last_sec_num);
-
-              // save the position for the descriptors_loop_len
-              nd_loop_len_pos = section.getCurDataPosition();
-
-              // for now, save the original value.. this is necessary to
-              // increment the internal data pointer of the buffer
-              section.set16Bits(descriptors.loop_length());
-
-              sec_bytes = BASE_LENGTH; // the minimum section size
-              run.op_state = (!run.nd ? GET_NET_DESC : WRITE_NET_DESC);
-              break;
-
-           case GET_NET_DESC:
-              // update the descriptors_len.. we always do this
-              // and if we don't add any, it is set to 0 anyways
-              section.set16Bits(nd_loop_len_pos,
-                                rbits(~LEN_MASK) |
-                                (net_desc_len & LEN_MASK) );
-
-              if (!run.nd_done) {
-                 // fetch the next network descriptor
-                 if (run.nd_iter != descriptors.end()) {
-                    run.nd = (*run.nd_iter++).get();
-
-                    // check if we can fit it in this section
-                    if (sec_bytes + run.nd->length() > getMaxDataLen()) {
-                       // holy crap, this is a special case! if the
-                       // section is filled with net descriptors, we
-                       // must sitll write the XS loop length!
-                       ts_loop_len_pos = section.getCurDataPosition();
-                       section.set16Bits( 0 ); //xport_stream_loop_length);
-
-                       // we can't.. return so we can get a new section
-                       // we'll add it when we come back
-                       run.op_state = WRITE_HEAD;
-                       exit = true;
-                    }
-                    else  // found one
-                       run.op_state = WRITE_NET_DESC;
-                    break;
-                 }
-                 else {
-                    run.nd_done = true;
-                    run.nd = nullptr;
-                    // fall through
-                 }
-              }
-
-              // done with all network descriptors.. move on to the
-              // transport streams
-              run.op_state = WRITE_XPORT_LOOP_LEN;
-              break;
-
-           case WRITE_NET_DESC:
-              // add the network descriptor
-              run.nd->buildSections(section);
-
-              d_len = run.nd->length();
-              sec_bytes += d_len;
-              net_desc_len += d_len;
-
-              // try to add another one
-              run.op_state = GET_NET_DESC;
-              break;
-
-           case WRITE_XPORT_LOOP_LEN:
-              // save the location for the transport stream loop length
-              ts_loop_len_pos = section.getCurDataPosition();
-              // again, this will be overwritten, but is necessary to
-              // increment the internal buffer pointer
-
-              section.set16Bits( 0 ); //xport_stream_loop_length);
-
-              // if we were looking at one already, don't get a new xport stream
-              run.op_state = (!run.ts ? GET_XPORT_STREAM : WRITE_XPORT_STREAM);
-              break;
-
-           case GET_XPORT_STREAM:
+      ui32 len = 0;
+      for (size_t i = 0; i < count; i++) {
+         if (!RawDesc::isValidLoop(streams[i].desc_data, streams[i].desc_len))
+            return false;
+         len += XportStream::BASE_LEN + streams[i].desc_len;
+      }
 
-              // fetch a transport stream
-              if (run.ts_iter != xs_list.end()) {
-                 run.ts = *(run.ts_iter++);
+#ifdef CHECK_DUPLICATES
+      std::unordered_set<ui16> ids;
+      for (const ListItem* item : xs_list)
+         ids.insert(static_cast<const XportStream*>(item)->id);
+
+      for (size_t i = 0; i < count; i++) {
+         if (!ids.insert(streams[i].xs_id).second) {
+            std::stringstream err;
+            err << "Attempt to add duplicate transort stream with id " << std::hex << streams[i].xs_id;
+            throw std::range_error(err.str());
+         }
+      }
+#endif
 
-                 // first, check if it has any descriptors.. we'll try to fit
-                 // at least one
-                 if (!run.ts->descriptors.empty()) {
-                    // check the size with the descriptor
-                    if ( (sec_bytes + XportStream::BASE_LEN + run.ts->descriptors.front()->length()) >
-                         getMaxDataLen() ) {
-                       // won't fit.. wait until the next section
-                       run.op_state = WRITE_HEAD;
-                       exit = true;
-                       break;
-                    }
-                 }
-                 else {
-                    // check if this XS with no descs will fit here
-                    if ( (sec_bytes + XportStream::BASE_LEN) > getMaxDataLen() ) {
-                       // nope.. wait also
-                       run.op_state = WRITE_HEAD;
-                       exit = true;
-                       break;
-                    }
-                 }
-                 // all is ok.. add it
-                 run.op_state = WRITE_XPORT_STREAM;
-              }
-              else {
-                 // no more network descriptors or transport streams, so
-                 // all sections are done!
-                 run = Context();
-                 exit = done = true;
-                 break;
-              }
-              break;
+      if ( !incLength(len) )
+         return false;
 
-           case WRITE_XPORT_STREAM:
-              // finally write it
-              if (!(*run.ts).write_section(section, getMaxDataLen(), sec_bytes, &ts_loop_len)) {
-                 run.op_state = WRITE_HEAD;
-                 exit = true;
-                 break;
-              }
-              run.op_state = GET_XPORT_STREAM;
-              break;
-         }
+      for (size_t i = 0; i < count; i++) {
+         XportStream* xs = new XportStream(streams[i].xs_id, streams[i].on_id);
+         addRawDescs(xs, streams[i].desc_data, streams[i].desc_len);
+         xs_list.push_back(xs);
       }
+      return true;
+   }
 
-      // save the xport stream length we've calculated so far
-      section.set16Bits( ts_loop_len_pos,
-                         rbits(~LEN_MASK) |
-                         (ts_loop_len & LEN_MASK) );
-      return done;
+   //
+   // handles writing the data to the stream. return true if the table
+   // is done (all sections are completed)
+   //
+   bool NIT_BAT::writeSection(Section& section, ui8 cur_sec, ui16& sec_bytes) const
+   {
+      return run.write(section, sec_bytes, BASE_LENGTH, getMaxDataLen(),
+                       [&](Section& s) {
+                          // common data for every section
+                          // if table's length is > max_section_len, we'll
+                          // overwrite the section length later on
+                          writeSectionHeader(s);
+
+                          // section count information
+                          s.set08Bits(cur_sec);
+
+                          // we don't know the last section number yet, so
+                          // for now set it to 0,
+                          s.set08Bits(0);
+                       },
+                       &descriptors, &xs_list);
    }
 
 
    //
    // state machine for writing the transport streams
    //
-   ui8 NIT_BAT::XportStream::write_header(Section& section) const
+   void NIT_BAT::XportStream::write_header(Section& section) const
    {
       // write the transport stream data
       section.set16Bits(id);
       section.set16Bits(original_network_id);
-
-      return XportStream::BASE_LEN - 2;
    }
 
    //
@@ -300,7 +191,7 @@ namespace sigen
       o << std::endl;
 
       // display each transport stream's data & descriptors
-      incOutLevel();
+      incOutLevel(o);
       for (const ListItem* item : xs_list) {
          const XportStream* xs = dynamic_cast<const XportStream*>(item);
          headerStr(o, XPORT_STREAM_S);
@@ -314,7 +205,7 @@ namespace sigen
          // dump the descriptors (inherited method)
          xs->descriptors.dump(o);
       }
-      decOutLevel();
+      decOutLevel(o);
    }
 
 #endif
@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <list>
+#include "section_writer.h"
 #include "table.h"
 
 namespace sigen {
@@ -46,10 +47,24 @@ namespace sigen {
    public:
       enum { NIT_ACTUAL_TID = 0x40, NIT_OTHER_TID = 0x41, BAT_TID = 0x4a };
 
+      //! \brief A transport stream for addXportStreams().
+      struct XportStreamInfo {
+         ui16 xs_id;                      //!< Unique id of the transport stream.
+         ui16 on_id;                      //!< Id of the originating network.
+         const ui8* desc_data;            //!< Serialized descriptor loop (may be `nullptr`).
+         ui16 desc_len;                   //!< Length of the descriptor loop.
+      };
+
       // add a Descriptor to the class. Aliased in the NIT and BAT
       // classes as addNetworkDesc() and addBouquetDesc()
       // respectively.
-      bool addDesc(Descriptor &);
+      bool addDesc(Descriptor &d) { return add_desc(d, false); }
+      // as above, constructing it in place
+      template <class D, class... Args>
+      bool emplaceDesc(Args&&... args) {
+         return emplace<D>([this](Descriptor& d) { return add_desc(d, true); },
+                           std::forward<Args>(args)...);
+      }
 
       /*!
        * \brief Add a transport stream to table.
@@ -68,6 +83,30 @@ namespace sigen {
        * \param desc Descriptor to add.
        */
       bool addXportStreamDesc(ui16 xs_id, Descriptor& desc) { return addItemDesc(xs_list, xs_id, desc); }
+      /*!
+       * \brief Construct a Descriptor in place and add it to the transport stream specified.
+       *
+       * The `D` is built in the table's arena instead of being allocated
+       * on its own, e.g. `nit.emplaceXportStreamDesc<CableDeliverySystemDesc>(xs_id, freq, ...)`.
+       * \param xs_id Id of transport stream to add descriptor to.
+       * \param args Arguments for the `D` constructor.
+       */
+      template <class D, class... Args>
+      bool emplaceXportStreamDesc(ui16 xs_id, Args&&... args) {
+         return emplaceItemDesc<D>(xs_list, xs_id, std::forward<Args>(args)...);
+      }
+
+      /*!
+       * \brief Add a batch of transport streams with their descriptors.
+       *
+       * The lengths are checked once for the whole batch, which is added
+       * entirely or not at all.
+       * \param streams Transport streams to add.
+       * \param count Number of transport streams.
+       * \return `false` if a descriptor loop is malformed or the table
+       * would be too long.
+       */
+      bool addXportStreams(const XportStreamInfo* streams, size_t count);
 
       [[deprecated("replaced by addXportStreamDesc(xs_id, Descriptor&)")]]
       bool addXportStreamDesc(ui16 xs_id, ui16 on_id, Descriptor& desc) {
@@ -82,7 +121,7 @@ namespace sigen {
       enum { MAX_SEC_LEN = 1024 };
 
       // the transport stream struct - public as the BAT uses it too
-      struct XportStream : public ExtPSITable::ListItem
+      struct XportStream final : public ExtPSITable::LoopItem<XportStream>
       {
          enum { BASE_LEN = 6 };
 
@@ -97,12 +136,13 @@ namespace sigen {
          virtual ui16 length() const { return 6; }
          virtual bool equals(ui16 tsid) const { return (tsid == id); }
 
-         // writes item header bytes, returns num bytes written
-         virtual ui8 write_header(Section& sec) const;
+         // writes item header bytes
+         void write_header(Section& sec) const;
       };
 
       // NIT members
       DescList descriptors;
+      bool add_desc(Descriptor& d, bool in_arena);
       std::list<ListItem*>& xs_list;
 
       // private methods
@@ -113,21 +153,8 @@ namespace sigen {
 #endif
 
       // section building state tracking
-      enum State_t { INIT, WRITE_HEAD, GET_NET_DESC, WRITE_NET_DESC, WRITE_XPORT_LOOP_LEN,
-                     GET_XPORT_STREAM, WRITE_XPORT_STREAM };
-      mutable struct Context {
-         Context() :
-            nd_done(false), op_state(INIT), nd(nullptr), ts(nullptr)
-         {}
-
-         bool nd_done;
-         State_t op_state;
-
-         const Descriptor *nd;
-         std::list<std::unique_ptr<Descriptor> >::const_iterator nd_iter;
-         const ListItem *ts;
-         std::list<ListItem*>::const_iterator ts_iter;
-      } run;
+      mutable SectionWriter<XportStream, std::list<ListItem*>,
+                            DESC_LOOP_LEN | ITEM_LOOP_LEN> run;
 
    protected:
       // protected constructor - type refers to ACTUAL or OTHER,
@@ -152,6 +179,12 @@ namespace sigen {
        * \param desc Descriptor to add.
        */
       bool addNetworkDesc(Descriptor& desc) { return addDesc(desc); }
+      /*!
+       * \brief Construct a Descriptor in place in the Network Descriptors loop.
+       * \param args Arguments for the `D` constructor.
+       */
+      template <class D, class... Args>
+      bool emplaceNetworkDesc(Args&&... args) { return emplaceDesc<D>(std::forward<Args>(args)...); }
 
    protected:
       // protected constructor - type refers to ACTUAL or OTHER,
@@ -226,6 +259,12 @@ namespace sigen {
        * \param desc Descriptor to add.
        */
       bool addBouquetDesc(Descriptor& desc) { return addDesc(desc); }
+      /*!
+       * \brief Construct a Descriptor in place in the Bouquet Descriptors loop.
+       * \param args Arguments for the `D` constructor.
+       */
+      template <class D, class... Args>
+      bool emplaceBouquetDesc(Args&&... args) { return emplaceDesc<D>(std::forward<Args>(args)...); }
    };
 
    //! @}
@@ -54,19 +54,16 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set16Bits( announcement_support_indicator );
+      Layout::write( s, announcement_support_indicator );
 
       // iterate through the list and write the data
       for (const auto& ann : announcement_list) {
-         s.set08Bits( (ann.type << 4) |
-                      rbits(0x08) |
-                      ann.reference_type );
+         AnnouncementLayout::write( s, ann.type, ann.reference_type );
 
          if (ann.actual_serv_info) {
-            s.set16Bits( ann.actual_serv_info->original_network_id );
-            s.set16Bits( ann.actual_serv_info->xport_stream_id );
-            s.set16Bits( ann.actual_serv_info->service_id );
-            s.set08Bits( ann.actual_serv_info->component_tag );
+            const auto& info = *ann.actual_serv_info;
+            ServiceInfoLayout::write( s, info.original_network_id, info.xport_stream_id,
+                                      info.service_id, info.component_tag );
          }
       }
    }
@@ -80,7 +77,7 @@ namespace sigen
       // dump the descriptor's data
       identStr(o, ANNOUNCEMENT_SUPPORT_IND_S, announcement_support_indicator);
 
-      incOutLevel();
+      incOutLevel(o);
       for (const auto& ann : announcement_list) {
          identStr(o, ANNOUNCEMENT_TYPE_S, ann.type);
          identStr(o, RESERVED_FU_S, 0x1);
@@ -94,7 +91,7 @@ namespace sigen
          }
          o << std::endl;
       }
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -110,10 +107,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set32Bits( frequency );
-      s.set16Bits( 0xfff0 | fec_outer );
-      s.set08Bits( modulation );
-      s.set32Bits( (symbol_rate << 4) | fec_inner );
+      Layout::write( s, frequency, fec_outer, modulation, symbol_rate, fec_inner );
    }
 
 
@@ -187,14 +181,11 @@ namespace sigen
       Descriptor::buildSections(s);
 
       for (const auto& link : cflink_list) {
-         s.set16Bits( link.cell_id );
-         s.set32Bits( link.frequency );
-         s.set08Bits( link.subcell_list.size() * Link::SubCell::BASE_LEN );
+         CellLayout::write( s, link.cell_id, link.frequency,
+                            link.subcell_list.size() * Link::SubCell::BASE_LEN );
 
-         for (const auto &subcell : link.subcell_list) {
-            s.set08Bits( subcell.cell_id_extension );
-            s.set32Bits( subcell.transposer_frequency );
-         }
+         for (const auto &subcell : link.subcell_list)
+            SubCellLayout::write( s, subcell.cell_id_extension, subcell.transposer_frequency );
       }
    }
 
@@ -273,19 +264,14 @@ namespace sigen
       Descriptor::buildSections(s);
 
       for (const auto& cell : cell_list) {
-         s.set16Bits( cell.id );
-         s.set16Bits( cell.latitude );
-         s.set16Bits( cell.longitude );
-         s.set16Bits( cell.extend_of_latitude );
-         s.set16Bits( cell.extend_of_longitude );
-
-         for (const auto& subcell : cell.subcell_list) {
-            s.set08Bits( subcell.cell_id_extension );
-            s.set16Bits( subcell.latitude );
-            s.set16Bits( subcell.longitude );
-            s.set24Bits( (subcell.extend_of_latitude << 12) |
-                         subcell.extend_of_longitude );
-         }
+         CellLayout::write( s, cell.id, cell.latitude, cell.longitude,
+                            cell.extend_of_latitude, cell.extend_of_longitude,
+                            cell.subcell_list.size() * Cell::SubCell::BASE_LEN );
+
+         for (const auto& subcell : cell.subcell_list)
+            SubCellLayout::write( s, subcell.cell_id_extension, subcell.latitude,
+                                  subcell.longitude, subcell.extend_of_latitude,
+                                  subcell.extend_of_longitude );
       }
    }
 
@@ -337,7 +323,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set08Bits( rbits(0xfc) | coding_type );
+      Layout::write( s, coding_type );
       for (ui32 f : frequency_list) {
          s.set32Bits(f);
       }
@@ -354,10 +340,10 @@ namespace sigen
       identStr(o, RESERVED_FU_S, 0x3f);
       identStr(o, CODING_TYPE_S, coding_type);
 
-      incOutLevel();
+      incOutLevel(o);
       for (ui32 f : frequency_list)
          identStr(o, FREQ_S, f);
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -372,14 +358,8 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set32Bits( frequency );
-      s.set16Bits( orbital_position );
-      s.set08Bits( (west_east << 7) |
-                   (polarisation << 5) |
-                   (roll_off << 3) |
-                   (modulation_system << 2) |
-                   (modulation_type) );
-      s.set32Bits( (symbol_rate << 4) | fec_inner );
+      Layout::write( s, frequency, orbital_position, west_east, polarisation, roll_off,
+                     modulation_system, modulation_type, symbol_rate, fec_inner );
    }
 
 
@@ -412,21 +392,9 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set32Bits( ctr_frequency );
-      s.set08Bits( (bandwidth << 5) |
-                   (priority << 4) |
-                   (time_slicing_indicator << 3) |
-                   (MPE_FEC_indicator << 2) |
-                   rbits(0x3) );
-      s.set08Bits( (constellation << 6) |
-                   (hierarchy_info << 3) |
-                   cr_HP_stream );
-      s.set08Bits( (cr_LP_stream << 5) |
-                   (guard_interval << 3) |
-                   (transmission_mode << 1) |
-                   other_freq_flag );
-
-      s.set32Bits( rbits(0xffffffff) );
+      Layout::write( s, ctr_frequency, bandwidth, priority, time_slicing_indicator,
+                     MPE_FEC_indicator, constellation, hierarchy_info, cr_HP_stream,
+                     cr_LP_stream, guard_interval, transmission_mode, other_freq_flag );
    }
 
 
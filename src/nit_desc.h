@@ -54,6 +54,11 @@ namespace sigen {
    public:
       enum { TAG = 0x44 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Field<32>, Reserved<12>, Field<4>, Field<8>, Field<28>, Field<4>> {
+         enum { FREQUENCY, FEC_OUTER, MODULATION, SYMBOL_RATE, FEC_INNER };
+      };
+
       /*!
        * \brief Constructor
        * \param freq BCD frequency.
@@ -94,6 +99,13 @@ namespace sigen {
    public:
       enum { TAG = 0x43 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Field<32>, Field<16>, Field<1>, Field<2>, Field<2>, Field<1>,
+                                Field<2>, Field<28>, Field<4>> {
+         enum { FREQUENCY, ORBITAL_POSITION, WEST_EAST, POLARISATION, ROLL_OFF,
+                MODULATION_SYSTEM, MODULATION_TYPE, SYMBOL_RATE, FEC_INNER };
+      };
+
       /*!
        * \brief Constructor for DVB-S modulation systems.
        * \param freq BCD frequency.
@@ -168,6 +180,15 @@ namespace sigen {
    public:
       enum { TAG = 0x5a };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Field<32>, Field<3>, Field<1>, Field<1>, Field<1>, Reserved<2>,
+                                Field<2>, Field<3>, Field<3>, Field<3>, Field<2>, Field<2>,
+                                Field<1>, Reserved<32>> {
+         enum { CENTRE_FREQUENCY, BANDWIDTH, PRIORITY, TIME_SLICING_INDICATOR,
+                MPE_FEC_INDICATOR, CONSTELLATION, HIERARCHY_INFORMATION, CODE_RATE_HP_STREAM,
+                CODE_RATE_LP_STREAM, GUARD_INTERVAL, TRANSMISSION_MODE, OTHER_FREQUENCY_FLAG };
+      };
+
       /*!
        * \brief Constructor for legacy descriptor without new fields.
        * \param cfreq Center frequency.
@@ -254,6 +275,21 @@ namespace sigen {
    public:
       enum { TAG = 0x6e };
 
+      //! \brief Layout of the fixed fields, followed by the announcements.
+      struct Layout : BitLayout<Field<16>> {
+         enum { ANNOUNCEMENT_SUPPORT_INDICATOR };
+      };
+
+      //! \brief Layout of each announcement's first byte.
+      struct AnnouncementLayout : BitLayout<Field<4>, Reserved<1>, Field<3>> {
+         enum { ANNOUNCEMENT_TYPE, REFERENCE_TYPE };
+      };
+
+      //! \brief Layout of the service fields following it for service reference types.
+      struct ServiceInfoLayout : BitLayout<Field<16>, Field<16>, Field<16>, Field<8>> {
+         enum { ORIGINAL_NETWORK_ID, TRANSPORT_STREAM_ID, SERVICE_ID, COMPONENT_TAG };
+      };
+
       // announcement support values
       enum AnnouncementSupportIndicator {
          EMERGENCY_ALARM_AS        = 0x0001,
@@ -375,6 +411,16 @@ namespace sigen {
    public:
       enum { TAG = 0x6d };
 
+      //! \brief Layout of each cell, followed by its subcells.
+      struct CellLayout : BitLayout<Field<16>, Field<32>, Field<8>> {
+         enum { CELL_ID, FREQUENCY, SUBCELL_INFO_LOOP_LENGTH };
+      };
+
+      //! \brief Layout of each subcell.
+      struct SubCellLayout : BitLayout<Field<8>, Field<32>> {
+         enum { CELL_ID_EXTENSION, TRANSPOSER_FREQUENCY };
+      };
+
       //! \brief Constructor
       CellFrequencyLinkDesc() : Descriptor(TAG) { }
 
@@ -461,6 +507,19 @@ namespace sigen {
    public:
       enum { TAG = 0x6c };
 
+      //! \brief Layout of each cell, followed by its subcells.
+      struct CellLayout : BitLayout<Field<16>, Field<16>, Field<16>, Field<12>, Field<12>,
+                                    Field<8>> {
+         enum { CELL_ID, CELL_LATITUDE, CELL_LONGITUDE, CELL_EXTENT_OF_LATITUDE,
+                CELL_EXTENT_OF_LONGITUDE, SUBCELL_INFO_LOOP_LENGTH };
+      };
+
+      //! \brief Layout of each subcell.
+      struct SubCellLayout : BitLayout<Field<8>, Field<16>, Field<16>, Field<12>, Field<12>> {
+         enum { CELL_ID_EXTENSION, SUBCELL_LATITUDE, SUBCELL_LONGITUDE, SUBCELL_EXTENT_OF_LATITUDE,
+                SUBCELL_EXTENT_OF_LONGITUDE };
+      };
+
       //! \brief Constructor
       CellListDesc() : Descriptor(TAG) { }
 
@@ -575,6 +634,11 @@ namespace sigen {
    public:
       enum { TAG = 0x62 };
 
+      //! \brief Layout of the fixed fields, followed by the frequencies.
+      struct Layout : BitLayout<Reserved<6>, Field<2>> {
+         enum { CODING_TYPE };
+      };
+
       /*!
        * \enum  Coding
        *
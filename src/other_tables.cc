@@ -53,18 +53,26 @@ namespace sigen
    // table builder function
    void RST::buildSections(TStream& strm) const
    {
-      Section *s = strm.getNewSection( getMaxSectionLen() );
+      buildSection( *strm.getNewSection( getMaxSectionLen() ) );
+   }
 
-      STable::buildSections(*s);
+   bool RST::buildSection(Section& s) const
+   {
+      if (s.capacity() < 3 + getDataLength())
+         return false;
+
+      s.reset();
+      STable::buildSections(s);
 
       // write the transport stream data
       for (const XportStream& xs : xport_stream_list) {
-         s->set16Bits(xs.id);
-         s->set16Bits(xs.original_network_id);
-         s->set16Bits(xs.service_id);
-         s->set16Bits(xs.event_id);
-         s->set08Bits( rbits(0xf8) | (xs.running_status & 0x7) );
+         s.set16Bits(xs.id);
+         s.set16Bits(xs.original_network_id);
+         s.set16Bits(xs.service_id);
+         s.set16Bits(xs.event_id);
+         s.set08Bits( rbits(0xf8) | (xs.running_status & 0x7) );
       }
+      return true;
    }
 
 
@@ -78,7 +86,7 @@ namespace sigen
       o << std::endl;
 
       // dump the transport streams
-      incOutLevel();
+      incOutLevel(o);
       for (const XportStream& xs : xport_stream_list) {
          headerStr(o, XPORT_STREAM_S);
 
@@ -90,7 +98,7 @@ namespace sigen
 
          o << std::endl;
       }
-      decOutLevel();
+      decOutLevel(o);
       o << std::endl;
    }
 #endif
@@ -112,11 +120,19 @@ namespace sigen
    //
    void Stuffing::buildSections(TStream& strm) const
    {
-      Section *s = strm.getNewSection( getMaxSectionLen() );
+      buildSection( *strm.getNewSection( getMaxSectionLen() ) );
+   }
 
-      STable::buildSections(*s);
+   bool Stuffing::buildSection(Section& s) const
+   {
+      if (s.capacity() < 3 + getDataLength())
+         return false;
 
-      s->setBits( data );
+      s.reset();
+      STable::buildSections(s);
+
+      s.setBits( data );
+      return true;
    }
 
 
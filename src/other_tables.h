@@ -47,7 +47,8 @@ namespace sigen {
    {
    public:
       enum {
-         PID = 0x13                            //!< Packet PID for transmission.
+         PID = 0x13,                           //!< Packet PID for transmission.
+         MAX_SEC_LEN = 1024                    //!< Maximum section length, e.g. for an InlineSection.
       };
 
       //! \brief Constructor.
@@ -65,13 +66,14 @@ namespace sigen {
                           ui8  running_status);
 
       virtual void buildSections(TStream&) const;
+      virtual bool buildSection(Section&) const;
 
 #ifdef ENABLE_DUMP
       void dump(std::ostream&) const;
 #endif
 
    private:
-      enum { MAX_SEC_LEN = 1024, TID = 0x71 };
+      enum { TID = 0x71 };
 
       // the private transport stream class
       struct XportStream : public STable::ListItem {
@@ -118,6 +120,7 @@ namespace sigen {
 
       // utility
       virtual void buildSections(TStream&) const;
+      virtual bool buildSection(Section&) const;
 
 #ifdef ENABLE_DUMP
       void dump(std::ostream&) const;
@@ -0,0 +1,317 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// paced_sink.cc: constant bitrate packet output
+// -----------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sys/timerfd.h>
+#endif
+#include "paced_sink.h"
+#include "spsc_ring.h"
+
+namespace sigen
+{
+   namespace paced_sink_priv {
+      const uint64_t NS = 1000000000;
+      const uint64_t PACKET_BITS = PacketSink::PACKET_SIZE * 8;
+
+      // jitter bucket upper bounds in us
+      const ui32 JITTER_LIMITS[PacedSink::JITTER_BUCKETS] = {
+         10, 50, 100, 250, 500, 1000, 5000, 0
+      };
+
+      enum { NULL_BURST = 64 }; // null packets per write
+
+      // how many ticks late a wakeup may catch up on, the rest is skipped
+      enum { MAX_LAG_TICKS = 8 };
+
+      struct Packet {
+         ui8 data[PacketSink::PACKET_SIZE];
+      };
+      static_assert(sizeof(Packet) == PacketSink::PACKET_SIZE, "packets must be contiguous");
+
+      uint64_t nowNs()
+      {
+         timespec ts;
+         clock_gettime(CLOCK_MONOTONIC, &ts);
+         return static_cast<uint64_t>(ts.tv_sec) * NS + ts.tv_nsec;
+      }
+
+      timespec toTimespec(uint64_t ns)
+      {
+         timespec ts;
+         ts.tv_sec = ns / NS;
+         ts.tv_nsec = ns % NS;
+         return ts;
+      }
+
+      //
+      // wakes up on each tick after a start time, counting the ticks
+      class Ticker
+      {
+      public:
+         Ticker(uint64_t start_ns, uint64_t tick_ns) : start(start_ns), tick(tick_ns), ticks(0) {
+#ifdef __linux__
+            fd = timerfd_create(CLOCK_MONOTONIC, 0);
+            itimerspec its;
+            its.it_value = toTimespec(start + tick);
+            its.it_interval = toTimespec(tick);
+            if (fd >= 0 && timerfd_settime(fd, TFD_TIMER_ABSTIME, &its, nullptr) != 0) {
+               close(fd);
+               fd = -1;
+            }
+#endif
+         }
+         ~Ticker() {
+#ifdef __linux__
+            if (fd >= 0)
+               close(fd);
+#endif
+         }
+
+         // waits for the next tick, returns the time it was due
+         uint64_t wait() {
+#ifdef __linux__
+            uint64_t expired;
+            if (fd >= 0 && read(fd, &expired, sizeof(expired)) == sizeof(expired)) {
+               ticks += expired;
+               return start + ticks * tick;
+            }
+#endif
+            // skips ticks already missed
+            const uint64_t now = nowNs();
+            ticks = std::max(ticks + 1, (now - start) / tick);
+            timespec due = toTimespec(start + ticks * tick);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, nullptr) == EINTR)
+               ;
+            return start + ticks * tick;
+         }
+
+      private:
+         int fd = -1;
+         const uint64_t start, tick;
+         uint64_t ticks;
+      };
+   }
+
+   using namespace paced_sink_priv;
+
+   class PacedSink::Impl
+   {
+   public:
+      Impl(PacketSink &o, ui32 bitrate, size_t queue_packets, ui32 tick_us);
+
+      PacketSink &out;
+      const uint64_t bitrate, tick_ns;
+      SpscRing<Packet> queue;
+      Packet nulls[NULL_BURST];
+
+      std::thread thread;
+      int cpu;
+      std::atomic<bool> running, flush_out;
+
+      std::atomic<uint64_t> packets{0}, null_packets{0}, skipped_packets{0}, ticks{0}, max_late_ns{0};
+      std::atomic<uint64_t> jitter[JITTER_BUCKETS];
+
+      void run();
+      void count(std::atomic<uint64_t> &c, uint64_t n) {
+         c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+      }
+   };
+
+   PacedSink::Impl::Impl(PacketSink &o, ui32 rate, size_t queue_packets, ui32 tick_us) :
+      out(o), bitrate(rate), tick_ns(std::max<ui32>(tick_us, 1) * UINT64_C(1000)),
+      queue(queue_packets), cpu(-1), running(false), flush_out(false)
+   {
+      for (std::atomic<uint64_t> &j : jitter)
+         j = 0;
+
+      for (Packet &p : nulls) {
+         memset(p.data, 0xff, sizeof(p.data));
+         p.data[0] = 0x47;
+         p.data[1] = NULL_PID >> 8;
+         p.data[2] = NULL_PID & 0xff;
+         p.data[3] = 0x10;   // payload only, cc 0
+      }
+   }
+
+   //
+   // the pacing thread - sends what's due on each tick
+   //
+   void PacedSink::Impl::run()
+   {
+      const uint64_t start = nowNs();
+      Ticker ticker(start, tick_ns);
+
+      // bits owed (times NS), carried over between ticks
+      uint64_t last = start, credit = 0;
+      const uint64_t max_lag_ns = MAX_LAG_TICKS * tick_ns;
+
+      while (running.load(std::memory_order_acquire)) {
+         const uint64_t due_at = ticker.wait();
+         const uint64_t now = nowNs();
+
+         const uint64_t late = now > due_at ? now - due_at : 0;
+         unsigned b = 0;
+         while (JITTER_LIMITS[b] && late > JITTER_LIMITS[b] * UINT64_C(1000))
+            b++;
+         count(jitter[b], 1);
+         count(ticks, 1);
+         if (late > max_late_ns.load(std::memory_order_relaxed))
+            max_late_ns.store(late, std::memory_order_relaxed);
+
+         // after a stall, only the last few ticks are caught up on
+         uint64_t elapsed = now - last;
+         if (elapsed > max_lag_ns) {
+            const uint64_t lag = elapsed - max_lag_ns;
+            count(skipped_packets, (lag / NS * bitrate + lag % NS * bitrate / NS) / PACKET_BITS);
+            elapsed = max_lag_ns;
+         }
+         credit += elapsed * bitrate;
+         last = now;
+         uint64_t due = credit / (PACKET_BITS * NS);
+         credit -= due * PACKET_BITS * NS;
+
+         // queued packets straight from the ring, then nulls
+         size_t n;
+         Packet *p;
+         while (due > 0 && (p = queue.peek(n))) {
+            n = std::min<uint64_t>(n, due);
+            out.write(p->data, n);
+            queue.release(n);
+            count(packets, n);
+            due -= n;
+         }
+         count(null_packets, due);
+         while (due > 0) {
+            n = std::min<uint64_t>(due, NULL_BURST);
+            out.write(nulls[0].data, n);
+            due -= n;
+         }
+
+         if (flush_out.load(std::memory_order_acquire)) {
+            out.flush();
+            flush_out.store(false, std::memory_order_release);
+         }
+      }
+   }
+
+
+   // --------------------------------
+   // paced sink
+   //
+   PacedSink::PacedSink(PacketSink &out, ui32 bitrate, size_t queue_packets, ui32 tick_us) :
+      impl(new Impl(out, bitrate, queue_packets, tick_us))
+   {
+   }
+
+   PacedSink::~PacedSink()
+   {
+      stop();
+   }
+
+   void PacedSink::pin(int cpu)
+   {
+      impl->cpu = cpu;
+   }
+
+   void PacedSink::start()
+   {
+      if (impl->thread.joinable())
+         return;
+
+      impl->running = true;
+      impl->thread = std::thread(&Impl::run, impl.get());
+
+#ifdef __linux__
+      if (impl->cpu >= 0) {
+         cpu_set_t set;
+         CPU_ZERO(&set);
+         CPU_SET(impl->cpu, &set);
+         pthread_setaffinity_np(impl->thread.native_handle(), sizeof(set), &set);
+      }
+#endif
+   }
+
+   void PacedSink::stop()
+   {
+      impl->running.store(false, std::memory_order_release);
+      if (impl->thread.joinable())
+         impl->thread.join();
+   }
+
+   void PacedSink::write(const ui8 *packets, size_t count)
+   {
+      const std::chrono::nanoseconds backoff(impl->tick_ns / 4);
+
+      for (; count > 0; count--, packets += PACKET_SIZE) {
+         // the queue fills up ahead of the output rate
+         Packet *slot;
+         while (!(slot = impl->queue.claim()))
+            std::this_thread::sleep_for(backoff);
+
+         memcpy(slot->data, packets, PACKET_SIZE);
+         impl->queue.publish();
+      }
+   }
+
+   void PacedSink::flush()
+   {
+      if (!impl->thread.joinable())
+         return;
+
+      const std::chrono::nanoseconds backoff(impl->tick_ns / 4);
+      while (!impl->queue.empty())
+         std::this_thread::sleep_for(backoff);
+
+      // the output is only used from the pacing thread
+      impl->flush_out.store(true, std::memory_order_release);
+      while (impl->flush_out.load(std::memory_order_acquire) && impl->running.load())
+         std::this_thread::sleep_for(backoff);
+   }
+
+   PacedSink::Stats PacedSink::getStats() const
+   {
+      Stats s;
+      s.packets = impl->packets.load();
+      s.null_packets = impl->null_packets.load();
+      s.skipped_packets = impl->skipped_packets.load();
+      s.ticks = impl->ticks.load();
+      s.max_late_ns = impl->max_late_ns.load();
+      for (unsigned i = 0; i < JITTER_BUCKETS; i++)
+         s.jitter[i] = impl->jitter[i].load();
+      return s;
+   }
+
+   ui32 PacedSink::jitterLimit(unsigned bucket)
+   {
+      return bucket < JITTER_BUCKETS ? JITTER_LIMITS[bucket] : 0;
+   }
+
+} // sigen namespace
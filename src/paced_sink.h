@@ -0,0 +1,99 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// paced_sink.h: constant bitrate packet output
+// -----------------------------------
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "sink.h"
+
+namespace sigen {
+
+   /*!
+    * \brief PacketSink releasing packets to another sink at a constant
+    * bitrate, filling the gaps with null packets.
+    *
+    * Written packets are queued and a pacing thread, woken every tick
+    * by a timerfd (clock_nanosleep elsewhere) on the monotonic clock,
+    * passes on as many packets as are due by then. The count due is
+    * worked out from the time since start() with the remainder carried
+    * over, so late wakeups are caught up on and the rate doesn't drift.
+    * A wakeup more than a few ticks late only catches up on the last
+    * few, the packets owed before that are counted as skipped.
+    * When the queue runs short, null packets (PID 0x1FFF) make up the
+    * rate. How late each wakeup was is kept in a histogram.
+    */
+   class PacedSink : public PacketSink
+   {
+   public:
+      enum {
+         NULL_PID = 0x1fff,
+         JITTER_BUCKETS = 8
+      };
+
+      //! \brief Output counters.
+      struct Stats {
+         uint64_t packets;         //!< Queued packets passed on.
+         uint64_t null_packets;    //!< Null packets sent to make up the rate.
+         uint64_t skipped_packets; //!< Packet slots dropped after a stalled wakeup.
+         uint64_t ticks;           //!< Wakeups of the pacing thread.
+         uint64_t max_late_ns;     //!< Latest wakeup, in ns past its tick.
+         //! Wakeups by lateness: bucket i up to jitterLimit(i) us.
+         uint64_t jitter[JITTER_BUCKETS];
+      };
+
+      /*!
+       * \brief Constructor.
+       * \param out Sink for the paced packets, only called from the pacing thread.
+       * \param bitrate Output rate in bits per second.
+       * \param queue_packets Packets that can be queued ahead of their time.
+       * \param tick_us Pacing thread wakeup period in microseconds.
+       */
+      PacedSink(PacketSink &out, ui32 bitrate, size_t queue_packets = 8192, ui32 tick_us = 1000);
+      ~PacedSink();
+
+      // prohibit
+      PacedSink(const PacedSink &) = delete;
+      PacedSink &operator=(const PacedSink &) = delete;
+
+      //! \brief Pin the pacing thread to a cpu, -1 to not pin. Takes effect on start().
+      void pin(int cpu);
+      //! \brief Start the pacing thread (and the clock).
+      void start();
+      //! \brief Stop the pacing thread. Packets still queued are kept.
+      void stop();
+
+      //! \brief Queue packets. Blocks while the queue is full.
+      void write(const ui8 *packets, size_t count);
+      //! \brief If started, wait for the queue to be sent, then flush the output.
+      void flush();
+
+      Stats getStats() const;
+      //! \brief Upper bound of a jitter bucket in us, 0 for the last (unbounded).
+      static ui32 jitterLimit(unsigned bucket);
+
+   private:
+      class Impl;
+      std::unique_ptr<Impl> impl;
+   };
+
+} // sigen namespace
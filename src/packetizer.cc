@@ -20,12 +20,14 @@
 // packetizer.cc: class definition for mpeg packetizer
 // -----------------------------------
 
-#include <iostream>
-#include <iomanip>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <string>
+#include <vector>
 #include "types.h"
 #include "packetizer.h"
+#include "sink.h"
 #include "tstream.h"
 
 namespace sigen
@@ -46,62 +48,78 @@ namespace sigen
       std::ofstream tfile( filename.c_str(), std::ios::out );
    }
 
+   MpgPacketizer::MpgPacketizer(ui8 cont_count) :
+      transport_error_indicator(false),
+      transport_priority(false),
+      continuity_count(cont_count),
+      transport_scrambling_control(MpgPacketizer::NOT_SCRAMBLED),
+      adaptation_field_control(MpgPacketizer::NO_ADAPTATION_FIELD)
+   {
+   }
+
 
    //
    // this is the main packetizing function
    //
    int MpgPacketizer::packetize(const Section &section, ui16 pid)
    {
-      bool payload_unit_start_indicator = true;
-      ui16 cur_section_size, this_section_size;
-      ui8 header_size, packet_size;
-      ui8 packet[PACKET_SIZE], *tptr;
-      std::ofstream packetfile(filename.c_str(), std::ios::app);
+      std::vector<ui8> packets;
+      packetize(section, pid, packets);
 
-      const ui8 *section_data = section.getBinaryData();
+      std::ofstream packetfile(filename.c_str(), std::ios::app | std::ios::binary);
+      packetfile.write(reinterpret_cast<const char *>(packets.data()), packets.size());
+      return continuity_count;
+   }
 
-      cur_section_size = this_section_size = section.length();
+   int MpgPacketizer::packetize(const Section &section, ui16 pid, std::vector<ui8> &packets)
+   {
+      return packetize(section.getBinaryData(), section.length(), pid, packets);
+   }
 
-      header_size = HEADER_SIZE;
-      packet_size = PACKET_SIZE - header_size;
+   int MpgPacketizer::packetize(const ui8 *section_data, ui16 cur_section_size, ui16 pid,
+                                std::vector<ui8> &packets)
+   {
+      bool payload_unit_start_indicator = true;
+
+      packets.reserve(packets.size() +
+                      PACKET_SIZE * ((cur_section_size + PKT_DATA_SIZE) / PKT_DATA_SIZE));
 
-      // start
       while (cur_section_size > 0) {
          // fill packet with pad val for short packets
-         for (int i = 0; i < PACKET_SIZE; i++)
-            packet[i] = 0xff;
-
-         // set the packet ptr to point to this packet
-         if (header_size != 0) {
-            getHeader(&packet[0], nullptr, // section_data,
-                      payload_unit_start_indicator, pid);
-            tptr = &packet[header_size];
+         size_t pkt_pos = packets.size();
+         packets.resize(pkt_pos + PACKET_SIZE, 0xff);
+
+         ui8 *tptr = &packets[pkt_pos];
+         getHeader(tptr, nullptr, payload_unit_start_indicator, pid);
+         tptr += HEADER_SIZE;
+
+         ui16 room = PKT_DATA_SIZE;
+         if (payload_unit_start_indicator) {
+            // pointer field
+            *(tptr++) = 0;
+            room--;
          }
-         else
-            tptr = &packet[0];
 
          // move packet data in
-         for (int i = 0; i < PKT_DATA_SIZE; i++) {
-            if (payload_unit_start_indicator && (i == 0))
-               *(tptr++) = static_cast<char>(0);
-            else {
-               if (cur_section_size > 0) {
-                  *(tptr++) = section_data[ this_section_size - cur_section_size ];
-                  cur_section_size--;
-               }
-               else
-                  break;
-            }
-         }
+         ui16 len = std::min(room, cur_section_size);
+         memcpy(tptr, section_data, len);
+         section_data += len;
+         cur_section_size -= len;
+
          // clear unit start so only first packet of section is unit start
          payload_unit_start_indicator = false;
-
-         for (int i = 0; i < PACKET_SIZE; i++)
-            packetfile << packet[i];
       }
       return continuity_count;
    }
 
+   int MpgPacketizer::packetize(const Section &section, ui16 pid, PacketSink &sink)
+   {
+      scratch.clear();
+      packetize(section, pid, scratch);
+      sink.write(scratch.data(), scratch.size() / PACKET_SIZE);
+      return continuity_count;
+   }
+
    // builds the header
    //
    void MpgPacketizer::getHeader(ui8 *packet,
@@ -112,13 +130,6 @@ namespace sigen
       *(packet++) = SYNC_BYTE;
 
       if (!section_data) {
-         std::cout << "byte: " << std::hex
-                   << static_cast<ui16>( (transport_error_indicator << 7) |
-                                         (payload_unit_start_indicator << 6) |
-                                         (transport_priority << 5) |
-                                         ((pid >> 8) & 0x1f) )
-                   << std::endl;
-
          *(packet++) = static_cast<ui8>( (transport_error_indicator << 7) |
                                          (payload_unit_start_indicator << 6) |
                                          (transport_priority << 5) |
@@ -128,11 +139,6 @@ namespace sigen
                                          (adaptation_field_control << 4) |
                                          (continuity_count & 0xf) );
 
-         std::cerr << "tsc: " << static_cast<ui16>(transport_scrambling_control)
-                   << ", afc: " << static_cast<ui16>(adaptation_field_control)
-                   << ", cc: " << static_cast<ui16>(continuity_count)
-                   << std::endl;
-
          // only increment CC based on value of AFC
          if ( (adaptation_field_control != MpgPacketizer::RESERVED) &&
               (adaptation_field_control != MpgPacketizer::ADAPTATION_FIELD_ONLY) )
@@ -23,10 +23,12 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include "types.h"
 
 namespace sigen {
 
+   class PacketSink;
    class Section;
 
    //
@@ -43,8 +45,9 @@ namespace sigen {
          ADAPTATION_FIELD_AND_PAYLOAD = 0x4
       };
 
-      // constructor
+      // constructors
       MpgPacketizer(const std::string &out_file, ui8 cont_count);
+      explicit MpgPacketizer(ui8 cont_count); // in-memory only
       // prohibit
       MpgPacketizer() = delete;
       MpgPacketizer(const MpgPacketizer &) = delete;
@@ -58,12 +61,13 @@ namespace sigen {
       }
 
       int packetize(const Section &section, ui16 pid);
+      // appends the packets to the buffer instead of the file
+      int packetize(const Section &section, ui16 pid, std::vector<ui8> &packets);
+      // writes the packets to the sink (e.g., a MappedFileSink)
+      int packetize(const Section &section, ui16 pid, PacketSink &sink);
+      // from the bytes of a built section (e.g., a StaticSection)
+      int packetize(const ui8 *section_data, ui16 len, ui16 pid, std::vector<ui8> &packets);
 
-   protected:
-      void getHeader(ui8 *packet, const ui8 *section_data,
-                     bool payload_unit_start_indicator, ui16 pid);
-
-   private:
       enum {
          SYNC_BYTE     = 0x47,
          HEADER_SIZE   = 4,
@@ -71,8 +75,14 @@ namespace sigen {
          PACKET_SIZE   = PKT_DATA_SIZE + 4,
       };
 
+   protected:
+      void getHeader(ui8 *packet, const ui8 *section_data,
+                     bool payload_unit_start_indicator, ui16 pid);
+
+   private:
       // data
       std::string filename;
+      std::vector<ui8> scratch; // reused for sink output
 
       bool transport_error_indicator,
            transport_priority;
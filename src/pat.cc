@@ -46,68 +46,21 @@ namespace sigen
    // writes to the stream
    bool PAT::writeSection(Section& section, ui8 cur_sec, ui16 &sec_bytes) const
    {
-      bool done = false;
-      bool exit = false;
-
-      while (!exit)
-      {
-         switch (run.op_state)
-         {
-           case INIT:
-              run.p_iter = program_list.begin();
-              run.op_state = WRITE_HEAD;
-              // fall through
-
-           case WRITE_HEAD:
-              // common data for every section
-              // if table's length is > available space, we'll
-              // overwrite the section length later on
-              writeSectionHeader(section);
-
-              // section count information
-              section.set08Bits(cur_sec);
-
-              // we don't know the last section number yet, so
-              // for now set it to 0,
-              section.set08Bits(0);
-
-              sec_bytes = BASE_LENGTH; // the minimum section size
-              run.op_state = (!run.p ? GET_PROGRAM : WRITE_PROGRAM);
-              break;
-
-           case GET_PROGRAM:
-              // fetch the next service
-              if (run.p_iter != program_list.end()) {
-                 run.p = &(*run.p_iter++);
-
-                 // does adding it exceed capacity?
-                 if ( (sec_bytes + Program::BASE_LEN) > getMaxDataLen() ) {
-                    // yes
-                    run.op_state = WRITE_HEAD;
-                    exit = true;
-                    break;
-                 }
-                 // we can add it
-                 run.op_state = WRITE_PROGRAM;
-              }
-              else {
-                 // done with all programs.. all sections are done!
-                 run = Context();
-                 exit = done = true;
-                 break;
-              }
-              break;
-
-           case WRITE_PROGRAM:
-              section.set16Bits(run.p->number);
-              section.set16Bits( rbits(0xe000) | run.p->pid );
-
-              sec_bytes += Program::BASE_LEN;
-              run.op_state = GET_PROGRAM;
-              break;
-         }
-      }
-      return done;
+      return run.write(section, sec_bytes, BASE_LENGTH, getMaxDataLen(),
+                       [&](Section& s) {
+                          // common data for every section
+                          // if table's length is > available space, we'll
+                          // overwrite the section length later on
+                          writeSectionHeader(s);
+
+                          // section count information
+                          s.set08Bits(cur_sec);
+
+                          // we don't know the last section number yet, so
+                          // for now set it to 0,
+                          s.set08Bits(0);
+                       },
+                       nullptr, &program_list);
    }
 
 
@@ -121,7 +74,7 @@ namespace sigen
       o << std::endl;
 
       // program list
-      incOutLevel(); // indent output
+      incOutLevel(o); // indent output
       for (const Program& program : program_list) {
          identStr(o, PROGRAM_NUM_S, program.number);
          identStr(o, RESERVED_S, 0x07);
@@ -129,7 +82,7 @@ namespace sigen
          o << std::endl;
       }
       o << std::endl;
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
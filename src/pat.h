@@ -23,6 +23,7 @@
 #pragma once
 
 #include <list>
+#include "section_writer.h"
 #include "table.h"
 
 namespace sigen {
@@ -41,7 +42,10 @@ namespace sigen {
    class PAT : public PSITable
    {
    public:
-      enum { PID = 0x00 };
+      enum {
+         PID = 0x00,                           //!< Packet PID for transmission.
+         MAX_SEC_LEN = 1024                    //!< Maximum section length, e.g. for an InlineSection.
+      };
 
       /*!
        * \brief Constructor.
@@ -76,8 +80,7 @@ namespace sigen {
 
    private:
       enum { D_BIT = 0,
-             TID = 0x00,
-             MAX_SEC_LEN = 1024 };
+             TID = 0x00 };
 
       // the program / pid holder struct - private to the pat
       struct Program : public STable::ListItem {
@@ -89,19 +92,21 @@ namespace sigen {
          // constructor
          Program(ui16 n, ui16 p) : number(n), pid(p) {}
          Program() = delete;
+
+         ui16 fit_length() const { return BASE_LEN; }
+         bool write_section(Section& sec, ui16, ui16& sec_bytes, ui16*) const {
+            sec.set16Bits(number);
+            sec.set16Bits( rbits(0xe000) | pid );
+
+            sec_bytes += BASE_LEN;
+            return true;
+         }
       };
 
       // the list of program / pids
       std::list<Program> program_list;
 
-      enum State_t { INIT, WRITE_HEAD, GET_PROGRAM, WRITE_PROGRAM };
-      mutable struct Context {
-         Context() : op_state(INIT), p(nullptr) {}
-
-         State_t op_state;
-         const Program *p;
-         std::list<Program>::const_iterator p_iter;
-      } run;
+      mutable SectionWriter<Program> run;
 
    protected:
       virtual bool writeSection(Section&, ui8, ui16 &) const;
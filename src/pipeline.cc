@@ -0,0 +1,372 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// pipeline.cc: threaded table building -> packetizing -> output
+// -----------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "descriptor.h"
+#include "packetizer.h"
+#include "pipeline.h"
+#include "sink.h"
+#include "spsc_ring.h"
+#include "table.h"
+#include "tstream.h"
+
+namespace sigen
+{
+   namespace pipeline_priv
+   {
+      using Clock = std::chrono::steady_clock;
+
+      enum { MAX_SECTION_LEN = 4096 };
+
+      struct Job {
+         std::shared_ptr<const STable> table;
+         ui16 pid;
+      };
+
+      struct SectionItem {
+         Section *section;
+         ui16 pid;
+         Clock::time_point t;   // when it was built
+      };
+
+      struct Packet {
+         ui8 data[PacketSink::PACKET_SIZE];
+      };
+      static_assert(sizeof(Packet) == PacketSink::PACKET_SIZE, "packets must be contiguous");
+
+      //
+      // spins, then yields, then sleeps while a ring is empty / full
+      class Backoff
+      {
+      public:
+         void wait() {
+            if (n < 64)
+               n++;
+            else if (n < 128) {
+               n++;
+               std::this_thread::yield();
+            }
+            else
+               std::this_thread::sleep_for(std::chrono::microseconds(50));
+         }
+
+      private:
+         int n = 0;
+      };
+
+      //
+      // latency counter - written by one stage thread, read by any
+      struct Counter
+      {
+         std::atomic<uint64_t> items{0}, total_ns{0}, max_ns{0};
+
+         void add(Clock::duration d) {
+            const auto relaxed = std::memory_order_relaxed;
+            uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+
+            items.store(items.load(relaxed) + 1, relaxed);
+            total_ns.store(total_ns.load(relaxed) + ns, relaxed);
+            if (ns > max_ns.load(relaxed))
+               max_ns.store(ns, relaxed);
+         }
+      };
+   }
+
+   using namespace pipeline_priv;
+
+   //
+   // the rings, section pool and stage threads
+   //
+   class Pipeline::Impl
+   {
+   public:
+      Impl(PacketSink &s, size_t ring_size);
+
+      PacketSink &sink;
+
+      SpscRing<Job> jobs, urgent_jobs;         // caller -> build
+      SpscRing<SectionItem> sections;          // build -> packetize
+      SpscRing<Section *> free_sections;       // packetize -> build
+      SpscRing<Packet> packets;                // packetize -> sink
+      std::vector<Clock::time_point> packet_times; // when each packet slot was queued
+
+      std::vector<std::unique_ptr<Section> > pool;
+      Section *spare;                          // free section held by build
+      std::map<ui16, std::unique_ptr<MpgPacketizer> > packetizers; // by pid
+
+      std::thread threads[NUM_STAGES];
+      int cpus[NUM_STAGES];
+      Counter counters[NUM_STAGES];
+
+      // set by finish() / when the upstream stage is done
+      std::atomic<bool> stopping, built, packetized;
+
+      void build();
+      void packetize();
+      void output();
+   };
+
+   Pipeline::Impl::Impl(PacketSink &s, size_t ring_size) :
+      sink(s),
+      jobs(ring_size), urgent_jobs(ring_size),
+      sections(ring_size), free_sections(ring_size),
+      packets(ring_size),
+      packet_times(packets.capacity()),
+      spare(nullptr),
+      stopping(false), built(false), packetized(false)
+   {
+      // the sections in flight - also bounds the build stage's lead
+      while (pool.size() < sections.capacity()) {
+         pool.emplace_back( new Section(MAX_SECTION_LEN) );
+         free_sections.push( pool.back().get() );
+      }
+
+      for (int &cpu : cpus)
+         cpu = -1;
+   }
+
+   //
+   // builds a section at a time, from the urgent queue's table when there
+   // is one. A table's sizing pass is also run a section at a time, so
+   // starting a large table doesn't hold up the urgent queue
+   //
+   void Pipeline::Impl::build()
+   {
+      struct Lane {
+         Job job;
+         SectionGenerator gen{nullptr};
+         Clock::duration prepare_time{0}; // counted with the first section
+         bool busy = false;
+      } lanes[2];
+      SpscRing<Job> *queues[2] = { &urgent_jobs, &jobs };
+      Backoff idle;
+
+      for (;;) {
+         Lane *lane = nullptr;
+
+         for (int i = 0; i < 2 && !lane; i++) {
+            size_t n;
+            Job *job;
+
+            if (!lanes[i].busy && (job = queues[i]->peek(n))) {
+               lanes[i].job = std::move(*job);
+               queues[i]->release(1);
+               lanes[i].gen = lanes[i].job.table->sections();
+               lanes[i].busy = true;
+            }
+            if (lanes[i].busy)
+               lane = &lanes[i];
+         }
+
+         if (!lane) {
+            if (stopping.load(std::memory_order_acquire) &&
+                urgent_jobs.empty() && jobs.empty())
+               break;
+            idle.wait();
+            continue;
+         }
+         idle = Backoff();
+
+         Clock::time_point start = Clock::now();
+         const bool ready = lane->gen.prepare();
+         lane->prepare_time += Clock::now() - start;
+         if (!ready)
+            continue;
+
+         // wait for the packetizer to hand a section back
+         for (Backoff full; !spare && !free_sections.pop(spare); )
+            full.wait();
+
+         start = Clock::now();
+         if (!lane->gen.next(*spare)) {
+            *lane = Lane();
+            continue;
+         }
+         Clock::time_point now = Clock::now();
+         counters[BUILD].add(now - start + lane->prepare_time);
+         lane->prepare_time = Clock::duration::zero();
+
+         SectionItem item = { spare, lane->job.pid, now };
+         for (Backoff full; !sections.push(item); )
+            full.wait();
+         spare = nullptr;
+      }
+      built.store(true, std::memory_order_release);
+   }
+
+   //
+   // packetizes each section into the packet ring, continuity counters
+   // are kept per pid
+   //
+   void Pipeline::Impl::packetize()
+   {
+      std::vector<ui8> buf;
+      Backoff idle;
+
+      for (;;) {
+         size_t n;
+         SectionItem *item = sections.peek(n);
+
+         if (!item) {
+            if (built.load(std::memory_order_acquire) && sections.empty())
+               break;
+            idle.wait();
+            continue;
+         }
+         idle = Backoff();
+
+         std::unique_ptr<MpgPacketizer> &p = packetizers[item->pid];
+         if (!p)
+            p.reset( new MpgPacketizer(0) );
+
+         buf.clear();
+         p->packetize(*item->section, item->pid, buf);
+
+         for (size_t pos = 0; pos < buf.size(); pos += PacketSink::PACKET_SIZE) {
+            Packet *pkt;
+            for (Backoff full; !(pkt = packets.claim()); )
+               full.wait();
+
+            memcpy(pkt->data, &buf[pos], PacketSink::PACKET_SIZE);
+            packet_times[packets.index(pkt)] = Clock::now();
+            packets.publish();
+         }
+         counters[PACKETIZE].add(Clock::now() - item->t);
+
+         free_sections.push(item->section);
+         sections.release(1);
+      }
+      packetized.store(true, std::memory_order_release);
+   }
+
+   //
+   // hands each run of queued packets to the sink in one call
+   //
+   void Pipeline::Impl::output()
+   {
+      Backoff idle;
+
+      for (;;) {
+         size_t n;
+         Packet *pkt = packets.peek(n);
+
+         if (!pkt) {
+            if (packetized.load(std::memory_order_acquire) && packets.empty())
+               break;
+            idle.wait();
+            continue;
+         }
+         idle = Backoff();
+
+         sink.write(pkt->data, n);
+
+         Clock::time_point now = Clock::now();
+         for (size_t i = packets.index(pkt), end = i + n; i < end; i++)
+            counters[SINK].add(now - packet_times[i]);
+         packets.release(n);
+      }
+      sink.flush();
+   }
+
+
+   // --------------------------------
+   // pipeline
+   //
+   Pipeline::Pipeline(PacketSink &sink, size_t ring_size) :
+      impl(new Impl(sink, ring_size))
+   {
+   }
+
+   Pipeline::~Pipeline()
+   {
+      finish();
+   }
+
+   void Pipeline::pin(Stage stage, int cpu)
+   {
+      impl->cpus[stage] = cpu;
+   }
+
+   void Pipeline::start()
+   {
+      if (impl->threads[BUILD].joinable())
+         return;
+
+      impl->stopping = impl->built = impl->packetized = false;
+
+      impl->threads[BUILD] = std::thread(&Impl::build, impl.get());
+      impl->threads[PACKETIZE] = std::thread(&Impl::packetize, impl.get());
+      impl->threads[SINK] = std::thread(&Impl::output, impl.get());
+
+#ifdef __linux__
+      for (int i = 0; i < NUM_STAGES; i++) {
+         if (impl->cpus[i] < 0)
+            continue;
+
+         cpu_set_t set;
+         CPU_ZERO(&set);
+         CPU_SET(impl->cpus[i], &set);
+         pthread_setaffinity_np(impl->threads[i].native_handle(), sizeof(set), &set);
+      }
+#endif
+   }
+
+   void Pipeline::submit(std::shared_ptr<const STable> table, ui16 pid, bool urgent)
+   {
+      SpscRing<Job> &queue = urgent ? impl->urgent_jobs : impl->jobs;
+
+      Job *slot;
+      for (Backoff full; !(slot = queue.claim()); )
+         full.wait();
+
+      slot->table = std::move(table);
+      slot->pid = pid;
+      queue.publish();
+   }
+
+   void Pipeline::finish()
+   {
+      impl->stopping.store(true, std::memory_order_release);
+
+      // each stage exits once the one before it has and its ring is empty
+      for (std::thread &t : impl->threads) {
+         if (t.joinable())
+            t.join();
+      }
+   }
+
+   Pipeline::Stats Pipeline::getStats(Stage stage) const
+   {
+      const Counter &c = impl->counters[stage];
+      return Stats{ c.items.load(), c.total_ns.load(), c.max_ns.load() };
+   }
+
+} // namespace
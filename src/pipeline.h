@@ -0,0 +1,109 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// pipeline.h: threaded table building -> packetizing -> output
+// -----------------------------------
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "types.h"
+
+namespace sigen {
+
+   class PacketSink;
+   class STable;
+
+   /*!
+    * \brief Threaded output pipeline: table building, packetizing and
+    * a PacketSink, each stage on its own thread.
+    *
+    * The stages are connected by lock-free single producer / single
+    * consumer rings; a full ring stalls the stage feeding it, back to
+    * submit(). Tables are built lazily a section at a time and urgent
+    * tables (PAT, PMT, TDT, ..) are built in between the sections of a
+    * table already in progress, so a long EIT build doesn't hold them up.
+    */
+   class Pipeline
+   {
+   public:
+      enum Stage { BUILD, PACKETIZE, SINK, NUM_STAGES };
+
+      //! \brief Latency counters for a stage.
+      struct Stats {
+         uint64_t items;      //!< Sections built / packetized, packets written.
+         uint64_t total_ns;   //!< Sum of the latencies in ns.
+         uint64_t max_ns;     //!< Worst latency in ns.
+      };
+
+      /*!
+       * \brief Constructor.
+       * \param sink Output for the packets, only called from the sink thread.
+       * \param ring_size Sections / packets in flight between stages.
+       */
+      Pipeline(PacketSink &sink, size_t ring_size = 256);
+      ~Pipeline();
+
+      // prohibit
+      Pipeline(const Pipeline &) = delete;
+      Pipeline &operator=(const Pipeline &) = delete;
+
+      /*!
+       * \brief Pin a stage's thread to a cpu. Takes effect on start().
+       * \param stage Stage to pin.
+       * \param cpu Cpu number, -1 to not pin.
+       */
+      void pin(Stage stage, int cpu);
+
+      //! \brief Start the stage threads.
+      void start();
+
+      /*!
+       * \brief Queue a table for output. Blocks while the queue is full.
+       *
+       * Must always be called from the same thread. The table is only
+       * read by the build thread and must not change until it's built.
+       * \param table Table to build.
+       * \param pid PID to packetize its sections to.
+       * \param urgent Build ahead of (in between the sections of)
+       * non-urgent tables.
+       */
+      void submit(std::shared_ptr<const STable> table, ui16 pid, bool urgent = false);
+
+      /*!
+       * \brief Wait for everything submitted to be written, flush the
+       * sink and stop the threads. start() may be called again after.
+       */
+      void finish();
+
+      /*!
+       * \brief Latency counters for a stage: BUILD is the time to build
+       * each section (a table's first one includes its sizing pass), PACKETIZE from a section being built to its
+       * packets being queued and SINK from a packet being queued to it
+       * being written.
+       */
+      Stats getStats(Stage stage) const;
+
+   private:
+      class Impl;
+      std::unique_ptr<Impl> impl;
+   };
+
+} // sigen namespace
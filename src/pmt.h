@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <list>
+#include "section_writer.h"
 #include "table.h"
 
 namespace sigen {
@@ -91,7 +92,19 @@ namespace sigen {
        * \brief Add a Descriptor to the Program Descriptors loop.
        * \param desc Descriptor to add.
        */
-      bool addProgramDesc(Descriptor& desc);
+      bool addProgramDesc(Descriptor& desc) { return add_program_desc(desc, false); }
+      /*!
+       * \brief Construct a Descriptor in place in the Program Descriptors loop.
+       *
+       * The `D` is built in the table's arena instead of being allocated
+       * on its own, e.g. `pmt.emplaceProgramDesc<CADesc>(casid, ca_pid)`.
+       * \param args Arguments for the `D` constructor.
+       */
+      template <class D, class... Args>
+      bool emplaceProgramDesc(Args&&... args) {
+         return emplace<D>([this](Descriptor& d) { return add_program_desc(d, true); },
+                           std::forward<Args>(args)...);
+      }
       /*!
        * \brief Add an elementary stream to table.
        * \param type Stream type. See PMT::esTypes.
@@ -109,6 +122,15 @@ namespace sigen {
        * \param desc Descriptor to add.
        */
       bool addElemStreamDesc(ui16 elem_pid, Descriptor& desc) { return addItemDesc(es_list, elem_pid, desc); }
+      /*!
+       * \brief Construct a Descriptor in place and add it to the elementary stream specified.
+       * \param elem_pid PID of elementary stream to add descriptor to.
+       * \param args Arguments for the `D` constructor.
+       */
+      template <class D, class... Args>
+      bool emplaceElemStreamDesc(ui16 elem_pid, Args&&... args) {
+         return emplaceItemDesc<D>(es_list, elem_pid, std::forward<Args>(args)...);
+      }
 
 #ifdef ENABLE_DUMP
       virtual void dump(std::ostream &) const;
@@ -120,7 +142,7 @@ namespace sigen {
              MAX_SEC_LEN = 1024 };
 
       // the stream holder struct - private to the pmt
-      struct ElementaryStream : public ExtPSITable::ListItem {
+      struct ElementaryStream final : public ExtPSITable::LoopItem<ElementaryStream> {
          enum { BASE_LEN = 5 };
 
          ui16 elementary_pid : 13;
@@ -135,8 +157,8 @@ namespace sigen {
          virtual ui16 length() const { return 5; }
          virtual bool equals(ui16 pid) const { return pid == elementary_pid; }
 
-         // writes item header bytes, returns num bytes written
-         virtual ui8 write_header(Section& sec) const;
+         // writes item header bytes
+         void write_header(Section& sec) const;
       };
 
       // instance variables
@@ -144,19 +166,9 @@ namespace sigen {
       ui16 pcr_pid : 13;
       DescList prog_desc;
       std::list<ListItem*>& es_list;
+      bool add_program_desc(Descriptor& d, bool in_arena);
 
-      enum State_t { INIT, WRITE_HEAD, GET_PROG_DESC, WRITE_PROG_DESC,
-                     GET_XPORT_STREAM, WRITE_XPORT_STREAM };
-      mutable struct Context {
-         Context() : d_done(false), op_state(INIT), pd(nullptr), es(nullptr) {}
-
-         bool d_done;
-         State_t op_state;
-         const Descriptor* pd;
-         const ListItem* es;
-         std::list<std::unique_ptr<Descriptor> >::const_iterator pd_iter;
-         std::list<ListItem*>::const_iterator es_iter;
-      } run;
+      mutable SectionWriter<ElementaryStream, std::list<ListItem*>, DESC_LOOP_LEN> run;
 
    protected:
       virtual bool writeSection(Section&, ui8, ui16 &) const;
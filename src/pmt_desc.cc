@@ -128,7 +128,7 @@ namespace sigen
    void _DataBroadcastIdDesc::buildSections(Section& s) const
    {
       Descriptor::buildSections(s);
-      s.set16Bits( data_broadcast_id );
+      Layout::write( s, data_broadcast_id );
    }
 
 #ifdef ENABLE_DUMP
@@ -176,9 +176,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set16Bits(original_network_id);
-      s.set16Bits(xport_stream_id);
-      s.set16Bits(new_service_id);
+      Layout::write( s, original_network_id, xport_stream_id, new_service_id );
    }
 
 #ifdef ENABLE_DUMP
@@ -224,9 +222,7 @@ namespace sigen
       // iterate through the list and write the data
       for (const auto &subt : subtitling_list) {
          s.setBits( subt.language_code );
-         s.set08Bits( subt.type );
-         s.set16Bits( subt.composition_page_id );
-         s.set16Bits( subt.ancillary_page_id );
+         SubtitlingLayout::write( s, subt.type, subt.composition_page_id, subt.ancillary_page_id );
       }
    }
 
@@ -238,7 +234,7 @@ namespace sigen
       dumpHeader(o, SUBTITLING_D_S);
 
       // iterate through the list and write the data
-      incOutLevel();
+      incOutLevel(o);
       for (const auto &subt : subtitling_list) {
          identStr(o, LANGUAGE_CODE_S, subt.language_code);
          identStr(o, TYPE_S, subt.type);
@@ -246,7 +242,7 @@ namespace sigen
          identStr(o, ANCILLARY_PAGE_ID_S, subt.ancillary_page_id);
          o << std::endl;
       }
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -279,8 +275,7 @@ namespace sigen
       // iterate through the list and write the data
       for (const auto &teletext : teletext_list) {
          s.setBits( teletext.language_code );
-         s.set08Bits( (teletext.type << 3) | (teletext.magazine_number) );
-         s.set08Bits( teletext.page_number );
+         TeletextLayout::write( s, teletext.type, teletext.magazine_number, teletext.page_number );
       }
    }
 
@@ -292,7 +287,7 @@ namespace sigen
       dumpHeader(o, TELETEXT_D_S);
 
       // iterate through the list and write the data
-      incOutLevel();
+      incOutLevel(o);
       for (const auto &teletext : teletext_list) {
          identStr(o, LANGUAGE_CODE_S, teletext.language_code);
          identStr(o, TYPE_S, teletext.type);
@@ -300,7 +295,7 @@ namespace sigen
          identStr(o, PAGE_NUM_S, teletext.page_number);
          o << std::endl;
       }
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
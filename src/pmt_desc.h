@@ -218,6 +218,11 @@ namespace sigen {
    public:
       enum { TAG = 0x66 };
 
+      //! \brief Layout of the fixed fields, followed by the selector bytes.
+      struct Layout : BitLayout<Field<16>> {
+         enum { DATA_BROADCAST_ID };
+      };
+
       enum {
          DATA_PIPE                               = 0x0001,
          ASYNC_DATA_STREAM                       = 0x0002,
@@ -292,6 +297,11 @@ namespace sigen {
    public:
       enum { TAG = 0x60 };
 
+      //! \brief Layout of the descriptor data.
+      struct Layout : BitLayout<Field<16>, Field<16>, Field<16>> {
+         enum { NEW_ORIGINAL_NETWORK_ID, NEW_TRANSPORT_STREAM_ID, NEW_SERVICE_ID };
+      };
+
       /*!
        * \brief Constructor.
        * \param new_onid Id identifying the new originating network.
@@ -346,6 +356,11 @@ namespace sigen {
    public:
       enum { TAG = 0x59 };
 
+      //! \brief Layout of the fields after each entry's language code.
+      struct SubtitlingLayout : BitLayout<Field<8>, Field<16>, Field<16>> {
+         enum { SUBTITLING_TYPE, COMPOSITION_PAGE_ID, ANCILLARY_PAGE_ID };
+      };
+
       //! \brief Constructor.
       SubtitlingDesc() : Descriptor(TAG) {}
 
@@ -393,6 +408,11 @@ namespace sigen {
    public:
       enum { TAG = 0x56 };
 
+      //! \brief Layout of the fields after each entry's language code.
+      struct TeletextLayout : BitLayout<Field<5>, Field<3>, Field<8>> {
+         enum { TELETEXT_TYPE, MAGAZINE_NUMBER, PAGE_NUMBER };
+      };
+
       /*!
        * \enum  Type
        *
@@ -0,0 +1,192 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// published_table.cc: lock-free publication of rebuilt table sections
+// -----------------------------------
+
+#include <thread>
+#include "descriptor.h"
+#include "published_table.h"
+#include "table.h"
+#include "tstream.h"
+
+namespace sigen
+{
+   struct PublishedTable::Published {
+      std::unique_ptr<TStream> ts;
+      ui8 version;
+   };
+
+   //
+   // Readers announce the epoch they entered at in a slot before
+   // loading the current pointer; the writer swaps the pointer, then
+   // advances the epoch. A reader that could still see a retired
+   // stream must have entered before that advance, so a retired stream
+   // is freed once every occupied slot is at (or past) its epoch.
+   //
+   PublishedTable::PublishedTable()
+      : current(nullptr), epoch(1), next_version(0), has_published(false)
+   {
+      for (ReaderSlot &r : readers) {
+         r.epoch.store(0, std::memory_order_relaxed);
+      }
+   }
+
+   PublishedTable::~PublishedTable()
+   {
+      std::lock_guard<std::mutex> lock(write_mtx);
+      for (auto &r : retired) {
+         delete r.first;
+      }
+      delete current.load();
+   }
+
+
+   //
+   // read side
+   //
+   PublishedTable::Snapshot PublishedTable::acquire() const
+   {
+      for (;;) {
+         for (ReaderSlot &r : readers) {
+            uint64_t e = epoch.load();
+            uint64_t expected = 0;
+            if (r.epoch.load(std::memory_order_relaxed) == 0 &&
+                r.epoch.compare_exchange_strong(expected, e)) {
+               const Published *p = current.load();
+               if (!p) {
+                  r.epoch.store(0, std::memory_order_release);
+                  return Snapshot(nullptr, nullptr);
+               }
+               return Snapshot(&r, p);
+            }
+         }
+         std::this_thread::yield();
+      }
+   }
+
+   PublishedTable::Snapshot::Snapshot(Snapshot &&other)
+      : slot(other.slot), pub(other.pub)
+   {
+      other.slot = nullptr;
+      other.pub = nullptr;
+   }
+
+   void PublishedTable::Snapshot::release()
+   {
+      if (slot) {
+         slot->epoch.store(0, std::memory_order_release);
+         slot = nullptr;
+      }
+      pub = nullptr;
+   }
+
+   const TStream &PublishedTable::Snapshot::stream() const
+   {
+      return *pub->ts;
+   }
+
+   ui8 PublishedTable::Snapshot::getVersionNumber() const
+   {
+      return pub ? pub->version : 0;
+   }
+
+
+   //
+   // write side
+   //
+   ui8 PublishedTable::publish(std::unique_ptr<TStream> ts)
+   {
+      std::lock_guard<std::mutex> lock(write_mtx);
+
+      Published *p = new Published;
+      p->version = next_version;
+
+      if (!has_published) {
+         // keep the version the stream was built with
+         for (const Section *s : ts->section_list) {
+            const ui8 *d = s->getBinaryData();
+            if (s->length() >= 8 && (d[1] & 0x80)) {
+               p->version = (d[5] >> 1) & 0x1f;
+               break;
+            }
+         }
+         has_published = true;
+      }
+      else {
+         for (Section *s : ts->section_list) {
+            if (s->length() >= 8 && (s->getBinaryData()[1] & 0x80)) {
+               s->setVersionNumber(p->version);
+            }
+         }
+      }
+      p->ts = std::move(ts);
+      next_version = (p->version + 1) & 0x1f;
+
+      const Published *old = current.exchange(p);
+      uint64_t retire_epoch = epoch.fetch_add(1) + 1;
+      if (old) {
+         retired.emplace_back(old, retire_epoch);
+      }
+      reclaimLocked();
+      return p->version;
+   }
+
+   ui8 PublishedTable::publish(const STable &table)
+   {
+      std::unique_ptr<TStream> ts(new TStream);
+      table.buildSections(*ts);
+      return publish(std::move(ts));
+   }
+
+   size_t PublishedTable::reclaim()
+   {
+      std::lock_guard<std::mutex> lock(write_mtx);
+      return reclaimLocked();
+   }
+
+   size_t PublishedTable::reclaimLocked()
+   {
+      if (retired.empty()) {
+         return 0;
+      }
+
+      // oldest epoch a reader may have entered at
+      uint64_t min_epoch = UINT64_MAX;
+      for (const ReaderSlot &r : readers) {
+         uint64_t e = r.epoch.load();
+         if (e && e < min_epoch) {
+            min_epoch = e;
+         }
+      }
+
+      auto keep = retired.begin();
+      for (auto &r : retired) {
+         if (r.second <= min_epoch) {
+            delete r.first;
+         }
+         else {
+            *keep++ = r;
+         }
+      }
+      retired.erase(keep, retired.end());
+      return retired.size();
+   }
+
+} // sigen namespace
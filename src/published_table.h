@@ -0,0 +1,147 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// published_table.h: lock-free publication of rebuilt table sections
+// -----------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "types.h"
+
+namespace sigen {
+
+   class STable;
+   class TStream;
+
+   /*!
+    * \brief Versioned handle to the current sections of a table, updated
+    * by atomic pointer swap.
+    *
+    * A writer builds the new sections into a TStream off to the side
+    * (e.g., on a background thread) and publish()es it. Until then,
+    * readers keep getting the old, complete sections. Readers take a
+    * Snapshot without locking; a retired TStream is only freed once no
+    * snapshot taken before its replacement is still held. An output
+    * thread should take a new snapshot at each table repetition (or
+    * section) and not hold it longer than that.
+    *
+    * The version_number of long form sections is set on publish, one
+    * more than the previously published one.
+    */
+   class PublishedTable
+   {
+   private:
+      struct Published;
+      struct alignas(64) ReaderSlot {
+         std::atomic<uint64_t> epoch; // epoch when entered, 0 if free
+      };
+
+   public:
+      enum { MAX_READERS = 32 }; // snapshots held at once
+
+      /*!
+       * \brief Read-side handle to a published TStream, which stays
+       * valid (unchanged) for the life of the snapshot.
+       */
+      class Snapshot
+      {
+      public:
+         Snapshot(Snapshot &&other);
+         ~Snapshot() { release(); }
+
+         // prohibit
+         Snapshot(const Snapshot &) = delete;
+         Snapshot &operator=(const Snapshot &) = delete;
+         Snapshot &operator=(Snapshot &&) = delete;
+
+         //! \brief `false` if nothing has been published yet.
+         bool valid() const { return pub != nullptr; }
+         //! \brief The published sections. Only call if valid().
+         const TStream &stream() const;
+         //! \brief version_number of the published sections.
+         ui8 getVersionNumber() const;
+
+         //! \brief Release the snapshot before it goes out of scope.
+         void release();
+
+      private:
+         friend class PublishedTable;
+         Snapshot(ReaderSlot *s, const Published *p) : slot(s), pub(p) {}
+
+         ReaderSlot *slot;
+         const Published *pub;
+      };
+
+      PublishedTable();
+      //! \brief Destructor. No snapshot may be held.
+      ~PublishedTable();
+
+      // prohibit
+      PublishedTable(const PublishedTable &) = delete;
+      PublishedTable &operator=(const PublishedTable &) = delete;
+
+      /*!
+       * \brief Take a snapshot of the current sections. Lock-free; spins
+       * only if MAX_READERS snapshots are already held.
+       */
+      Snapshot acquire() const;
+
+      /*!
+       * \brief Publish new sections. The first publish keeps the
+       * sections' version_number, later ones set it to the previous
+       * plus one (mod 32). The stream must not be changed after.
+       * \param ts Sections to publish.
+       * \return The version_number published.
+       */
+      ui8 publish(std::unique_ptr<TStream> ts);
+
+      /*!
+       * \brief Build a table's sections and publish() them.
+       * \param table Table to build.
+       * \return The version_number published.
+       */
+      ui8 publish(const STable &table);
+
+      /*!
+       * \brief Free retired streams no longer held by any snapshot
+       * (also done on each publish()).
+       * \return Number of retired streams still held.
+       */
+      size_t reclaim();
+
+   private:
+      std::atomic<const Published *> current;
+      std::atomic<uint64_t> epoch;
+      mutable ReaderSlot readers[MAX_READERS];
+
+      // writer side
+      std::mutex write_mtx;
+      std::vector<std::pair<const Published *, uint64_t> > retired;
+      ui8 next_version;
+      bool has_published;
+
+      size_t reclaimLocked();
+   };
+
+} // sigen namespace
@@ -0,0 +1,86 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// scheduler.cc: time driven tasks (table updates, time ticks)
+// -----------------------------------
+
+#include "clock.h"
+#include "scheduler.h"
+#include "utc.h"
+
+namespace sigen
+{
+   Scheduler::Scheduler(Clock &c) :
+      clock(c), seq(0)
+   {
+   }
+
+   void Scheduler::add(time_t when, time_t period, Task &&task)
+   {
+      size_t slot = tasks.size();
+      if (free_slots.empty())
+         tasks.push_back(std::move(task));
+      else {
+         slot = free_slots.back();
+         free_slots.pop_back();
+         tasks[slot] = std::move(task);
+      }
+      queue.push({ when, period, seq++, slot });
+   }
+
+   void Scheduler::every(time_t period, Task task, time_t first)
+   {
+      if (period <= 0)
+         return;
+      add(first ? first : clock.now(), period, std::move(task));
+   }
+
+   void Scheduler::at(time_t when, Task task)
+   {
+      add(when, 0, std::move(task));
+   }
+
+   size_t Scheduler::runUntil(time_t end)
+   {
+      size_t run = 0;
+      while (!queue.empty() && queue.top().when <= end) {
+         Entry e = queue.top();
+         queue.pop();
+
+         clock.sleepUntil(e.when);
+         if (e.period) {
+            // queued before running, so it keeps its place among the
+            // tasks the task adds
+            queue.push({ e.when + e.period, e.period, seq++, e.task });
+         }
+
+         tasks[e.task](UTC(e.when));
+         run++;
+
+         // frees what a one-off task holds, its slot is reused
+         if (!e.period) {
+            tasks[e.task] = nullptr;
+            free_slots.push_back(e.task);
+         }
+      }
+      clock.sleepUntil(end);
+      return run;
+   }
+
+} // sigen namespace
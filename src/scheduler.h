@@ -0,0 +1,101 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// scheduler.h: time driven tasks (table updates, time ticks)
+// -----------------------------------
+
+#pragma once
+
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <vector>
+#include "types.h"
+
+namespace sigen {
+
+   class Clock;
+   class UTC;
+
+   /*!
+    * \brief Runs tasks at given times and periods against a Clock.
+    *
+    * With the SystemClock it sleeps between tasks; with a SimulatedClock
+    * the clock jumps straight to the next task, so e.g. a day of TDT /
+    * TOT ticks, present / following changes and table rebuilds is run in
+    * the time it takes to build them. Tasks due at the same time run in
+    * the order they were added. Periodic tasks stay on their period
+    * however long a task takes.
+    */
+   class Scheduler
+   {
+   public:
+      //! \brief Task, called with the time it was due.
+      typedef std::function<void(const UTC &)> Task;
+
+      //! \param clock Clock to run against, not owned.
+      explicit Scheduler(Clock &clock);
+
+      /*!
+       * \brief Run a task periodically.
+       * \param period Seconds between runs.
+       * \param task Task to run.
+       * \param first First run, 0 for now.
+       */
+      void every(time_t period, Task task, time_t first = 0);
+      /*!
+       * \brief Run a task once.
+       * \param when Time to run it.
+       * \param task Task to run.
+       */
+      void at(time_t when, Task task);
+
+      /*!
+       * \brief Run the tasks due until a time, waiting on the clock for
+       * each. The clock is left at `end`.
+       * \param end Time to run up to (inclusive).
+       * \return Tasks run.
+       */
+      size_t runUntil(time_t end);
+
+      //! \brief Tasks waiting to run.
+      size_t pending() const { return queue.size(); }
+
+   private:
+      struct Entry {
+         time_t when;
+         time_t period;    // 0 for one-off tasks
+         ui32 seq;         // order added, for ties
+         size_t task;      // index in tasks
+         bool operator>(const Entry &e) const {
+            return when != e.when ? when > e.when : seq > e.seq;
+         }
+      };
+
+      Clock &clock;
+      std::deque<Task> tasks;       // stable as tasks add tasks
+      std::vector<size_t> free_slots; // in tasks, left by one-off tasks
+      std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+      ui32 seq;
+
+      void add(time_t when, time_t period, Task &&task);
+   };
+
+} // sigen namespace
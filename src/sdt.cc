@@ -25,6 +25,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <list>
+#include <unordered_set>
 #include "table.h"
 #include "descriptor.h"
 #include "tstream.h"
@@ -54,104 +55,80 @@ namespace sigen
    }
 
    //
-   // write to the stream
+   // bulk load: checks the batch, then adds it in one pass
    //
-   bool SDT::writeSection(Section& section, ui8 cur_sec, ui16 &sec_bytes) const
+   bool SDT::addServices(const ServiceInfo* services, size_t count)
    {
-      bool done = false, exit = false;
-
-      while (!exit)
-      {
-         switch (run.op_state)
-         {
-           case INIT:
-              run.s_iter = serv_list.begin();
-              run.op_state = WRITE_HEAD;
-
-           case WRITE_HEAD:
-              // common data for every section
-              // if table's length is > available space, we'll
-              // overwrite the section length later on
-              writeSectionHeader(section);
-
-              // section count information
-              section.set08Bits(cur_sec);
-
-              // we don't know the last section number yet, so
-              // for now set it to 0,
-              section.set08Bits(0);
-
-              section.set16Bits(original_network_id);
-              section.set08Bits( rbits(0xff) ); // reserved (8)
-
-              sec_bytes = BASE_LENGTH; // the minimum section size
-              run.op_state = (!run.serv ? GET_SERVICE : WRITE_SERVICE);
-              break;
-
-           case GET_SERVICE:
-              // fetch the next service
-              if (run.s_iter != serv_list.end()) {
-                 run.serv = (*run.s_iter++);
-
-                 if (!run.serv->descriptors.empty()) {
-                    const Descriptor *d = run.serv->descriptors.front().get();
-
-                    // check if we can fit it with at least one descriptor
-                    if (sec_bytes + Service::BASE_LEN + d->length() >
-                        getMaxDataLen()) {
-                       // we can't, so let's get another section to write
-                       // this service to
-                       run.op_state = WRITE_HEAD;
-                       exit = true;
-                       break;
-                    }
-                 }
-                 else {
-                    // no descriptors.. can we add the empty service?
-                    if ( (sec_bytes + Service::BASE_LEN) > getMaxDataLen() ) {
-                       run.op_state = WRITE_HEAD;
-                       exit = true;
-                       break;
-                    }
-                 }
-                 // we can add it
-                 run.op_state = WRITE_SERVICE;
-              }
-              else {
-                 // done with all services.. all sections are done!
-                 run = Context();
-                 exit = done = true;
-                 break;
-              }
-              break;
-
-           case WRITE_SERVICE:
-              // try to write it
-              if (!(*run.serv).write_section(section, getMaxDataLen(), sec_bytes)) {
-                 run.op_state = WRITE_HEAD;
-                 exit = true;
-                 break;
-              }
-              run.op_state = GET_SERVICE;
-              break;
+      ui32 len = 0;
+      for (size_t i = 0; i < count; i++) {
+         if (!RawDesc::isValidLoop(services[i].desc_data, services[i].desc_len))
+            return false;
+         len += Service::BASE_LEN + services[i].desc_len;
+      }
+
+#ifdef CHECK_DUPLICATES
+      std::unordered_set<ui16> ids;
+      for (const ListItem* item : serv_list)
+         ids.insert(static_cast<const Service*>(item)->id);
+
+      for (size_t i = 0; i < count; i++) {
+         if (!ids.insert(services[i].service_id).second) {
+            std::stringstream err;
+            err << "Attempt to add duplicate service with id " << std::hex << services[i].service_id;
+            throw std::range_error(err.str());
          }
       }
-      return done;
+#endif
+
+      if ( !incLength(len) )
+         return false;
+
+      for (size_t i = 0; i < count; i++) {
+         const ServiceInfo& si = services[i];
+         Service* serv = new Service(si.service_id, si.eit_schedule_flag, si.eit_present_following_flag,
+                                     si.running_status, si.free_CA_mode);
+         addRawDescs(serv, si.desc_data, si.desc_len);
+         serv_list.push_back(serv);
+      }
+      return true;
+   }
+
+   //
+   // write to the stream
+   //
+   bool SDT::writeSection(Section& section, ui8 cur_sec, ui16 &sec_bytes) const
+   {
+      return run.write(section, sec_bytes, BASE_LENGTH, getMaxDataLen(),
+                       [&](Section& s) {
+                          // common data for every section
+                          // if table's length is > available space, we'll
+                          // overwrite the section length later on
+                          writeSectionHeader(s);
+
+                          // section count information
+                          s.set08Bits(cur_sec);
+
+                          // we don't know the last section number yet, so
+                          // for now set it to 0,
+                          s.set08Bits(0);
+
+                          s.set16Bits(original_network_id);
+                          s.set08Bits( rbits(0xff) ); // reserved (8)
+                       },
+                       nullptr, &serv_list);
    }
 
 
    //
    // data writers for SDT::Service
    //
-   ui8 SDT::Service::write_header(Section& section) const
+   void SDT::Service::write_header(Section& section) const
    {
       // write the service data
       section.set16Bits(id);
       section.set08Bits( rbits(0xfc) |
                          eit_schedule |
                          eit_present_following );
-
-      return SDT::Service::BASE_LEN - 2;
    }
 
    void SDT::Service::write_desc_loop_len(Section& section, ui8* pos, ui16 len) const
@@ -179,7 +156,7 @@ namespace sigen
       o << std::endl;
 
       // display the service list
-      incOutLevel();
+      incOutLevel(o);
       headerStr(o, SERVICE_LIST_S);
 
       for (const ListItem* item : serv_list) {
@@ -199,7 +176,7 @@ namespace sigen
 
          o << std::endl;
       }
-      decOutLevel();
+      decOutLevel(o);
 
       o << std::endl;
    }
@@ -24,6 +24,7 @@
 
 #include <memory>
 #include <list>
+#include "section_writer.h"
 #include "table.h"
 
 namespace sigen {
@@ -45,6 +46,17 @@ namespace sigen {
       };
       enum { ACTUAL_TID = 0x42, OTHER_TID = 0x46 };
 
+      //! \brief A service for addServices().
+      struct ServiceInfo {
+         ui16 service_id;                 //!< Unique id of service within the TS.
+         bool eit_schedule_flag;          //!< EIT-schedule information present in current TS.
+         bool eit_present_following_flag; //!< EIT-PF present in current TS.
+         ui8 running_status;              //!< See sigen::Dvb::RunningStatus_t.
+         bool free_CA_mode;               //!< One or more components are scrambled.
+         const ui8* desc_data;            //!< Serialized descriptor loop (may be `nullptr`).
+         ui16 desc_len;                   //!< Length of the descriptor loop.
+      };
+
       /*!
        * \brief Add a service to the table.
        * \param service_id Unique id of service within the TS.
@@ -66,6 +78,30 @@ namespace sigen {
        * \param desc Descriptor to add.
        */
       bool addServiceDesc(ui16 service_id, Descriptor& desc) { return addItemDesc(serv_list, service_id, desc); }
+      /*!
+       * \brief Construct a Descriptor in place and add it to the service specified.
+       *
+       * The `D` is built in the table's arena instead of being allocated
+       * on its own, e.g. `sdt.emplaceServiceDesc<ServiceDesc>(sid, type, provider, name)`.
+       * \param service_id Id of service to add descriptor to.
+       * \param args Arguments for the `D` constructor.
+       */
+      template <class D, class... Args>
+      bool emplaceServiceDesc(ui16 service_id, Args&&... args) {
+         return emplaceItemDesc<D>(serv_list, service_id, std::forward<Args>(args)...);
+      }
+
+      /*!
+       * \brief Add a batch of services with their descriptors.
+       *
+       * The lengths are checked once for the whole batch, which is added
+       * entirely or not at all.
+       * \param services Services to add.
+       * \param count Number of services.
+       * \return `false` if a descriptor loop is malformed or the table
+       * would be too long.
+       */
+      bool addServices(const ServiceInfo* services, size_t count);
 
 #ifdef ENABLE_DUMP
       virtual void dump(std::ostream &) const;
@@ -75,7 +111,7 @@ namespace sigen {
       enum { MAX_SEC_LEN = 1024 };
 
       // the service holder class - private to the sdt
-      struct Service : public ExtPSITable::ListItem {
+      struct Service final : public ExtPSITable::LoopItem<Service> {
          enum { BASE_LEN = 5 };
 
          ui16 id;
@@ -94,24 +130,17 @@ namespace sigen {
          virtual ui16 length() const { return 5; }
          virtual bool equals(ui16 sid) const { return sid == id; }
 
-         // writes item header bytes, returns num bytes written
-         virtual ui8 write_header(Section& sec) const;
+         // writes item header bytes
+         void write_header(Section& sec) const;
          // writes the 2-byte desc loop len
-         virtual void write_desc_loop_len(Section& sec, ui8* pos, ui16 len) const;
+         void write_desc_loop_len(Section& sec, ui8* pos, ui16 len) const;
       };
 
       // sdt data members begin here
       ui16 original_network_id;
       std::list<ListItem*>& serv_list;
 
-      enum State_t { INIT, WRITE_HEAD, GET_SERVICE, WRITE_SERVICE };
-      mutable struct Context {
-         Context() : op_state(INIT), serv(nullptr) {}
-         
-         State_t op_state;
-         const ListItem* serv;
-         std::list<ListItem*>::const_iterator s_iter;
-      } run;
+      mutable SectionWriter<Service, std::list<ListItem*> > run;
 
    protected:
       // constructor
@@ -74,7 +74,7 @@ namespace sigen
    {
       dumpHeader(o, MULTILING_SERV_NAME_D_S);
 
-      incOutLevel();
+      incOutLevel(o);
       for (const auto &lang : language_list) {
          identStr(o, CODE_S, lang.language_code);
          identStr(o, PROV_NAME_LEN_S, lang.provider_name.length());
@@ -82,7 +82,7 @@ namespace sigen
          identStr(o, SERVICE_NAME_LEN_S, lang.service_name.length());
          identStr(o, SERVICE_NAME_S, lang.service_name);
       }
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -110,11 +110,9 @@ namespace sigen
       Descriptor::buildSections(s);
 
       // cycle through the list and write the bytes
-      for (const auto &ident : ident_list) {
-         s.set16Bits( ident.xport_stream_id );
-         s.set16Bits( ident.original_network_id );
-         s.set16Bits( ident.service_id );
-      }
+      for (const auto &ident : ident_list)
+         ReferenceLayout::write( s, ident.xport_stream_id, ident.original_network_id,
+                                 ident.service_id );
    }
 
 #ifdef ENABLE_DUMP
@@ -125,14 +123,14 @@ namespace sigen
       dumpHeader(o, NVOD_REF_D_S);
 
       // dump the descriptor's data
-      incOutLevel();
+      incOutLevel(o);
       for (const auto &ident : ident_list) {
          identStr(o, XPORT_STREAM_ID_S, ident.xport_stream_id);
          identStr(o, ORIG_NETWORK_ID_S, ident.original_network_id);
          identStr(o, SERVICE_ID_S, ident.service_id);
          o << std::endl;
       }
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -149,7 +147,7 @@ namespace sigen
    {
       Descriptor::buildSections(s);
 
-      s.set08Bits( type );
+      Layout::write( s, type );
 
       s.set08Bits( provider_name.length() );
       s.setBits( provider_name );
@@ -97,6 +97,11 @@ namespace sigen {
    public:
       enum { TAG = 0x4b };
 
+      //! \brief Layout of each reference entry.
+      struct ReferenceLayout : BitLayout<Field<16>, Field<16>, Field<16>> {
+         enum { TRANSPORT_STREAM_ID, ORIGINAL_NETWORK_ID, SERVICE_ID };
+      };
+
       //! \brief Constructor.
       NVODReferenceDesc() : Descriptor(TAG) {}
 
@@ -141,13 +146,18 @@ namespace sigen {
    public:
       enum { TAG = 0x48 };
 
+      //! \brief Layout of the fixed fields, followed by the names.
+      struct Layout : BitLayout<Field<8>> {
+         enum { SERVICE_TYPE };
+      };
+
       /*!
        * \brief Constructor.
        * \param serv_type Type of the service, as per Dvb::ServiceType_t.
        * \param prov_name Name of the service provider.
        * \param serv_name Name of the service.
        */
-      ServiceDesc(ui8 serv_type, const std::string& prov_name, const std::string& serv_name) :
+      ServiceDesc(ui8 serv_type, StrView prov_name, StrView serv_name) :
          Descriptor(TAG, 3),
          provider_name( incLength( prov_name ) ),
          name( incLength(serv_name) ),
@@ -0,0 +1,311 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// section_writer.h: templated section writing engine for the PSI tables
+// -----------------------------------
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include "descriptor.h"
+#include "table.h"
+#include "tstream.h"
+
+namespace sigen {
+
+   //
+   // item type for the tables with only a descriptor loop (CAT)
+   struct PSITable::NoItem {
+      ui16 fit_length() const { return 0; }
+      bool write_section(Section&, ui16, ui16&, ui16*) const { return true; }
+   };
+
+   //
+   // resumable section writer shared by the PSI tables. Each table
+   // used to carry its own switch based state machine - they only
+   // differed in the fixed header fields, the optional top descriptor
+   // loop, the item type and where the loop lengths go. Those are now
+   // the template arguments, so the item writers are called on their
+   // final type and inline into the loop.
+   //
+   // Item must provide fit_length() (bytes that must fit before it's
+   // started in a section) and write_section(), which returns false
+   // if the item was split. List holds either Item's or pointers to
+   // its base.
+   //
+   template <class Item, class List, ui8 LAYOUT>
+   class PSITable::SectionWriter
+   {
+   public:
+      SectionWriter() : d_done(false), op_state(INIT), d(nullptr), item(nullptr) {}
+
+      // writes the next section, header() writing the table specific
+      // fields after the table header. Returns true once all sections
+      // are done
+      template <class Header>
+      bool write(Section& section, ui16& sec_bytes, ui16 base_len, ui16 max_data_len,
+                 Header header, const DescList* descs, const List* items);
+
+   private:
+      enum State_t { INIT, WRITE_HEAD, GET_DESC, WRITE_DESC, WRITE_ITEM_LOOP_LEN,
+                     GET_ITEM, WRITE_ITEM };
+
+      bool d_done;
+      State_t op_state;
+      const Descriptor* d;
+      const Item* item;
+      DescList::const_iterator d_iter;
+      typename List::const_iterator i_iter;
+
+      static const Item* get(const Item& i) { return &i; }
+      template <class Base>
+      static const Item* get(const Base* b) { return static_cast<const Item*>(b); }
+   };
+
+
+   template <class Item, class List, ui8 LAYOUT>
+   template <class Header>
+   bool PSITable::SectionWriter<Item, List, LAYOUT>::write(Section& section, ui16& sec_bytes,
+                                                          ui16 base_len, ui16 max_data_len,
+                                                          Header header, const DescList* descs,
+                                                          const List* items)
+   {
+      ui8 *d_loop_len_pos = nullptr, *i_loop_len_pos = nullptr;
+      ui16 d_len, d_loop_len = 0, i_loop_len = 0;
+      bool done = false, exit = false;
+
+      while (!exit)
+      {
+         switch (op_state)
+         {
+           case INIT:
+              // associate the iterators to the lists
+              if (descs)
+                 d_iter = descs->begin();
+              if (items)
+                 i_iter = items->begin();
+              op_state = WRITE_HEAD;
+              // fall through
+
+           case WRITE_HEAD:
+              // common data for every section plus the table's fields
+              header(section);
+
+              if (LAYOUT & DESC_LOOP_LEN) {
+                 // save the position for the descriptor loop length,
+                 // always updated in GET_DESC
+                 d_loop_len_pos = section.getCurDataPosition();
+                 section.set16Bits( 0 );
+              }
+
+              sec_bytes = base_len; // the minimum section size
+              op_state = (!d ? GET_DESC : WRITE_DESC);
+              break;
+
+           case GET_DESC:
+              if (LAYOUT & DESC_LOOP_LEN)
+                 section.set16Bits(d_loop_len_pos,
+                                   rbits(~LEN_MASK) |
+                                   (d_loop_len & LEN_MASK) );
+
+              if (descs && !d_done) {
+                 // fetch the next descriptor
+                 if (d_iter != descs->end()) {
+                    d = (*d_iter++).get();
+
+                    // check if we can fit it in this section
+                    if (sec_bytes + d->length() > max_data_len) {
+                       // the item loop length must still be written
+                       // in a section filled with descriptors
+                       if (LAYOUT & ITEM_LOOP_LEN) {
+                          i_loop_len_pos = section.getCurDataPosition();
+                          section.set16Bits( 0 );
+                       }
+                       // we'll add it to the next one
+                       op_state = WRITE_HEAD;
+                       exit = true;
+                    }
+                    else
+                       op_state = WRITE_DESC;
+                    break;
+                 }
+                 d = nullptr;
+                 d_done = true;
+              }
+
+              // done with the descriptors.. move on to the items
+              op_state = ( (LAYOUT & ITEM_LOOP_LEN) ? WRITE_ITEM_LOOP_LEN :
+                           (!item ? GET_ITEM : WRITE_ITEM) );
+              break;
+
+           case WRITE_DESC:
+              d->buildSections(section);
+
+              d_len = d->length();
+              sec_bytes += d_len;
+              d_loop_len += d_len;
+
+              // try to add another one
+              op_state = GET_DESC;
+              break;
+
+           case WRITE_ITEM_LOOP_LEN:
+              // overwritten once the section is done
+              i_loop_len_pos = section.getCurDataPosition();
+              section.set16Bits( 0 );
+
+              // if we were looking at one already, don't get a new item
+              op_state = (!item ? GET_ITEM : WRITE_ITEM);
+              break;
+
+           case GET_ITEM:
+              if (items && i_iter != items->end()) {
+                 item = get(*i_iter++);
+
+                 // the item must fit with its first descriptor
+                 if (sec_bytes + item->fit_length() > max_data_len) {
+                    op_state = WRITE_HEAD;
+                    exit = true;
+                    break;
+                 }
+                 op_state = WRITE_ITEM;
+              }
+              else {
+                 // no more descriptors or items, so all sections are
+                 // done!
+                 *this = SectionWriter();
+                 exit = done = true;
+              }
+              break;
+
+           case WRITE_ITEM:
+              if (!item->write_section(section, max_data_len, sec_bytes,
+                                       (LAYOUT & ITEM_LOOP_LEN) ? &i_loop_len : nullptr)) {
+                 op_state = WRITE_HEAD;
+                 exit = true;
+                 break;
+              }
+              op_state = GET_ITEM;
+              break;
+         }
+      }
+
+      if (LAYOUT & ITEM_LOOP_LEN)
+         section.set16Bits( i_loop_len_pos,
+                            rbits(~LEN_MASK) |
+                            (i_loop_len & LEN_MASK) );
+      return done;
+   }
+
+
+   //
+   // descriptor loop items
+   //
+   // general case. Some tables will define their own (e.g., SDT, EIT)
+   inline void ExtPSITable::ListItem::write_desc_loop_len(Section& section, ui8* pos, ui16 len) const
+   {
+      section.set16Bits( pos, rbits(~LEN_MASK) | (len & LEN_MASK) );
+   }
+
+   template <class Self>
+   ui16 ExtPSITable::LoopItem<Self>::fit_length() const
+   {
+      // try to fit at least one descriptor with the item
+      return Self::BASE_LEN + (descriptors.empty() ? 0 : descriptors.front()->length());
+   }
+
+   template <class Self>
+   bool ExtPSITable::LoopItem<Self>::write_section(Section& section, ui16 max_data_len,
+                                                   ui16& sec_bytes, ui16* loop_len_ptr) const
+   {
+      const Self& self = static_cast<const Self&>(*this);
+      ui8* desc_loop_len_pos = 0;
+      ui16 d_len, desc_loop_len = 0;
+      bool exit = false, done = false;
+
+      while (!exit)
+      {
+         switch (run.op_state)
+         {
+           case INIT:
+              // set the descriptor iterator
+              run.d_iter = descriptors.begin();
+              run.op_state = WRITE_HEAD;
+              // fall through
+
+           case WRITE_HEAD:
+              // the header is rewritten in each section the item is
+              // split over
+              self.write_header(section);
+
+              // save the position for the desc loop len.. we'll update it later
+              desc_loop_len_pos = section.getCurDataPosition();
+              section.set16Bits( 0 );
+
+              // increment the byte count
+              sec_bytes += Self::BASE_LEN;
+              if (loop_len_ptr)
+                 *loop_len_ptr += Self::BASE_LEN;
+
+              run.op_state = (!run.d ? GET_DESC : WRITE_DESC);
+              break;
+
+           case GET_DESC:
+              // if we have descriptors available..
+              if (run.d_iter != descriptors.end()) {
+                 run.d = (*run.d_iter++).get();
+
+                 // make sure we can fit the next one
+                 if ( (sec_bytes + run.d->length()) > max_data_len ) {
+                    run.op_state = WRITE_HEAD;
+                    exit = true;
+                    break;
+                 }
+                 run.op_state = WRITE_DESC;
+              }
+              else {
+                 // no more descriptors.. done writing this item
+                 run = Context();
+                 exit = done = true;
+              }
+              break;
+
+           case WRITE_DESC:
+              run.d->buildSections(section);
+
+              // increment all byte counts
+              d_len = run.d->length();
+              sec_bytes += d_len;
+              if (loop_len_ptr)
+                 *loop_len_ptr += d_len;
+              desc_loop_len += d_len;
+
+              // try to get another one
+              run.op_state = GET_DESC;
+              break;
+         }
+      }
+      // write the desc loop length
+      self.write_desc_loop_len(section, desc_loop_len_pos, desc_loop_len);
+
+      return done;
+   }
+
+} // namespace
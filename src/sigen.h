@@ -31,7 +31,10 @@
 #include "tstream.h"
 #include "packetizer.h"
 #include "utc.h"
+#include "clock.h"
 #include "language_code.h"
+#include "str_view.h"
+#include "text_encoder.h"
 #include "dump.h"
 
 #include "table.h"
@@ -40,11 +43,24 @@
 #include "pat.h"
 #include "pmt.h"
 #include "cat.h"
+#include "event_store.h"
 #include "eit.h"
 #include "tdt.h"
 #include "tot.h"
 #include "other_tables.h"
+#include "live_time.h"
+#include "static_table.h"
+#include "sink.h"
+#include "file_sink.h"
+#include "async_sink.h"
+#include "udp_sink.h"
+#include "paced_sink.h"
+#include "pipeline.h"
+#include "published_table.h"
+#include "multiplex.h"
+#include "scheduler.h"
 
+#include "bit_layout.h"
 #include "descriptor.h"
 #include "dvb_desc.h"
 #include "mpeg_desc.h"
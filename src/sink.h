@@ -0,0 +1,51 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// sink.h: interface for transport stream packet outputs
+// -----------------------------------
+
+#pragma once
+
+#include <cstddef>
+#include "types.h"
+
+namespace sigen {
+
+   /*!
+    * \brief Abstract destination for transport stream packets.
+    */
+   class PacketSink
+   {
+   public:
+      enum { PACKET_SIZE = 188 };   //!< TS packet size in bytes.
+
+      virtual ~PacketSink() {}
+
+      /*!
+       * \brief Write consecutive packets.
+       * \param packets Packet data, count * PACKET_SIZE bytes.
+       * \param count Number of packets.
+       */
+      virtual void write(const ui8 *packets, size_t count) = 0;
+
+      //! \brief Push out anything buffered.
+      virtual void flush() {}
+   };
+
+} // sigen namespace
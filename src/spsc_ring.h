@@ -0,0 +1,118 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// spsc_ring.h: lock-free single producer / single consumer ring
+// -----------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace sigen {
+
+   //
+   // bounded ring for handing items from one thread to another. The
+   // producer claims a slot, fills it in place and publishes it; the
+   // consumer peeks at the run of published slots and releases them once
+   // done. Capacity is rounded up to a power of 2
+   //
+   template <typename T>
+   class SpscRing
+   {
+   public:
+      explicit SpscRing(size_t capacity) : slots(roundUp(capacity)), mask(slots.size() - 1) {}
+
+      // prohibit
+      SpscRing(const SpscRing &) = delete;
+      SpscRing &operator=(const SpscRing &) = delete;
+
+      size_t capacity() const { return slots.size(); }
+      // position of a slot, for data kept alongside the ring
+      size_t index(const T *slot) const { return slot - slots.data(); }
+      bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+
+      // producer: next free slot or nullptr if full
+      T *claim() {
+         size_t t = tail.load(std::memory_order_relaxed);
+         if (t - head.load(std::memory_order_acquire) == slots.size())
+            return nullptr;
+         return &slots[t & mask];
+      }
+      // producer: makes the claimed slot visible to the consumer
+      void publish() {
+         tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+      }
+      bool push(const T &v) {
+         T *slot = claim();
+         if (!slot)
+            return false;
+         *slot = v;
+         publish();
+         return true;
+      }
+
+      // consumer: first published slot, n is set to the number of
+      // contiguous published slots from it
+      T *peek(size_t &n) {
+         size_t h = head.load(std::memory_order_relaxed);
+         size_t avail = tail.load(std::memory_order_acquire) - h;
+         size_t idx = h & mask;
+         n = std::min(avail, slots.size() - idx);
+         return n ? &slots[idx] : nullptr;
+      }
+      // consumer: frees n slots for the producer
+      void release(size_t n) {
+         head.store(head.load(std::memory_order_relaxed) + n, std::memory_order_release);
+      }
+      bool pop(T &v) {
+         size_t n;
+         T *slot = peek(n);
+         if (!slot)
+            return false;
+         v = *slot;
+         release(1);
+         return true;
+      }
+
+   private:
+      enum { CACHE_LINE = 64 };
+
+      std::vector<T> slots;
+      const size_t mask;
+
+      // the indices are kept on their own cache lines so the two
+      // threads don't false-share
+      char pad0[CACHE_LINE];
+      std::atomic<size_t> head{0};     // written by the consumer
+      char pad1[CACHE_LINE - sizeof(std::atomic<size_t>)];
+      std::atomic<size_t> tail{0};     // written by the producer
+      char pad2[CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+      static size_t roundUp(size_t c) {
+         size_t p = 1;
+         while (p < c)
+            p <<= 1;
+         return p;
+      }
+   };
+
+} // sigen namespace
@@ -67,8 +67,7 @@ namespace sigen
       s.set08Bits( OUI_data_length );
 
       for (const OUIData &oui : oui_list) {
-         s.set24Bits( oui.OUI );
-         s.set08Bits( oui.selector_bytes.size() );
+         OUILayout::write( s, oui.OUI, oui.selector_bytes.size() );
          s.setBits( oui.selector_bytes );
       }
 
@@ -85,14 +84,14 @@ namespace sigen
 
       identStr(o, OUI_DATA_LEN_S, OUI_data_length);
 
-      incOutLevel();
+      incOutLevel(o);
       for (const OUIData &oui : oui_list) {
          identStr(o, OUI_S, oui.OUI);
          identStr(o, SELECTOR_LEN_S, oui.selector_bytes.size());
          identStr(o, SELECTOR_S, oui.selector_bytes);
       }
 
-      decOutLevel();
+      decOutLevel(o);
       identStr(o, PVT_DATA_S, private_data);
    }
 #endif
@@ -158,10 +157,8 @@ namespace sigen
       s.set08Bits( OUI_data_len );
 
       for (const auto &oui : oui_list) {
-         s.set24Bits( oui.OUI );
-         s.set08Bits( rbits(0xf0) | oui.update_type );
-         s.set08Bits( rbits(0xc0) | (oui.update_versioning_flag << 5) | oui.update_version );
-         s.set08Bits( oui.selector_bytes.size() );
+         OUILayout::write( s, oui.OUI, oui.update_type, oui.update_versioning_flag,
+                           oui.update_version, oui.selector_bytes.size() );
          if ( oui.selector_bytes.size() )
             s.setBits( oui.selector_bytes );
       }
@@ -176,7 +173,7 @@ namespace sigen
 
       identStr(o, OUI_DATA_LEN_S, OUI_data_len);
 
-      incOutLevel();
+      incOutLevel(o);
       for (const auto &oui : oui_list) {
          identStr(o, OUI_S, oui.OUI);
          identStr(o, RESERVED_S, 0x0f);
@@ -187,7 +184,7 @@ namespace sigen
          identStr(o, SELECTOR_LEN_S, oui.selector_bytes.size());
          identStr(o, SELECTOR_S, oui.selector_bytes);
       }
-      decOutLevel();
+      decOutLevel(o);
 
       identStr(o, PVT_DATA_S, private_data);
    }
@@ -45,6 +45,11 @@ namespace sigen {
    class SSULinkageDesc : public LinkageDesc
    {
    public:
+      //! \brief Layout of each OUI entry, followed by its selector bytes.
+      struct OUILayout : BitLayout<Field<24>, Field<8>> {
+         enum { OUI, SELECTOR_LENGTH };
+      };
+
       /*!
        * \brief Constructor
        * \param xs_id Id uniquely identifying the transport stream.
@@ -143,6 +148,12 @@ namespace sigen {
    class SSUDataBroadcastIdDesc : public _DataBroadcastIdDesc
    {
    public:
+      //! \brief Layout of each OUI entry, followed by its selector bytes.
+      struct OUILayout : BitLayout<Field<24>, Reserved<4>, Field<4>, Reserved<2>, Field<1>,
+                                   Field<5>, Field<8>> {
+         enum { OUI, UPDATE_TYPE, UPDATE_VERSIONING_FLAG, UPDATE_VERSION, SELECTOR_LENGTH };
+      };
+
       /*! \enum UpdateType
        *  \brief Update type coding.
        */
@@ -0,0 +1,273 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// static_table.h: compile time construction of fixed tables and
+//                 descriptors
+// -----------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include "crc.h"
+#include "mpeg_desc.h"
+#include "nit_bat.h"
+#include "nit_desc.h"
+#include "types.h"
+
+namespace sigen {
+
+   /*! \addtogroup abstract
+    *  @{
+    */
+
+   /*!
+    * \brief Section (or descriptor) bytes built in a constant expression.
+    *
+    * SI that never changes can be built with the StaticSI functions
+    * into a `static constexpr` StaticSection. The finished bytes, CRC
+    * included, then go straight into read-only data and cost nothing at
+    * startup or on a rebuild. Writing past `N` bytes fails to compile.
+    * Send them with MpgPacketizer::packetize(getBinaryData(), length(), ...)
+    * or copy them into a Section with Section::assign().
+    */
+   template <ui16 N>
+   class StaticSection
+   {
+   public:
+      constexpr StaticSection() : data(), len(0) { }
+
+      // accessors
+      constexpr const ui8 *getBinaryData() const { return data; }
+      constexpr ui16 length() const { return len; }
+      constexpr ui8 operator[](ui16 idx) const { return data[idx]; }
+
+      // utility
+      constexpr void set08Bits(ui8 d) { data[len++] = d; }
+      constexpr void set16Bits(ui16 d) {
+         set08Bits(d >> 8);
+         set08Bits(d & 0xff);
+      }
+      constexpr void set32Bits(ui32 d) {
+         set16Bits(d >> 16);
+         set16Bits(d & 0xffff);
+      }
+      constexpr void setBits(const char *d, ui16 l) {
+         for (ui16 i = 0; i < l; i++)
+            set08Bits(d[i]);
+      }
+      template <ui16 M>
+      constexpr void setBits(const StaticSection<M> &s) {
+         for (ui16 i = 0; i < s.length(); i++)
+            set08Bits(s[i]);
+      }
+      template <ui16 M>
+      constexpr void setBits(const bit_layout_priv::Bytes<M> &b) {
+         for (ui16 i = 0; i < M; i++)
+            set08Bits(b.data[i]);
+      }
+      constexpr void calcCrc() { set32Bits( crc32(data, len) ); }
+
+   private:
+      ui8 data[N];
+      ui16 len;
+   };
+   //! @}
+
+   /*!
+    * \brief Constant expression builders for StaticSection's.
+    *
+    * Each writes the same bytes as the runtime table or descriptor
+    * class of the same name, e.g.:
+    *
+    *     static constexpr auto nit =
+    *        StaticSI::nit(0x10, 1, true,
+    *                      StaticSI::descLoop(),
+    *                      StaticSI::descLoop(
+    *                         StaticSI::xportStream(1, 0x20, StaticSI::descLoop(
+    *                            StaticSI::cableDeliverySystemDesc(...)))));
+    */
+   namespace StaticSI {
+
+      namespace priv {
+         constexpr ui16 sum() { return 0; }
+         template <class... T>
+         constexpr ui16 sum(ui16 n, T... rest) { return n + sum(rest...); }
+
+         template <ui16 N>
+         constexpr void append(StaticSection<N> &) { }
+         template <ui16 N, ui16 M, ui16... R>
+         constexpr void append(StaticSection<N> &s, const StaticSection<M> &part,
+                               const StaticSection<R>&... rest) {
+            s.setBits(part);
+            append(s, rest...);
+         }
+
+         enum { LEN_MASK = 0x0fff, MAX_SEC_LEN = 1024, MAX_PRIVATE_SEC_LEN = 4096 };
+      }
+
+      // ---------------------------------------
+      // descriptors
+      //
+
+      //! \brief CableDeliverySystemDesc.
+      constexpr StaticSection<13> cableDeliverySystemDesc(ui32 freq, ui32 sym_rate, ui8 fec_o,
+                                                          ui8 mod, ui8 fec_i)
+      {
+         using Layout = CableDeliverySystemDesc::Layout;
+         StaticSection<13> s;
+         s.set08Bits(CableDeliverySystemDesc::TAG);
+         s.set08Bits(Layout::LENGTH);
+         s.setBits( Layout::pack(freq, fec_o, mod, sym_rate, fec_i) );
+         return s;
+      }
+
+      //! \brief SatelliteDeliverySystemDesc, DVB-S2 when a roll off is given.
+      constexpr StaticSection<13> satelliteDeliverySystemDesc(ui32 freq, ui16 orb_pos, ui32 sym_rate,
+                                                              bool wef, ui8 pol, ui8 mod_type,
+                                                              ui8 fec_i, int rof = -1)
+      {
+         using Layout = SatelliteDeliverySystemDesc::Layout;
+         StaticSection<13> s;
+         s.set08Bits(SatelliteDeliverySystemDesc::TAG);
+         s.set08Bits(Layout::LENGTH);
+         s.setBits( Layout::pack(freq, orb_pos, wef, pol, (rof < 0 ? 0 : rof),
+                                 (rof < 0 ? Dvb::Sat::MODSYS_DVB_S : Dvb::Sat::MODSYS_DVB_S2),
+                                 mod_type, sym_rate, fec_i) );
+         return s;
+      }
+
+      //! \brief TerrestrialDeliverySystemDesc.
+      constexpr StaticSection<13> terrestrialDeliverySystemDesc(ui32 cfreq, ui8 bandw, ui8 constel,
+                                                                ui8 hier_i, ui8 cr_HP, ui8 cr_LP,
+                                                                ui8 guard_i, ui8 trans_m, bool other_f_f,
+                                                                ui8 pri = 1, bool t_s_i = true,
+                                                                bool mpe_fec_i = true)
+      {
+         using Layout = TerrestrialDeliverySystemDesc::Layout;
+         StaticSection<13> s;
+         s.set08Bits(TerrestrialDeliverySystemDesc::TAG);
+         s.set08Bits(Layout::LENGTH);
+         s.setBits( Layout::pack(cfreq, bandw, pri, t_s_i, mpe_fec_i, constel, hier_i,
+                                 cr_HP, cr_LP, guard_i, trans_m, other_f_f) );
+         return s;
+      }
+
+      //! \brief CADesc with private data bytes (a string literal).
+      template <size_t L>
+      constexpr StaticSection<6 + L - 1> caDesc(ui16 casid, ui16 ca_pid, const char (&data)[L])
+      {
+         StaticSection<6 + L - 1> s;
+         s.set08Bits(CADesc::TAG);
+         s.set08Bits(4 + L - 1);
+         s.setBits( CADesc::Layout::pack(casid, ca_pid) );
+         s.setBits(data, L - 1);
+         return s;
+      }
+
+      //! \brief CADesc without private data.
+      constexpr StaticSection<6> caDesc(ui16 casid, ui16 ca_pid) { return caDesc(casid, ca_pid, ""); }
+
+      // ---------------------------------------
+      // loops and their items
+      //
+
+      //! \brief Descriptor (or transport stream) loop, with its 12-bit length.
+      template <ui16... N>
+      constexpr StaticSection<2 + priv::sum(N...)> descLoop(const StaticSection<N>&... parts)
+      {
+         StaticSection<2 + priv::sum(N...)> s;
+         s.set16Bits(0xf000 | (priv::sum(N...) & priv::LEN_MASK));
+         priv::append(s, parts...);
+         return s;
+      }
+
+      //! \brief PAT program loop entry.
+      constexpr StaticSection<4> program(ui16 program_number, ui16 pid)
+      {
+         StaticSection<4> s;
+         s.set16Bits(program_number);
+         s.set16Bits(0xe000 | (pid & 0x1fff));
+         return s;
+      }
+
+      //! \brief NIT / BAT transport stream loop entry.
+      template <ui16 N>
+      constexpr StaticSection<4 + N> xportStream(ui16 xs_id, ui16 on_id, const StaticSection<N> &desc_loop)
+      {
+         StaticSection<4 + N> s;
+         s.set16Bits(xs_id);
+         s.set16Bits(on_id);
+         s.setBits(desc_loop);
+         return s;
+      }
+
+      // ---------------------------------------
+      // tables
+      //
+
+      //! \brief A single section PSI table from its data parts, with the CRC.
+      template <ui16... N>
+      constexpr StaticSection<8 + priv::sum(N...) + 4> psiSection(ui8 tid, ui16 tid_ext, ui8 ver, bool cni,
+                                                                 bool data_bit,
+                                                                 const StaticSection<N>&... parts)
+      {
+         static_assert(8 + priv::sum(N...) + 4 <= priv::MAX_PRIVATE_SEC_LEN, "section too long");
+
+         StaticSection<8 + priv::sum(N...) + 4> s;
+         s.set08Bits(tid);
+         s.set16Bits( 0x8000 | (data_bit << 14) | 0x3000 |
+                      ((5 + priv::sum(N...) + 4) & priv::LEN_MASK) );
+         s.set16Bits(tid_ext);
+         s.set08Bits( 0xc0 | ((ver & 0x1f) << 1) | cni );
+         s.set08Bits(0); // section_number
+         s.set08Bits(0); // last_section_number
+         priv::append(s, parts...);
+         s.calcCrc();
+         return s;
+      }
+
+      //! \brief PAT, from program() entries.
+      template <ui16... N>
+      constexpr StaticSection<12 + priv::sum(N...)> pat(ui16 xs_id, ui8 ver, bool cni,
+                                                        const StaticSection<N>&... programs)
+      {
+         static_assert(12 + priv::sum(N...) <= priv::MAX_SEC_LEN, "PAT too long");
+         return psiSection(0x00, xs_id, ver, cni, false, programs...);
+      }
+
+      //! \brief CAT, from descriptors.
+      template <ui16... N>
+      constexpr StaticSection<12 + priv::sum(N...)> cat(ui8 ver, bool cni, const StaticSection<N>&... descs)
+      {
+         static_assert(12 + priv::sum(N...) <= priv::MAX_SEC_LEN, "CAT too long");
+         return psiSection(0x01, 0xffff, ver, cni, false, descs...);
+      }
+
+      //! \brief NIT actual, from its network descLoop() and transport stream descLoop().
+      template <ui16 N, ui16 M>
+      constexpr StaticSection<12 + N + M> nit(ui16 network_id, ui8 ver, bool cni,
+                                              const StaticSection<N> &net_loop,
+                                              const StaticSection<M> &xs_loop)
+      {
+         static_assert(12 + N + M <= priv::MAX_SEC_LEN, "NIT too long");
+         return psiSection(NIT_BAT::NIT_ACTUAL_TID, network_id, ver, cni, true, net_loop, xs_loop);
+      }
+   }
+
+} // namespace
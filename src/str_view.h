@@ -0,0 +1,64 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// str_view.h: non-owning view of text passed to the descriptors
+// -----------------------------------
+
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace sigen {
+
+   /*!
+    * \brief Read-only reference to a run of characters owned by the caller.
+    *
+    * Text arguments to the descriptors are taken as a StrView so the
+    * caller's buffer is truncated to fit without being copied; the
+    * descriptor copies the bytes it keeps exactly once. Built implicitly
+    * from C strings and anything with `data()` and `size()` (e.g.
+    * `std::string` or, in C++17 code, `std::string_view`).
+    */
+   class StrView
+   {
+   public:
+      StrView() : p(""), n(0) { }
+      StrView(const char *s) : p(s), n(std::strlen(s)) { }
+      StrView(const char *s, size_t len) : p(s), n(len) { }
+      template <class S,
+                class = decltype(std::declval<const S&>().data() + std::declval<const S&>().size())>
+      StrView(const S &s) : p(s.data()), n(s.size()) { }
+
+      const char *data() const { return p; }
+      size_t size() const { return n; }
+      size_t length() const { return n; }
+      bool empty() const { return n == 0; }
+
+      //! \brief The first `len` characters, or the whole view if shorter.
+      StrView prefix(size_t len) const { return StrView(p, len < n ? len : n); }
+      //! \brief Copies the characters into a new string.
+      std::string str() const { return std::string(p, n); }
+
+   private:
+      const char *p;
+      size_t n;
+   };
+}
@@ -21,6 +21,7 @@
 // -----------------------------------
 
 #include <iostream>
+#include <algorithm>
 #include <list>
 #include "types.h"
 #include "table.h"
@@ -30,30 +31,27 @@
 namespace sigen
 {
    // ------------------------------------
-   // abstract Table class
+   // abstract STable class
    //
 
-   // for setting reserved bit fields
-   ui32 Table::rbits(ui32 mask) {
-      return 0xffffffff & mask;
+   void STable::DescList::Deleter::operator()(Descriptor* d) const
+   {
+      if (in_arena)
+         d->~Descriptor();
+      else
+         delete d;
    }
 
-   // ------------------------------------
-   // abstract STable class
-   //
-
-   void STable::DescList::add(Descriptor& d, ui16 d_len)
+   void STable::DescList::add(Descriptor& d, ui16 d_len, bool in_arena)
    {
       // claim ownership of the pointer
-      std::unique_ptr<Descriptor> dp;
-      dp.reset(&d);
-      d_list.push_back( std::move(dp) );
+      d_list.emplace_back( &d, Deleter{in_arena} );
       d_length += d_len;
    }
 
    void STable::DescList::buildSections(Section &s) const
    {
-      for (const std::unique_ptr<Descriptor>& dp : d_list)
+      for (const Ptr& dp : d_list)
          (*dp).buildSections(s);
    }
 
@@ -67,11 +65,11 @@ namespace sigen
       if (empty())
          return;
 
-      incOutLevel();
-      for (const std::unique_ptr<Descriptor>& dp : d_list)
+      incOutLevel(o);
+      for (const Ptr& dp : d_list)
          o << *dp << std::endl;
       o << std::endl;
-      decOutLevel();
+      decOutLevel(o);
    }
 #endif
 
@@ -129,6 +127,52 @@ namespace sigen
    }
 
 
+   //
+   // tables built as a whole (single section ones) are built up front
+   // and handed out from the stream
+   //
+   namespace table_priv {
+      class StreamSource : public SectionGenerator::Source
+      {
+      public:
+         explicit StreamSource(const STable& table) {
+            table.buildSections(strm);
+         }
+
+         bool next(Section& s) {
+            if (strm.section_list.empty())
+               return false;
+
+            std::unique_ptr<Section> front(strm.section_list.front());
+            strm.section_list.pop_front();
+            return s.assign(*front);
+         }
+
+      private:
+         TStream strm;
+      };
+   }
+
+   using namespace table_priv;
+
+   SectionGenerator STable::sections() const
+   {
+      return SectionGenerator(new StreamSource(*this));
+   }
+
+   //
+   // general case, through a stream. The single section tables write
+   // straight to s
+   //
+   bool STable::buildSection(Section& s) const
+   {
+      TStream strm;
+      buildSections(strm);
+
+      return strm.section_list.size() == 1 && s.assign(*strm.section_list.front());
+   }
+
+
    // ------------------------------------
    // the PSI Table abstract base class
    //
@@ -204,6 +248,102 @@ namespace sigen
    }
 
 
+   //
+   // lazy version of buildSections(). The last_section_number goes in
+   // every section so a sizing pass first runs the table's writer through
+   // a scratch section to count them, a section per prepare(). Each
+   // next() then writes one
+   //
+   class PSITable::Generator : public SectionGenerator::Source
+   {
+   public:
+      explicit Generator(const PSITable& t) :
+         table(t), scratch(t.getMaxSectionLen()), cur_sec(0), last_sec(0),
+         sizing(false), sized(false), done(false)
+      { }
+
+      // if dropped part way, run the table's writer to the end so its
+      // build state is back at the start
+      ~Generator() {
+         if (sizing && !sized) {
+            while (!prepare())
+               ;
+         }
+         if (cur_sec && !done) {
+            ui16 sec_bytes = 0;
+
+            scratch.reset();
+            while (!table.writeSection(scratch, cur_sec++, sec_bytes))
+               scratch.reset();
+         }
+      }
+
+      bool prepare() {
+         if (sized)
+            return true;
+
+         ui16 sec_bytes = 0;
+         scratch.reset();
+         sizing = true;
+         if (table.writeSection(scratch, last_sec, sec_bytes))
+            sized = true;
+         else
+            last_sec++;
+         return sized;
+      }
+
+      bool next(Section& s) {
+         if (done)
+            return false;
+
+         while (!prepare())
+            ;
+
+         ui16 sec_bytes = 0;
+         s.reset();
+         done = table.writeSection(s, cur_sec++, sec_bytes);
+
+         // update the length, set the last_section_number and crc
+         s.set16Bits(1, table.buildLengthData(sec_bytes) + 4);
+         s.set08Bits(7, last_sec);
+         s.calcCrc();
+         return true;
+      }
+
+   private:
+      const PSITable& table;
+      Section scratch;
+      ui8 cur_sec, last_sec;
+      bool sizing, sized, done;
+   };
+
+   SectionGenerator PSITable::sections() const
+   {
+      return SectionGenerator(new Generator(*this));
+   }
+
+   //
+   // the writer only starts a new section once the data so far is over
+   // getMaxDataLen(), so the whole table fitting means one section
+   //
+   bool PSITable::buildSection(Section& s) const
+   {
+      if (getDataLength() > getMaxDataLen() ||
+          s.capacity() < getDataLength() + 3 + Section::CRC_LEN)
+         return false;
+
+      ui16 sec_bytes = 0;
+      s.reset();
+      if (!writeSection(s, 0, sec_bytes))
+         return false;
+
+      // the last_section_number was written as 0
+      s.set16Bits(1, buildLengthData(sec_bytes) + 4);
+      s.calcCrc();
+      return true;
+   }
+
+
    //
    // writes the table_id_extension, and reserved | version | current_next
    // bytes
@@ -245,9 +385,13 @@ namespace sigen
    }
 
    //
-   // returns the pointer to the item if found; nullptr otherwise
+   // returns the pointer to the item if found; nullptr otherwise. The
+   // last added item is checked first as it's usually the one wanted
    ExtPSITable::ListItem* ExtPSITable::find(const std::list<ListItem*>& item_list, ui16 id)
    {
+      if (!item_list.empty() && item_list.back()->equals(id))
+         return item_list.back();
+
       auto item = std::find_if(item_list.begin(), item_list.end(),
                                [=](auto& item) { return item->equals(id); });
       if (item == item_list.end())
@@ -279,97 +423,24 @@ namespace sigen
 
    //
    // adds the descriptor to the item
-   bool ExtPSITable::addItemDesc(ListItem* item, Descriptor& d)
+   bool ExtPSITable::addItemDesc(ListItem* item, Descriptor& d, bool in_arena)
    {
       ui16 d_len = d.length();
       if ( !incLength(d_len) )
          return false;
 
-      item->descriptors.add(d, d_len);
+      item->descriptors.add(d, d_len, in_arena);
       return true;
    }
 
    //
-   // write section data for the item
-   bool ExtPSITable::ListItem::write_section(Section& section, ui16 max_data_len,
-                                             ui16& sec_bytes, ui16* loop_len_ptr) const
+   // adds each descriptor in the serialized loop to the item
+   void ExtPSITable::addRawDescs(ListItem* item, const ui8* data, ui16 len)
    {
-      ui8 header_len;
-      ui8* desc_loop_len_pos = 0;
-      ui16 d_len, desc_loop_len = 0;
-      bool exit = false, done = false;
-
-      while (!exit)
-      {
-         switch (run.op_state)
-         {
-           case INIT:
-              // set the descriptor iterator
-              run.d_iter = descriptors.begin();
-              run.op_state = WRITE_HEAD;
-
-           case WRITE_HEAD:
-              header_len = write_header(section) + 2;
-
-              // save the position for the desc loop len.. we'll update it later
-              desc_loop_len_pos = section.getCurDataPosition();
-              section.set16Bits( 0 );
-
-              // increment the byte count
-              sec_bytes += header_len;
-              if (loop_len_ptr)
-                 *loop_len_ptr += header_len;
-
-              run.op_state = (!run.d ? GET_DESC : WRITE_DESC);
-              break;
-
-           case GET_DESC:
-              // if we have descriptors available..
-              if (run.d_iter != descriptors.end()) {
-                 run.d = (*run.d_iter++).get();
-
-                 // make sure we can fit the next one
-                 if ( (sec_bytes + run.d->length()) > max_data_len ) {
-                    run.op_state = WRITE_HEAD;
-                    exit = true;
-                    break;
-                 }
-                 run.op_state = WRITE_DESC;
-              }
-              else {
-                 // no more descriptors.. done writing this xport stream,
-                 run = Context();
-                 exit = done = true;
-                 break;
-              }
-              break;
-
-           case WRITE_DESC:
-              run.d->buildSections(section);
-
-              // increment all byte counts
-              d_len = run.d->length();
-              sec_bytes += d_len;
-              if (loop_len_ptr)
-                 *loop_len_ptr += d_len;
-              desc_loop_len += d_len;
-
-              // try to get another one
-              run.op_state = GET_DESC;
-              break;
-         }
+      for (ui16 i = 0; i < len; i += 2 + data[i + 1]) {
+         Descriptor* d = arena.make<RawDesc>(data[i], data + i + 2, data[i + 1]);
+         item->descriptors.add(*d, d->length(), true);
       }
-      // write the desc loop length
-      write_desc_loop_len(section, desc_loop_len_pos, desc_loop_len);
-
-      return done;
-   }
-
-   //
-   // general case. Some tables will define their own (e.g., SDT, EIT)
-   void ExtPSITable::ListItem::write_desc_loop_len(Section& section, ui8* pos, ui16 len) const
-   {
-      section.set16Bits( pos, rbits(~LEN_MASK) | (len & LEN_MASK) );
    }
 
 } // namespace
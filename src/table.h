@@ -24,6 +24,8 @@
 
 #include <memory>
 #include <list>
+#include <vector>
+#include "arena.h"
 #include "types.h"
 #include "dump.h"
 
@@ -43,6 +45,48 @@ namespace sigen {
     *  @{
     */
 
+   /*!
+    * \brief Pull-based section builder returned by STable::sections().
+    *
+    * Builds one section per call to next(), into a caller supplied
+    * Section, so a table's output never has to be held in memory and
+    * the first section can be sent right away. The table must not be
+    * changed or built otherwise while a generator is in use.
+    */
+   class SectionGenerator
+   {
+   public:
+      // section producer behind the generator
+      struct Source {
+         virtual ~Source() {}
+         virtual bool prepare() { return true; }
+         virtual bool next(Section& s) = 0;
+      };
+
+      explicit SectionGenerator(Source* s) : src(s) {}
+
+      /*!
+       * \brief Run one slice of the work needed before the first
+       * section, e.g. one section of a PSI table's sizing pass.
+       *
+       * Optional: next() finishes whatever is left. Lets a caller
+       * interleave other work with the start of a large table.
+       * \return `true` once next() can build without further preparation.
+       */
+      bool prepare() { return !src || src->prepare(); }
+
+      /*!
+       * \brief Build the next section.
+       * \param s Section to write to, at least the table's max section
+       * length in size. Its previous contents are discarded.
+       * \return `false` once all sections have been built.
+       */
+      bool next(Section& s) { return src && src->next(s); }
+
+   private:
+      std::unique_ptr<Source> src;
+   };
+
    /*!
     * \brief Abstract base class for all tables and descriptors.
     */
@@ -73,7 +117,7 @@ namespace sigen {
       virtual ~Table() { }
 
       // helper to fill reserved bits
-      static ui32 rbits(ui32 mask);
+      static ui32 rbits(ui32 mask) { return 0xffffffff & mask; }
 
       // prohibit
       Table(const Table&) = delete;
@@ -109,6 +153,21 @@ namespace sigen {
        */
       virtual void buildSections(TStream& stream) const = 0;
 
+      /*!
+       * \brief Returns a generator building the table one section at a
+       * time.
+       */
+      virtual SectionGenerator sections() const;
+
+      /*!
+       * \brief Build a table that fits in a single section straight
+       * into the specified one, e.g. an InlineSection.
+       * \param s Section to write to. Its previous contents are discarded.
+       * \return `false` if the table needs more than one section or
+       * more room than `s` has.
+       */
+      virtual bool buildSection(Section& s) const;
+
    protected:
       enum {
          LEN_MASK = 0x0fff,
@@ -128,18 +187,26 @@ namespace sigen {
 
       // contains a list of descriptors and tracks the data
       // length. Handles taking ownership of the descriptor pointer to
-      // auto-delete when table goes out of scope.
+      // auto-delete when table goes out of scope. Descriptors built in
+      // the table's arena are only destroyed.
       class DescList
       {
       public:
-         void add(Descriptor& d, ui16 data_len);
-         const std::list<std::unique_ptr<Descriptor> >& list() const { return d_list; }
+         struct Deleter {
+            bool in_arena;
+            void operator()(Descriptor* d) const;
+         };
+         typedef std::unique_ptr<Descriptor, Deleter> Ptr;
+         typedef std::vector<Ptr>::const_iterator const_iterator;
+
+         void add(Descriptor& d, ui16 data_len, bool in_arena = false);
+         const std::vector<Ptr>& list() const { return d_list; }
          ui16 loop_length() const { return d_length; }
 
          bool empty() const { return d_list.empty(); }
-         const std::unique_ptr<Descriptor>& front() const { return d_list.front(); }
-         std::list<std::unique_ptr<Descriptor> >::const_iterator begin() const { return d_list.begin(); }
-         std::list<std::unique_ptr<Descriptor> >::const_iterator end() const { return d_list.end(); }
+         const Ptr& front() const { return d_list.front(); }
+         const_iterator begin() const { return d_list.begin(); }
+         const_iterator end() const { return d_list.end(); }
 
          // only writes data loop - not length as it depends on the table
          void buildSections(Section& s) const;
@@ -150,9 +217,20 @@ namespace sigen {
 
       private:
          ui16 d_length = 0;
-         std::list<std::unique_ptr<Descriptor> > d_list;
+         std::vector<Ptr> d_list;
       };
 
+      // constructs a D in the table's arena and hands it to add(),
+      // destroying it again if it's not added
+      template <class D, class Add, class... Args>
+      bool emplace(Add add, Args&&... args) {
+         D* d = arena.make<D>(std::forward<Args>(args)...);
+         if (add(*d))
+            return true;
+         arena.destroy(d);
+         return false;
+      }
+
       // used by the derived tables to check for available space for data
       virtual ui16 getMaxDataLen() const { return max_section_length - 3; }
 
@@ -177,6 +255,9 @@ namespace sigen {
 
       ui16 length;                    // data length (not including CRC and
                                       // 3-byte header)
+
+   protected:
+      Arena arena;                    // descriptors built in place
    };
 
 
@@ -190,6 +271,8 @@ namespace sigen {
    {
    public:
       virtual void buildSections(TStream& ts) const;
+      virtual SectionGenerator sections() const;
+      virtual bool buildSection(Section& s) const;
 
       ui8 getVersionNumber() const { return version_number; }
       ui8 getCurrentNextIndicator() const { return current_next_indicator; }
@@ -214,11 +297,20 @@ namespace sigen {
       void writeSectionHeader(Section& s) const;
       virtual bool writeSection(Section& s, ui8, ui16& l) const = 0;
 
+      // section writer engine (section_writer.h). LAYOUT says which
+      // loop length fields follow the table header
+      enum { DESC_LOOP_LEN = 0x01, ITEM_LOOP_LEN = 0x02 };
+      struct NoItem;
+      template <class Item, class List = std::list<Item>, ui8 LAYOUT = 0>
+      class SectionWriter;
+
 #ifdef ENABLE_DUMP
       virtual void dumpHeader(std::ostream& o, STRID table_label, STRID ext_label) const;
 #endif
 
    private:
+      class Generator;
+
       ui16 table_id_extension;        // id extension for private tables
       ui8 version_number : 5;         // ver_num (5)
       bool current_next_indicator;    // cur_next (1)
@@ -247,13 +339,9 @@ namespace sigen {
          virtual ui16 length() const = 0;
          virtual bool equals(ui16 id) const = 0;
 
-         // controls the state machine for writing the loop's section data
-         bool write_section(Section& sec, ui16 max_data_len, ui16& sec_bytes,
-                            ui16* item_loop_len = nullptr) const;
-         // writes item header bytes, returns num bytes written
-         virtual ui8 write_header(Section& sec) const = 0;
-         // writes the 2-byte desc loop len
-         virtual void write_desc_loop_len(Section& sec, ui8* pos, ui16 len) const;
+         // writes the 2-byte desc loop len. Items with flags in the
+         // same field hide it with their own
+         void write_desc_loop_len(Section& sec, ui8* pos, ui16 len) const;
 
       protected:
          // section building state tracking
@@ -263,20 +351,45 @@ namespace sigen {
 
             State_t op_state;
             const Descriptor* d;
-            std::list<std::unique_ptr<Descriptor> >::const_iterator d_iter;
+            DescList::const_iterator d_iter;
          } run;
       };
 
+      // base for the final item types (Self), defining
+      // write_header(), which are written by the SectionWriter
+      template <class Self>
+      struct LoopItem : public ListItem {
+         // length needed to start the item in a section
+         ui16 fit_length() const;
+         // controls the state machine for writing the loop's section data
+         bool write_section(Section& sec, ui16 max_data_len, ui16& sec_bytes,
+                            ui16* item_loop_len = nullptr) const;
+      };
+
       static bool contains(const std::list<ListItem*>& list, ui16 id) {
          return (nullptr != ExtPSITable::find(list, id));
       }
       static ListItem* find(const std::list<ListItem*>& list, ui16 id);
       bool addItemDesc(std::list<ListItem*>& list, Descriptor& desc);
       bool addItemDesc(std::list<ListItem*>& list, ui16 id, Descriptor& desc);
+      // constructs the descriptor in place and adds it to the item
+      // matching the given id
+      template <class D, class... Args>
+      bool emplaceItemDesc(std::list<ListItem*>& list, ui16 id, Args&&... args) {
+         ListItem* item = find(list, id);
+         if (!item)
+            return false;
+
+         return emplace<D>([=](Descriptor& d) { return addItemDesc(item, d, true); },
+                           std::forward<Args>(args)...);
+      }
+      // bulk loading: adds a checked descriptor loop's descriptors as
+      // RawDesc's - the table length must already include them
+      void addRawDescs(ListItem* item, const ui8* data, ui16 len);
 
       std::vector<std::list<ListItem*> > items;
    private:
-      bool addItemDesc(ListItem* item, Descriptor& d);
+      bool addItemDesc(ListItem* item, Descriptor& d, bool in_arena = false);
    };
 
    //! @}
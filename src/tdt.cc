@@ -33,14 +33,19 @@ namespace sigen
    //
    void TDT::buildSections(TStream &strm) const
    {
-      Section *s = strm.getNewSection( getMaxSectionLen() );
+      buildSection( *strm.getNewSection( getMaxSectionLen() ) );
+   }
+
+   bool TDT::buildSection(Section &s) const
+   {
+      if (s.capacity() < 3 + getDataLength())
+         return false;
 
-      STable::buildSections(*s);
+      s.reset();
+      STable::buildSections(s);
 
-      s->set16Bits( utc.mjd );
-      s->set08Bits( utc.time.getBCDHour() );
-      s->set08Bits( utc.time.getBCDMinute() );
-      s->set08Bits( utc.time.getBCDSecond() );
+      s.setBits( utc );
+      return true;
    }
 
    //
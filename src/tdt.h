@@ -28,6 +28,7 @@
 namespace sigen
 {
    class TStream;
+   class Section;
 
    /*! \addtogroup table
     *  @{
@@ -44,7 +45,8 @@ namespace sigen
    {
    public:
       enum {
-         PID = 0x14                 //!< Packet PID for transmission.
+         PID = 0x14,                //!< Packet PID for transmission.
+         MAX_SEC_LEN = 8            //!< Maximum section length, e.g. for an InlineSection.
       };
 
       /*!
@@ -65,6 +67,7 @@ namespace sigen
 
       // section data writer
       virtual void buildSections(TStream &) const;
+      virtual bool buildSection(Section &) const;
 
 #ifdef ENABLE_DUMP
       void dump(std::ostream &) const;
@@ -73,7 +76,7 @@ namespace sigen
    private:
       UTC utc;
 
-      enum { MAX_SEC_LEN = 8, TID = 0x70 };
+      enum { TID = 0x70 };
    };
    //! @}
    //! @}
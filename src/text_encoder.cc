@@ -0,0 +1,768 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// text_encoder.cc: UTF-8 to EN 300 468 Annex A character table encoder
+// -----------------------------------
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "text_encoder.h"
+
+namespace sigen
+{
+   namespace text_encoder_priv {
+
+      struct Iso6937Char {
+         ui16 cp;
+         ui16 code;   // single byte, or diacritic << 8 | base letter
+      };
+
+      struct Iso8859Char {
+         ui16 cp;
+         ui8 code;
+      };
+
+      // ISO/IEC 6937 (table 00): single bytes or diacritic + base letter
+      const Iso6937Char ISO_6937_CHARS[] = {
+         { 0x00a0, 0x00a0 }, { 0x00a1, 0x00a1 }, { 0x00a2, 0x00a2 }, { 0x00a3, 0x00a3 },
+         { 0x00a4, 0x00a8 }, { 0x00a5, 0x00a5 }, { 0x00a6, 0x00d7 }, { 0x00a7, 0x00a7 },
+         { 0x00a9, 0x00d3 }, { 0x00aa, 0x00e3 }, { 0x00ab, 0x00ab }, { 0x00ac, 0x00d6 },
+         { 0x00ad, 0x00ff }, { 0x00ae, 0x00d2 }, { 0x00b0, 0x00b0 }, { 0x00b1, 0x00b1 },
+         { 0x00b2, 0x00b2 }, { 0x00b3, 0x00b3 }, { 0x00b5, 0x00b5 }, { 0x00b6, 0x00b6 },
+         { 0x00b7, 0x00b7 }, { 0x00b9, 0x00d1 }, { 0x00ba, 0x00eb }, { 0x00bb, 0x00bb },
+         { 0x00bc, 0x00bc }, { 0x00bd, 0x00bd }, { 0x00be, 0x00be }, { 0x00bf, 0x00bf },
+         { 0x00c0, 0xc141 }, { 0x00c1, 0xc241 }, { 0x00c2, 0xc341 }, { 0x00c3, 0xc441 },
+         { 0x00c4, 0xc841 }, { 0x00c5, 0xca41 }, { 0x00c6, 0x00e1 }, { 0x00c7, 0xcb43 },
+         { 0x00c8, 0xc145 }, { 0x00c9, 0xc245 }, { 0x00ca, 0xc345 }, { 0x00cb, 0xc845 },
+         { 0x00cc, 0xc149 }, { 0x00cd, 0xc249 }, { 0x00ce, 0xc349 }, { 0x00cf, 0xc849 },
+         { 0x00d1, 0xc44e }, { 0x00d2, 0xc14f }, { 0x00d3, 0xc24f }, { 0x00d4, 0xc34f },
+         { 0x00d5, 0xc44f }, { 0x00d6, 0xc84f }, { 0x00d7, 0x00b4 }, { 0x00d8, 0x00e9 },
+         { 0x00d9, 0xc155 }, { 0x00da, 0xc255 }, { 0x00db, 0xc355 }, { 0x00dc, 0xc855 },
+         { 0x00dd, 0xc259 }, { 0x00de, 0x00ec }, { 0x00df, 0x00fb }, { 0x00e0, 0xc161 },
+         { 0x00e1, 0xc261 }, { 0x00e2, 0xc361 }, { 0x00e3, 0xc461 }, { 0x00e4, 0xc861 },
+         { 0x00e5, 0xca61 }, { 0x00e6, 0x00f1 }, { 0x00e7, 0xcb63 }, { 0x00e8, 0xc165 },
+         { 0x00e9, 0xc265 }, { 0x00ea, 0xc365 }, { 0x00eb, 0xc865 }, { 0x00ec, 0xc169 },
+         { 0x00ed, 0xc269 }, { 0x00ee, 0xc369 }, { 0x00ef, 0xc869 }, { 0x00f0, 0x00f3 },
+         { 0x00f1, 0xc46e }, { 0x00f2, 0xc16f }, { 0x00f3, 0xc26f }, { 0x00f4, 0xc36f },
+         { 0x00f5, 0xc46f }, { 0x00f6, 0xc86f }, { 0x00f7, 0x00b8 }, { 0x00f8, 0x00f9 },
+         { 0x00f9, 0xc175 }, { 0x00fa, 0xc275 }, { 0x00fb, 0xc375 }, { 0x00fc, 0xc875 },
+         { 0x00fd, 0xc279 }, { 0x00fe, 0x00fc }, { 0x00ff, 0xc879 }, { 0x0100, 0xc541 },
+         { 0x0101, 0xc561 }, { 0x0102, 0xc641 }, { 0x0103, 0xc661 }, { 0x0104, 0xce41 },
+         { 0x0105, 0xce61 }, { 0x0106, 0xc243 }, { 0x0107, 0xc263 }, { 0x0108, 0xc343 },
+         { 0x0109, 0xc363 }, { 0x010a, 0xc743 }, { 0x010b, 0xc763 }, { 0x010c, 0xcf43 },
+         { 0x010d, 0xcf63 }, { 0x010e, 0xcf44 }, { 0x010f, 0xcf64 }, { 0x0110, 0x00e2 },
+         { 0x0111, 0x00f2 }, { 0x0112, 0xc545 }, { 0x0113, 0xc565 }, { 0x0114, 0xc645 },
+         { 0x0115, 0xc665 }, { 0x0116, 0xc745 }, { 0x0117, 0xc765 }, { 0x0118, 0xce45 },
+         { 0x0119, 0xce65 }, { 0x011a, 0xcf45 }, { 0x011b, 0xcf65 }, { 0x011c, 0xc347 },
+         { 0x011d, 0xc367 }, { 0x011e, 0xc647 }, { 0x011f, 0xc667 }, { 0x0120, 0xc747 },
+         { 0x0121, 0xc767 }, { 0x0122, 0xcb47 }, { 0x0123, 0xcb67 }, { 0x0124, 0xc348 },
+         { 0x0125, 0xc368 }, { 0x0126, 0x00e4 }, { 0x0127, 0x00f4 }, { 0x0128, 0xc449 },
+         { 0x0129, 0xc469 }, { 0x012a, 0xc549 }, { 0x012b, 0xc569 }, { 0x012c, 0xc649 },
+         { 0x012d, 0xc669 }, { 0x012e, 0xce49 }, { 0x012f, 0xce69 }, { 0x0130, 0xc749 },
+         { 0x0131, 0x00f5 }, { 0x0132, 0x00e6 }, { 0x0133, 0x00f6 }, { 0x0134, 0xc34a },
+         { 0x0135, 0xc36a }, { 0x0136, 0xcb4b }, { 0x0137, 0xcb6b }, { 0x0138, 0x00f0 },
+         { 0x0139, 0xc24c }, { 0x013a, 0xc26c }, { 0x013b, 0xcb4c }, { 0x013c, 0xcb6c },
+         { 0x013d, 0xcf4c }, { 0x013e, 0xcf6c }, { 0x013f, 0x00e7 }, { 0x0140, 0x00f7 },
+         { 0x0141, 0x00e8 }, { 0x0142, 0x00f8 }, { 0x0143, 0xc24e }, { 0x0144, 0xc26e },
+         { 0x0145, 0xcb4e }, { 0x0146, 0xcb6e }, { 0x0147, 0xcf4e }, { 0x0148, 0xcf6e },
+         { 0x0149, 0x00ef }, { 0x014a, 0x00ee }, { 0x014b, 0x00fe }, { 0x014c, 0xc54f },
+         { 0x014d, 0xc56f }, { 0x014e, 0xc64f }, { 0x014f, 0xc66f }, { 0x0150, 0xcd4f },
+         { 0x0151, 0xcd6f }, { 0x0152, 0x00ea }, { 0x0153, 0x00fa }, { 0x0154, 0xc252 },
+         { 0x0155, 0xc272 }, { 0x0156, 0xcb52 }, { 0x0157, 0xcb72 }, { 0x0158, 0xcf52 },
+         { 0x0159, 0xcf72 }, { 0x015a, 0xc253 }, { 0x015b, 0xc273 }, { 0x015c, 0xc353 },
+         { 0x015d, 0xc373 }, { 0x015e, 0xcb53 }, { 0x015f, 0xcb73 }, { 0x0160, 0xcf53 },
+         { 0x0161, 0xcf73 }, { 0x0162, 0xcb54 }, { 0x0163, 0xcb74 }, { 0x0164, 0xcf54 },
+         { 0x0165, 0xcf74 }, { 0x0166, 0x00ed }, { 0x0167, 0x00fd }, { 0x0168, 0xc455 },
+         { 0x0169, 0xc475 }, { 0x016a, 0xc555 }, { 0x016b, 0xc575 }, { 0x016c, 0xc655 },
+         { 0x016d, 0xc675 }, { 0x016e, 0xca55 }, { 0x016f, 0xca75 }, { 0x0170, 0xcd55 },
+         { 0x0171, 0xcd75 }, { 0x0172, 0xce55 }, { 0x0173, 0xce75 }, { 0x0174, 0xc357 },
+         { 0x0175, 0xc377 }, { 0x0176, 0xc359 }, { 0x0177, 0xc379 }, { 0x0178, 0xc859 },
+         { 0x0179, 0xc25a }, { 0x017a, 0xc27a }, { 0x017b, 0xc75a }, { 0x017c, 0xc77a },
+         { 0x017d, 0xcf5a }, { 0x017e, 0xcf7a }, { 0x2015, 0x00d0 }, { 0x2018, 0x00a9 },
+         { 0x2019, 0x00b9 }, { 0x201c, 0x00aa }, { 0x201d, 0x00ba }, { 0x2122, 0x00d4 },
+         { 0x2126, 0x00e0 }, { 0x215b, 0x00dc }, { 0x215c, 0x00dd }, { 0x215d, 0x00de },
+         { 0x215e, 0x00df }, { 0x2190, 0x00ac }, { 0x2191, 0x00ad }, { 0x2192, 0x00ae },
+         { 0x2193, 0x00af }, { 0x266a, 0x00d5 },
+      };
+
+      // ISO/IEC 8859-5, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_5_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x00a7, 0xfd }, { 0x00ad, 0xad }, { 0x0401, 0xa1 },
+         { 0x0402, 0xa2 }, { 0x0403, 0xa3 }, { 0x0404, 0xa4 }, { 0x0405, 0xa5 },
+         { 0x0406, 0xa6 }, { 0x0407, 0xa7 }, { 0x0408, 0xa8 }, { 0x0409, 0xa9 },
+         { 0x040a, 0xaa }, { 0x040b, 0xab }, { 0x040c, 0xac }, { 0x040e, 0xae },
+         { 0x040f, 0xaf }, { 0x0410, 0xb0 }, { 0x0411, 0xb1 }, { 0x0412, 0xb2 },
+         { 0x0413, 0xb3 }, { 0x0414, 0xb4 }, { 0x0415, 0xb5 }, { 0x0416, 0xb6 },
+         { 0x0417, 0xb7 }, { 0x0418, 0xb8 }, { 0x0419, 0xb9 }, { 0x041a, 0xba },
+         { 0x041b, 0xbb }, { 0x041c, 0xbc }, { 0x041d, 0xbd }, { 0x041e, 0xbe },
+         { 0x041f, 0xbf }, { 0x0420, 0xc0 }, { 0x0421, 0xc1 }, { 0x0422, 0xc2 },
+         { 0x0423, 0xc3 }, { 0x0424, 0xc4 }, { 0x0425, 0xc5 }, { 0x0426, 0xc6 },
+         { 0x0427, 0xc7 }, { 0x0428, 0xc8 }, { 0x0429, 0xc9 }, { 0x042a, 0xca },
+         { 0x042b, 0xcb }, { 0x042c, 0xcc }, { 0x042d, 0xcd }, { 0x042e, 0xce },
+         { 0x042f, 0xcf }, { 0x0430, 0xd0 }, { 0x0431, 0xd1 }, { 0x0432, 0xd2 },
+         { 0x0433, 0xd3 }, { 0x0434, 0xd4 }, { 0x0435, 0xd5 }, { 0x0436, 0xd6 },
+         { 0x0437, 0xd7 }, { 0x0438, 0xd8 }, { 0x0439, 0xd9 }, { 0x043a, 0xda },
+         { 0x043b, 0xdb }, { 0x043c, 0xdc }, { 0x043d, 0xdd }, { 0x043e, 0xde },
+         { 0x043f, 0xdf }, { 0x0440, 0xe0 }, { 0x0441, 0xe1 }, { 0x0442, 0xe2 },
+         { 0x0443, 0xe3 }, { 0x0444, 0xe4 }, { 0x0445, 0xe5 }, { 0x0446, 0xe6 },
+         { 0x0447, 0xe7 }, { 0x0448, 0xe8 }, { 0x0449, 0xe9 }, { 0x044a, 0xea },
+         { 0x044b, 0xeb }, { 0x044c, 0xec }, { 0x044d, 0xed }, { 0x044e, 0xee },
+         { 0x044f, 0xef }, { 0x0451, 0xf1 }, { 0x0452, 0xf2 }, { 0x0453, 0xf3 },
+         { 0x0454, 0xf4 }, { 0x0455, 0xf5 }, { 0x0456, 0xf6 }, { 0x0457, 0xf7 },
+         { 0x0458, 0xf8 }, { 0x0459, 0xf9 }, { 0x045a, 0xfa }, { 0x045b, 0xfb },
+         { 0x045c, 0xfc }, { 0x045e, 0xfe }, { 0x045f, 0xff }, { 0x2116, 0xf0 },
+      };
+
+      // ISO/IEC 8859-6, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_6_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x00a4, 0xa4 }, { 0x00ad, 0xad }, { 0x060c, 0xac },
+         { 0x061b, 0xbb }, { 0x061f, 0xbf }, { 0x0621, 0xc1 }, { 0x0622, 0xc2 },
+         { 0x0623, 0xc3 }, { 0x0624, 0xc4 }, { 0x0625, 0xc5 }, { 0x0626, 0xc6 },
+         { 0x0627, 0xc7 }, { 0x0628, 0xc8 }, { 0x0629, 0xc9 }, { 0x062a, 0xca },
+         { 0x062b, 0xcb }, { 0x062c, 0xcc }, { 0x062d, 0xcd }, { 0x062e, 0xce },
+         { 0x062f, 0xcf }, { 0x0630, 0xd0 }, { 0x0631, 0xd1 }, { 0x0632, 0xd2 },
+         { 0x0633, 0xd3 }, { 0x0634, 0xd4 }, { 0x0635, 0xd5 }, { 0x0636, 0xd6 },
+         { 0x0637, 0xd7 }, { 0x0638, 0xd8 }, { 0x0639, 0xd9 }, { 0x063a, 0xda },
+         { 0x0640, 0xe0 }, { 0x0641, 0xe1 }, { 0x0642, 0xe2 }, { 0x0643, 0xe3 },
+         { 0x0644, 0xe4 }, { 0x0645, 0xe5 }, { 0x0646, 0xe6 }, { 0x0647, 0xe7 },
+         { 0x0648, 0xe8 }, { 0x0649, 0xe9 }, { 0x064a, 0xea }, { 0x064b, 0xeb },
+         { 0x064c, 0xec }, { 0x064d, 0xed }, { 0x064e, 0xee }, { 0x064f, 0xef },
+         { 0x0650, 0xf0 }, { 0x0651, 0xf1 }, { 0x0652, 0xf2 },
+      };
+
+      // ISO/IEC 8859-7, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_7_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x00a3, 0xa3 }, { 0x00a6, 0xa6 }, { 0x00a7, 0xa7 },
+         { 0x00a8, 0xa8 }, { 0x00a9, 0xa9 }, { 0x00ab, 0xab }, { 0x00ac, 0xac },
+         { 0x00ad, 0xad }, { 0x00b0, 0xb0 }, { 0x00b1, 0xb1 }, { 0x00b2, 0xb2 },
+         { 0x00b3, 0xb3 }, { 0x00b7, 0xb7 }, { 0x00bb, 0xbb }, { 0x00bd, 0xbd },
+         { 0x037a, 0xaa }, { 0x0384, 0xb4 }, { 0x0385, 0xb5 }, { 0x0386, 0xb6 },
+         { 0x0388, 0xb8 }, { 0x0389, 0xb9 }, { 0x038a, 0xba }, { 0x038c, 0xbc },
+         { 0x038e, 0xbe }, { 0x038f, 0xbf }, { 0x0390, 0xc0 }, { 0x0391, 0xc1 },
+         { 0x0392, 0xc2 }, { 0x0393, 0xc3 }, { 0x0394, 0xc4 }, { 0x0395, 0xc5 },
+         { 0x0396, 0xc6 }, { 0x0397, 0xc7 }, { 0x0398, 0xc8 }, { 0x0399, 0xc9 },
+         { 0x039a, 0xca }, { 0x039b, 0xcb }, { 0x039c, 0xcc }, { 0x039d, 0xcd },
+         { 0x039e, 0xce }, { 0x039f, 0xcf }, { 0x03a0, 0xd0 }, { 0x03a1, 0xd1 },
+         { 0x03a3, 0xd3 }, { 0x03a4, 0xd4 }, { 0x03a5, 0xd5 }, { 0x03a6, 0xd6 },
+         { 0x03a7, 0xd7 }, { 0x03a8, 0xd8 }, { 0x03a9, 0xd9 }, { 0x03aa, 0xda },
+         { 0x03ab, 0xdb }, { 0x03ac, 0xdc }, { 0x03ad, 0xdd }, { 0x03ae, 0xde },
+         { 0x03af, 0xdf }, { 0x03b0, 0xe0 }, { 0x03b1, 0xe1 }, { 0x03b2, 0xe2 },
+         { 0x03b3, 0xe3 }, { 0x03b4, 0xe4 }, { 0x03b5, 0xe5 }, { 0x03b6, 0xe6 },
+         { 0x03b7, 0xe7 }, { 0x03b8, 0xe8 }, { 0x03b9, 0xe9 }, { 0x03ba, 0xea },
+         { 0x03bb, 0xeb }, { 0x03bc, 0xec }, { 0x03bd, 0xed }, { 0x03be, 0xee },
+         { 0x03bf, 0xef }, { 0x03c0, 0xf0 }, { 0x03c1, 0xf1 }, { 0x03c2, 0xf2 },
+         { 0x03c3, 0xf3 }, { 0x03c4, 0xf4 }, { 0x03c5, 0xf5 }, { 0x03c6, 0xf6 },
+         { 0x03c7, 0xf7 }, { 0x03c8, 0xf8 }, { 0x03c9, 0xf9 }, { 0x03ca, 0xfa },
+         { 0x03cb, 0xfb }, { 0x03cc, 0xfc }, { 0x03cd, 0xfd }, { 0x03ce, 0xfe },
+         { 0x2015, 0xaf }, { 0x2018, 0xa1 }, { 0x2019, 0xa2 }, { 0x20ac, 0xa4 },
+         { 0x20af, 0xa5 },
+      };
+
+      // ISO/IEC 8859-8, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_8_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x00a2, 0xa2 }, { 0x00a3, 0xa3 }, { 0x00a4, 0xa4 },
+         { 0x00a5, 0xa5 }, { 0x00a6, 0xa6 }, { 0x00a7, 0xa7 }, { 0x00a8, 0xa8 },
+         { 0x00a9, 0xa9 }, { 0x00ab, 0xab }, { 0x00ac, 0xac }, { 0x00ad, 0xad },
+         { 0x00ae, 0xae }, { 0x00af, 0xaf }, { 0x00b0, 0xb0 }, { 0x00b1, 0xb1 },
+         { 0x00b2, 0xb2 }, { 0x00b3, 0xb3 }, { 0x00b4, 0xb4 }, { 0x00b5, 0xb5 },
+         { 0x00b6, 0xb6 }, { 0x00b7, 0xb7 }, { 0x00b8, 0xb8 }, { 0x00b9, 0xb9 },
+         { 0x00bb, 0xbb }, { 0x00bc, 0xbc }, { 0x00bd, 0xbd }, { 0x00be, 0xbe },
+         { 0x00d7, 0xaa }, { 0x00f7, 0xba }, { 0x05d0, 0xe0 }, { 0x05d1, 0xe1 },
+         { 0x05d2, 0xe2 }, { 0x05d3, 0xe3 }, { 0x05d4, 0xe4 }, { 0x05d5, 0xe5 },
+         { 0x05d6, 0xe6 }, { 0x05d7, 0xe7 }, { 0x05d8, 0xe8 }, { 0x05d9, 0xe9 },
+         { 0x05da, 0xea }, { 0x05db, 0xeb }, { 0x05dc, 0xec }, { 0x05dd, 0xed },
+         { 0x05de, 0xee }, { 0x05df, 0xef }, { 0x05e0, 0xf0 }, { 0x05e1, 0xf1 },
+         { 0x05e2, 0xf2 }, { 0x05e3, 0xf3 }, { 0x05e4, 0xf4 }, { 0x05e5, 0xf5 },
+         { 0x05e6, 0xf6 }, { 0x05e7, 0xf7 }, { 0x05e8, 0xf8 }, { 0x05e9, 0xf9 },
+         { 0x05ea, 0xfa }, { 0x200e, 0xfd }, { 0x200f, 0xfe }, { 0x2017, 0xdf },
+      };
+
+      // ISO/IEC 8859-9, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_9_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x00a1, 0xa1 }, { 0x00a2, 0xa2 }, { 0x00a3, 0xa3 },
+         { 0x00a4, 0xa4 }, { 0x00a5, 0xa5 }, { 0x00a6, 0xa6 }, { 0x00a7, 0xa7 },
+         { 0x00a8, 0xa8 }, { 0x00a9, 0xa9 }, { 0x00aa, 0xaa }, { 0x00ab, 0xab },
+         { 0x00ac, 0xac }, { 0x00ad, 0xad }, { 0x00ae, 0xae }, { 0x00af, 0xaf },
+         { 0x00b0, 0xb0 }, { 0x00b1, 0xb1 }, { 0x00b2, 0xb2 }, { 0x00b3, 0xb3 },
+         { 0x00b4, 0xb4 }, { 0x00b5, 0xb5 }, { 0x00b6, 0xb6 }, { 0x00b7, 0xb7 },
+         { 0x00b8, 0xb8 }, { 0x00b9, 0xb9 }, { 0x00ba, 0xba }, { 0x00bb, 0xbb },
+         { 0x00bc, 0xbc }, { 0x00bd, 0xbd }, { 0x00be, 0xbe }, { 0x00bf, 0xbf },
+         { 0x00c0, 0xc0 }, { 0x00c1, 0xc1 }, { 0x00c2, 0xc2 }, { 0x00c3, 0xc3 },
+         { 0x00c4, 0xc4 }, { 0x00c5, 0xc5 }, { 0x00c6, 0xc6 }, { 0x00c7, 0xc7 },
+         { 0x00c8, 0xc8 }, { 0x00c9, 0xc9 }, { 0x00ca, 0xca }, { 0x00cb, 0xcb },
+         { 0x00cc, 0xcc }, { 0x00cd, 0xcd }, { 0x00ce, 0xce }, { 0x00cf, 0xcf },
+         { 0x00d1, 0xd1 }, { 0x00d2, 0xd2 }, { 0x00d3, 0xd3 }, { 0x00d4, 0xd4 },
+         { 0x00d5, 0xd5 }, { 0x00d6, 0xd6 }, { 0x00d7, 0xd7 }, { 0x00d8, 0xd8 },
+         { 0x00d9, 0xd9 }, { 0x00da, 0xda }, { 0x00db, 0xdb }, { 0x00dc, 0xdc },
+         { 0x00df, 0xdf }, { 0x00e0, 0xe0 }, { 0x00e1, 0xe1 }, { 0x00e2, 0xe2 },
+         { 0x00e3, 0xe3 }, { 0x00e4, 0xe4 }, { 0x00e5, 0xe5 }, { 0x00e6, 0xe6 },
+         { 0x00e7, 0xe7 }, { 0x00e8, 0xe8 }, { 0x00e9, 0xe9 }, { 0x00ea, 0xea },
+         { 0x00eb, 0xeb }, { 0x00ec, 0xec }, { 0x00ed, 0xed }, { 0x00ee, 0xee },
+         { 0x00ef, 0xef }, { 0x00f1, 0xf1 }, { 0x00f2, 0xf2 }, { 0x00f3, 0xf3 },
+         { 0x00f4, 0xf4 }, { 0x00f5, 0xf5 }, { 0x00f6, 0xf6 }, { 0x00f7, 0xf7 },
+         { 0x00f8, 0xf8 }, { 0x00f9, 0xf9 }, { 0x00fa, 0xfa }, { 0x00fb, 0xfb },
+         { 0x00fc, 0xfc }, { 0x00ff, 0xff }, { 0x011e, 0xd0 }, { 0x011f, 0xf0 },
+         { 0x0130, 0xdd }, { 0x0131, 0xfd }, { 0x015e, 0xde }, { 0x015f, 0xfe },
+      };
+
+      // ISO/IEC 8859-10, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_10_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x00a7, 0xa7 }, { 0x00ad, 0xad }, { 0x00b0, 0xb0 },
+         { 0x00b7, 0xb7 }, { 0x00c1, 0xc1 }, { 0x00c2, 0xc2 }, { 0x00c3, 0xc3 },
+         { 0x00c4, 0xc4 }, { 0x00c5, 0xc5 }, { 0x00c6, 0xc6 }, { 0x00c9, 0xc9 },
+         { 0x00cb, 0xcb }, { 0x00cd, 0xcd }, { 0x00ce, 0xce }, { 0x00cf, 0xcf },
+         { 0x00d0, 0xd0 }, { 0x00d3, 0xd3 }, { 0x00d4, 0xd4 }, { 0x00d5, 0xd5 },
+         { 0x00d6, 0xd6 }, { 0x00d8, 0xd8 }, { 0x00da, 0xda }, { 0x00db, 0xdb },
+         { 0x00dc, 0xdc }, { 0x00dd, 0xdd }, { 0x00de, 0xde }, { 0x00df, 0xdf },
+         { 0x00e1, 0xe1 }, { 0x00e2, 0xe2 }, { 0x00e3, 0xe3 }, { 0x00e4, 0xe4 },
+         { 0x00e5, 0xe5 }, { 0x00e6, 0xe6 }, { 0x00e9, 0xe9 }, { 0x00eb, 0xeb },
+         { 0x00ed, 0xed }, { 0x00ee, 0xee }, { 0x00ef, 0xef }, { 0x00f0, 0xf0 },
+         { 0x00f3, 0xf3 }, { 0x00f4, 0xf4 }, { 0x00f5, 0xf5 }, { 0x00f6, 0xf6 },
+         { 0x00f8, 0xf8 }, { 0x00fa, 0xfa }, { 0x00fb, 0xfb }, { 0x00fc, 0xfc },
+         { 0x00fd, 0xfd }, { 0x00fe, 0xfe }, { 0x0100, 0xc0 }, { 0x0101, 0xe0 },
+         { 0x0104, 0xa1 }, { 0x0105, 0xb1 }, { 0x010c, 0xc8 }, { 0x010d, 0xe8 },
+         { 0x0110, 0xa9 }, { 0x0111, 0xb9 }, { 0x0112, 0xa2 }, { 0x0113, 0xb2 },
+         { 0x0116, 0xcc }, { 0x0117, 0xec }, { 0x0118, 0xca }, { 0x0119, 0xea },
+         { 0x0122, 0xa3 }, { 0x0123, 0xb3 }, { 0x0128, 0xa5 }, { 0x0129, 0xb5 },
+         { 0x012a, 0xa4 }, { 0x012b, 0xb4 }, { 0x012e, 0xc7 }, { 0x012f, 0xe7 },
+         { 0x0136, 0xa6 }, { 0x0137, 0xb6 }, { 0x0138, 0xff }, { 0x013b, 0xa8 },
+         { 0x013c, 0xb8 }, { 0x0145, 0xd1 }, { 0x0146, 0xf1 }, { 0x014a, 0xaf },
+         { 0x014b, 0xbf }, { 0x014c, 0xd2 }, { 0x014d, 0xf2 }, { 0x0160, 0xaa },
+         { 0x0161, 0xba }, { 0x0166, 0xab }, { 0x0167, 0xbb }, { 0x0168, 0xd7 },
+         { 0x0169, 0xf7 }, { 0x016a, 0xae }, { 0x016b, 0xbe }, { 0x0172, 0xd9 },
+         { 0x0173, 0xf9 }, { 0x017d, 0xac }, { 0x017e, 0xbc }, { 0x2015, 0xbd },
+      };
+
+      // ISO/IEC 8859-11, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_11_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x0e01, 0xa1 }, { 0x0e02, 0xa2 }, { 0x0e03, 0xa3 },
+         { 0x0e04, 0xa4 }, { 0x0e05, 0xa5 }, { 0x0e06, 0xa6 }, { 0x0e07, 0xa7 },
+         { 0x0e08, 0xa8 }, { 0x0e09, 0xa9 }, { 0x0e0a, 0xaa }, { 0x0e0b, 0xab },
+         { 0x0e0c, 0xac }, { 0x0e0d, 0xad }, { 0x0e0e, 0xae }, { 0x0e0f, 0xaf },
+         { 0x0e10, 0xb0 }, { 0x0e11, 0xb1 }, { 0x0e12, 0xb2 }, { 0x0e13, 0xb3 },
+         { 0x0e14, 0xb4 }, { 0x0e15, 0xb5 }, { 0x0e16, 0xb6 }, { 0x0e17, 0xb7 },
+         { 0x0e18, 0xb8 }, { 0x0e19, 0xb9 }, { 0x0e1a, 0xba }, { 0x0e1b, 0xbb },
+         { 0x0e1c, 0xbc }, { 0x0e1d, 0xbd }, { 0x0e1e, 0xbe }, { 0x0e1f, 0xbf },
+         { 0x0e20, 0xc0 }, { 0x0e21, 0xc1 }, { 0x0e22, 0xc2 }, { 0x0e23, 0xc3 },
+         { 0x0e24, 0xc4 }, { 0x0e25, 0xc5 }, { 0x0e26, 0xc6 }, { 0x0e27, 0xc7 },
+         { 0x0e28, 0xc8 }, { 0x0e29, 0xc9 }, { 0x0e2a, 0xca }, { 0x0e2b, 0xcb },
+         { 0x0e2c, 0xcc }, { 0x0e2d, 0xcd }, { 0x0e2e, 0xce }, { 0x0e2f, 0xcf },
+         { 0x0e30, 0xd0 }, { 0x0e31, 0xd1 }, { 0x0e32, 0xd2 }, { 0x0e33, 0xd3 },
+         { 0x0e34, 0xd4 }, { 0x0e35, 0xd5 }, { 0x0e36, 0xd6 }, { 0x0e37, 0xd7 },
+         { 0x0e38, 0xd8 }, { 0x0e39, 0xd9 }, { 0x0e3a, 0xda }, { 0x0e3f, 0xdf },
+         { 0x0e40, 0xe0 }, { 0x0e41, 0xe1 }, { 0x0e42, 0xe2 }, { 0x0e43, 0xe3 },
+         { 0x0e44, 0xe4 }, { 0x0e45, 0xe5 }, { 0x0e46, 0xe6 }, { 0x0e47, 0xe7 },
+         { 0x0e48, 0xe8 }, { 0x0e49, 0xe9 }, { 0x0e4a, 0xea }, { 0x0e4b, 0xeb },
+         { 0x0e4c, 0xec }, { 0x0e4d, 0xed }, { 0x0e4e, 0xee }, { 0x0e4f, 0xef },
+         { 0x0e50, 0xf0 }, { 0x0e51, 0xf1 }, { 0x0e52, 0xf2 }, { 0x0e53, 0xf3 },
+         { 0x0e54, 0xf4 }, { 0x0e55, 0xf5 }, { 0x0e56, 0xf6 }, { 0x0e57, 0xf7 },
+         { 0x0e58, 0xf8 }, { 0x0e59, 0xf9 }, { 0x0e5a, 0xfa }, { 0x0e5b, 0xfb },
+      };
+
+      // ISO/IEC 8859-13, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_13_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x00a2, 0xa2 }, { 0x00a3, 0xa3 }, { 0x00a4, 0xa4 },
+         { 0x00a6, 0xa6 }, { 0x00a7, 0xa7 }, { 0x00a9, 0xa9 }, { 0x00ab, 0xab },
+         { 0x00ac, 0xac }, { 0x00ad, 0xad }, { 0x00ae, 0xae }, { 0x00b0, 0xb0 },
+         { 0x00b1, 0xb1 }, { 0x00b2, 0xb2 }, { 0x00b3, 0xb3 }, { 0x00b5, 0xb5 },
+         { 0x00b6, 0xb6 }, { 0x00b7, 0xb7 }, { 0x00b9, 0xb9 }, { 0x00bb, 0xbb },
+         { 0x00bc, 0xbc }, { 0x00bd, 0xbd }, { 0x00be, 0xbe }, { 0x00c4, 0xc4 },
+         { 0x00c5, 0xc5 }, { 0x00c6, 0xaf }, { 0x00c9, 0xc9 }, { 0x00d3, 0xd3 },
+         { 0x00d5, 0xd5 }, { 0x00d6, 0xd6 }, { 0x00d7, 0xd7 }, { 0x00d8, 0xa8 },
+         { 0x00dc, 0xdc }, { 0x00df, 0xdf }, { 0x00e4, 0xe4 }, { 0x00e5, 0xe5 },
+         { 0x00e6, 0xbf }, { 0x00e9, 0xe9 }, { 0x00f3, 0xf3 }, { 0x00f5, 0xf5 },
+         { 0x00f6, 0xf6 }, { 0x00f7, 0xf7 }, { 0x00f8, 0xb8 }, { 0x00fc, 0xfc },
+         { 0x0100, 0xc2 }, { 0x0101, 0xe2 }, { 0x0104, 0xc0 }, { 0x0105, 0xe0 },
+         { 0x0106, 0xc3 }, { 0x0107, 0xe3 }, { 0x010c, 0xc8 }, { 0x010d, 0xe8 },
+         { 0x0112, 0xc7 }, { 0x0113, 0xe7 }, { 0x0116, 0xcb }, { 0x0117, 0xeb },
+         { 0x0118, 0xc6 }, { 0x0119, 0xe6 }, { 0x0122, 0xcc }, { 0x0123, 0xec },
+         { 0x012a, 0xce }, { 0x012b, 0xee }, { 0x012e, 0xc1 }, { 0x012f, 0xe1 },
+         { 0x0136, 0xcd }, { 0x0137, 0xed }, { 0x013b, 0xcf }, { 0x013c, 0xef },
+         { 0x0141, 0xd9 }, { 0x0142, 0xf9 }, { 0x0143, 0xd1 }, { 0x0144, 0xf1 },
+         { 0x0145, 0xd2 }, { 0x0146, 0xf2 }, { 0x014c, 0xd4 }, { 0x014d, 0xf4 },
+         { 0x0156, 0xaa }, { 0x0157, 0xba }, { 0x015a, 0xda }, { 0x015b, 0xfa },
+         { 0x0160, 0xd0 }, { 0x0161, 0xf0 }, { 0x016a, 0xdb }, { 0x016b, 0xfb },
+         { 0x0172, 0xd8 }, { 0x0173, 0xf8 }, { 0x0179, 0xca }, { 0x017a, 0xea },
+         { 0x017b, 0xdd }, { 0x017c, 0xfd }, { 0x017d, 0xde }, { 0x017e, 0xfe },
+         { 0x2019, 0xff }, { 0x201c, 0xb4 }, { 0x201d, 0xa1 }, { 0x201e, 0xa5 },
+      };
+
+      // ISO/IEC 8859-14, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_14_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x00a3, 0xa3 }, { 0x00a7, 0xa7 }, { 0x00a9, 0xa9 },
+         { 0x00ad, 0xad }, { 0x00ae, 0xae }, { 0x00b6, 0xb6 }, { 0x00c0, 0xc0 },
+         { 0x00c1, 0xc1 }, { 0x00c2, 0xc2 }, { 0x00c3, 0xc3 }, { 0x00c4, 0xc4 },
+         { 0x00c5, 0xc5 }, { 0x00c6, 0xc6 }, { 0x00c7, 0xc7 }, { 0x00c8, 0xc8 },
+         { 0x00c9, 0xc9 }, { 0x00ca, 0xca }, { 0x00cb, 0xcb }, { 0x00cc, 0xcc },
+         { 0x00cd, 0xcd }, { 0x00ce, 0xce }, { 0x00cf, 0xcf }, { 0x00d1, 0xd1 },
+         { 0x00d2, 0xd2 }, { 0x00d3, 0xd3 }, { 0x00d4, 0xd4 }, { 0x00d5, 0xd5 },
+         { 0x00d6, 0xd6 }, { 0x00d8, 0xd8 }, { 0x00d9, 0xd9 }, { 0x00da, 0xda },
+         { 0x00db, 0xdb }, { 0x00dc, 0xdc }, { 0x00dd, 0xdd }, { 0x00df, 0xdf },
+         { 0x00e0, 0xe0 }, { 0x00e1, 0xe1 }, { 0x00e2, 0xe2 }, { 0x00e3, 0xe3 },
+         { 0x00e4, 0xe4 }, { 0x00e5, 0xe5 }, { 0x00e6, 0xe6 }, { 0x00e7, 0xe7 },
+         { 0x00e8, 0xe8 }, { 0x00e9, 0xe9 }, { 0x00ea, 0xea }, { 0x00eb, 0xeb },
+         { 0x00ec, 0xec }, { 0x00ed, 0xed }, { 0x00ee, 0xee }, { 0x00ef, 0xef },
+         { 0x00f1, 0xf1 }, { 0x00f2, 0xf2 }, { 0x00f3, 0xf3 }, { 0x00f4, 0xf4 },
+         { 0x00f5, 0xf5 }, { 0x00f6, 0xf6 }, { 0x00f8, 0xf8 }, { 0x00f9, 0xf9 },
+         { 0x00fa, 0xfa }, { 0x00fb, 0xfb }, { 0x00fc, 0xfc }, { 0x00fd, 0xfd },
+         { 0x00ff, 0xff }, { 0x010a, 0xa4 }, { 0x010b, 0xa5 }, { 0x0120, 0xb2 },
+         { 0x0121, 0xb3 }, { 0x0174, 0xd0 }, { 0x0175, 0xf0 }, { 0x0176, 0xde },
+         { 0x0177, 0xfe }, { 0x0178, 0xaf }, { 0x1e02, 0xa1 }, { 0x1e03, 0xa2 },
+         { 0x1e0a, 0xa6 }, { 0x1e0b, 0xab }, { 0x1e1e, 0xb0 }, { 0x1e1f, 0xb1 },
+         { 0x1e40, 0xb4 }, { 0x1e41, 0xb5 }, { 0x1e56, 0xb7 }, { 0x1e57, 0xb9 },
+         { 0x1e60, 0xbb }, { 0x1e61, 0xbf }, { 0x1e6a, 0xd7 }, { 0x1e6b, 0xf7 },
+         { 0x1e80, 0xa8 }, { 0x1e81, 0xb8 }, { 0x1e82, 0xaa }, { 0x1e83, 0xba },
+         { 0x1e84, 0xbd }, { 0x1e85, 0xbe }, { 0x1ef2, 0xac }, { 0x1ef3, 0xbc },
+      };
+
+      // ISO/IEC 8859-15, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_15_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x00a1, 0xa1 }, { 0x00a2, 0xa2 }, { 0x00a3, 0xa3 },
+         { 0x00a5, 0xa5 }, { 0x00a7, 0xa7 }, { 0x00a9, 0xa9 }, { 0x00aa, 0xaa },
+         { 0x00ab, 0xab }, { 0x00ac, 0xac }, { 0x00ad, 0xad }, { 0x00ae, 0xae },
+         { 0x00af, 0xaf }, { 0x00b0, 0xb0 }, { 0x00b1, 0xb1 }, { 0x00b2, 0xb2 },
+         { 0x00b3, 0xb3 }, { 0x00b5, 0xb5 }, { 0x00b6, 0xb6 }, { 0x00b7, 0xb7 },
+         { 0x00b9, 0xb9 }, { 0x00ba, 0xba }, { 0x00bb, 0xbb }, { 0x00bf, 0xbf },
+         { 0x00c0, 0xc0 }, { 0x00c1, 0xc1 }, { 0x00c2, 0xc2 }, { 0x00c3, 0xc3 },
+         { 0x00c4, 0xc4 }, { 0x00c5, 0xc5 }, { 0x00c6, 0xc6 }, { 0x00c7, 0xc7 },
+         { 0x00c8, 0xc8 }, { 0x00c9, 0xc9 }, { 0x00ca, 0xca }, { 0x00cb, 0xcb },
+         { 0x00cc, 0xcc }, { 0x00cd, 0xcd }, { 0x00ce, 0xce }, { 0x00cf, 0xcf },
+         { 0x00d0, 0xd0 }, { 0x00d1, 0xd1 }, { 0x00d2, 0xd2 }, { 0x00d3, 0xd3 },
+         { 0x00d4, 0xd4 }, { 0x00d5, 0xd5 }, { 0x00d6, 0xd6 }, { 0x00d7, 0xd7 },
+         { 0x00d8, 0xd8 }, { 0x00d9, 0xd9 }, { 0x00da, 0xda }, { 0x00db, 0xdb },
+         { 0x00dc, 0xdc }, { 0x00dd, 0xdd }, { 0x00de, 0xde }, { 0x00df, 0xdf },
+         { 0x00e0, 0xe0 }, { 0x00e1, 0xe1 }, { 0x00e2, 0xe2 }, { 0x00e3, 0xe3 },
+         { 0x00e4, 0xe4 }, { 0x00e5, 0xe5 }, { 0x00e6, 0xe6 }, { 0x00e7, 0xe7 },
+         { 0x00e8, 0xe8 }, { 0x00e9, 0xe9 }, { 0x00ea, 0xea }, { 0x00eb, 0xeb },
+         { 0x00ec, 0xec }, { 0x00ed, 0xed }, { 0x00ee, 0xee }, { 0x00ef, 0xef },
+         { 0x00f0, 0xf0 }, { 0x00f1, 0xf1 }, { 0x00f2, 0xf2 }, { 0x00f3, 0xf3 },
+         { 0x00f4, 0xf4 }, { 0x00f5, 0xf5 }, { 0x00f6, 0xf6 }, { 0x00f7, 0xf7 },
+         { 0x00f8, 0xf8 }, { 0x00f9, 0xf9 }, { 0x00fa, 0xfa }, { 0x00fb, 0xfb },
+         { 0x00fc, 0xfc }, { 0x00fd, 0xfd }, { 0x00fe, 0xfe }, { 0x00ff, 0xff },
+         { 0x0152, 0xbc }, { 0x0153, 0xbd }, { 0x0160, 0xa6 }, { 0x0161, 0xa8 },
+         { 0x0178, 0xbe }, { 0x017d, 0xb4 }, { 0x017e, 0xb8 }, { 0x20ac, 0xa4 },
+      };
+
+      // ISO/IEC 8859-1, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_1_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x00a1, 0xa1 }, { 0x00a2, 0xa2 }, { 0x00a3, 0xa3 },
+         { 0x00a4, 0xa4 }, { 0x00a5, 0xa5 }, { 0x00a6, 0xa6 }, { 0x00a7, 0xa7 },
+         { 0x00a8, 0xa8 }, { 0x00a9, 0xa9 }, { 0x00aa, 0xaa }, { 0x00ab, 0xab },
+         { 0x00ac, 0xac }, { 0x00ad, 0xad }, { 0x00ae, 0xae }, { 0x00af, 0xaf },
+         { 0x00b0, 0xb0 }, { 0x00b1, 0xb1 }, { 0x00b2, 0xb2 }, { 0x00b3, 0xb3 },
+         { 0x00b4, 0xb4 }, { 0x00b5, 0xb5 }, { 0x00b6, 0xb6 }, { 0x00b7, 0xb7 },
+         { 0x00b8, 0xb8 }, { 0x00b9, 0xb9 }, { 0x00ba, 0xba }, { 0x00bb, 0xbb },
+         { 0x00bc, 0xbc }, { 0x00bd, 0xbd }, { 0x00be, 0xbe }, { 0x00bf, 0xbf },
+         { 0x00c0, 0xc0 }, { 0x00c1, 0xc1 }, { 0x00c2, 0xc2 }, { 0x00c3, 0xc3 },
+         { 0x00c4, 0xc4 }, { 0x00c5, 0xc5 }, { 0x00c6, 0xc6 }, { 0x00c7, 0xc7 },
+         { 0x00c8, 0xc8 }, { 0x00c9, 0xc9 }, { 0x00ca, 0xca }, { 0x00cb, 0xcb },
+         { 0x00cc, 0xcc }, { 0x00cd, 0xcd }, { 0x00ce, 0xce }, { 0x00cf, 0xcf },
+         { 0x00d0, 0xd0 }, { 0x00d1, 0xd1 }, { 0x00d2, 0xd2 }, { 0x00d3, 0xd3 },
+         { 0x00d4, 0xd4 }, { 0x00d5, 0xd5 }, { 0x00d6, 0xd6 }, { 0x00d7, 0xd7 },
+         { 0x00d8, 0xd8 }, { 0x00d9, 0xd9 }, { 0x00da, 0xda }, { 0x00db, 0xdb },
+         { 0x00dc, 0xdc }, { 0x00dd, 0xdd }, { 0x00de, 0xde }, { 0x00df, 0xdf },
+         { 0x00e0, 0xe0 }, { 0x00e1, 0xe1 }, { 0x00e2, 0xe2 }, { 0x00e3, 0xe3 },
+         { 0x00e4, 0xe4 }, { 0x00e5, 0xe5 }, { 0x00e6, 0xe6 }, { 0x00e7, 0xe7 },
+         { 0x00e8, 0xe8 }, { 0x00e9, 0xe9 }, { 0x00ea, 0xea }, { 0x00eb, 0xeb },
+         { 0x00ec, 0xec }, { 0x00ed, 0xed }, { 0x00ee, 0xee }, { 0x00ef, 0xef },
+         { 0x00f0, 0xf0 }, { 0x00f1, 0xf1 }, { 0x00f2, 0xf2 }, { 0x00f3, 0xf3 },
+         { 0x00f4, 0xf4 }, { 0x00f5, 0xf5 }, { 0x00f6, 0xf6 }, { 0x00f7, 0xf7 },
+         { 0x00f8, 0xf8 }, { 0x00f9, 0xf9 }, { 0x00fa, 0xfa }, { 0x00fb, 0xfb },
+         { 0x00fc, 0xfc }, { 0x00fd, 0xfd }, { 0x00fe, 0xfe }, { 0x00ff, 0xff },
+      };
+
+      // ISO/IEC 8859-2, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_2_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x00a4, 0xa4 }, { 0x00a7, 0xa7 }, { 0x00a8, 0xa8 },
+         { 0x00ad, 0xad }, { 0x00b0, 0xb0 }, { 0x00b4, 0xb4 }, { 0x00b8, 0xb8 },
+         { 0x00c1, 0xc1 }, { 0x00c2, 0xc2 }, { 0x00c4, 0xc4 }, { 0x00c7, 0xc7 },
+         { 0x00c9, 0xc9 }, { 0x00cb, 0xcb }, { 0x00cd, 0xcd }, { 0x00ce, 0xce },
+         { 0x00d3, 0xd3 }, { 0x00d4, 0xd4 }, { 0x00d6, 0xd6 }, { 0x00d7, 0xd7 },
+         { 0x00da, 0xda }, { 0x00dc, 0xdc }, { 0x00dd, 0xdd }, { 0x00df, 0xdf },
+         { 0x00e1, 0xe1 }, { 0x00e2, 0xe2 }, { 0x00e4, 0xe4 }, { 0x00e7, 0xe7 },
+         { 0x00e9, 0xe9 }, { 0x00eb, 0xeb }, { 0x00ed, 0xed }, { 0x00ee, 0xee },
+         { 0x00f3, 0xf3 }, { 0x00f4, 0xf4 }, { 0x00f6, 0xf6 }, { 0x00f7, 0xf7 },
+         { 0x00fa, 0xfa }, { 0x00fc, 0xfc }, { 0x00fd, 0xfd }, { 0x0102, 0xc3 },
+         { 0x0103, 0xe3 }, { 0x0104, 0xa1 }, { 0x0105, 0xb1 }, { 0x0106, 0xc6 },
+         { 0x0107, 0xe6 }, { 0x010c, 0xc8 }, { 0x010d, 0xe8 }, { 0x010e, 0xcf },
+         { 0x010f, 0xef }, { 0x0110, 0xd0 }, { 0x0111, 0xf0 }, { 0x0118, 0xca },
+         { 0x0119, 0xea }, { 0x011a, 0xcc }, { 0x011b, 0xec }, { 0x0139, 0xc5 },
+         { 0x013a, 0xe5 }, { 0x013d, 0xa5 }, { 0x013e, 0xb5 }, { 0x0141, 0xa3 },
+         { 0x0142, 0xb3 }, { 0x0143, 0xd1 }, { 0x0144, 0xf1 }, { 0x0147, 0xd2 },
+         { 0x0148, 0xf2 }, { 0x0150, 0xd5 }, { 0x0151, 0xf5 }, { 0x0154, 0xc0 },
+         { 0x0155, 0xe0 }, { 0x0158, 0xd8 }, { 0x0159, 0xf8 }, { 0x015a, 0xa6 },
+         { 0x015b, 0xb6 }, { 0x015e, 0xaa }, { 0x015f, 0xba }, { 0x0160, 0xa9 },
+         { 0x0161, 0xb9 }, { 0x0162, 0xde }, { 0x0163, 0xfe }, { 0x0164, 0xab },
+         { 0x0165, 0xbb }, { 0x016e, 0xd9 }, { 0x016f, 0xf9 }, { 0x0170, 0xdb },
+         { 0x0171, 0xfb }, { 0x0179, 0xac }, { 0x017a, 0xbc }, { 0x017b, 0xaf },
+         { 0x017c, 0xbf }, { 0x017d, 0xae }, { 0x017e, 0xbe }, { 0x02c7, 0xb7 },
+         { 0x02d8, 0xa2 }, { 0x02d9, 0xff }, { 0x02db, 0xb2 }, { 0x02dd, 0xbd },
+      };
+
+      // ISO/IEC 8859-3, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_3_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x00a3, 0xa3 }, { 0x00a4, 0xa4 }, { 0x00a7, 0xa7 },
+         { 0x00a8, 0xa8 }, { 0x00ad, 0xad }, { 0x00b0, 0xb0 }, { 0x00b2, 0xb2 },
+         { 0x00b3, 0xb3 }, { 0x00b4, 0xb4 }, { 0x00b5, 0xb5 }, { 0x00b7, 0xb7 },
+         { 0x00b8, 0xb8 }, { 0x00bd, 0xbd }, { 0x00c0, 0xc0 }, { 0x00c1, 0xc1 },
+         { 0x00c2, 0xc2 }, { 0x00c4, 0xc4 }, { 0x00c7, 0xc7 }, { 0x00c8, 0xc8 },
+         { 0x00c9, 0xc9 }, { 0x00ca, 0xca }, { 0x00cb, 0xcb }, { 0x00cc, 0xcc },
+         { 0x00cd, 0xcd }, { 0x00ce, 0xce }, { 0x00cf, 0xcf }, { 0x00d1, 0xd1 },
+         { 0x00d2, 0xd2 }, { 0x00d3, 0xd3 }, { 0x00d4, 0xd4 }, { 0x00d6, 0xd6 },
+         { 0x00d7, 0xd7 }, { 0x00d9, 0xd9 }, { 0x00da, 0xda }, { 0x00db, 0xdb },
+         { 0x00dc, 0xdc }, { 0x00df, 0xdf }, { 0x00e0, 0xe0 }, { 0x00e1, 0xe1 },
+         { 0x00e2, 0xe2 }, { 0x00e4, 0xe4 }, { 0x00e7, 0xe7 }, { 0x00e8, 0xe8 },
+         { 0x00e9, 0xe9 }, { 0x00ea, 0xea }, { 0x00eb, 0xeb }, { 0x00ec, 0xec },
+         { 0x00ed, 0xed }, { 0x00ee, 0xee }, { 0x00ef, 0xef }, { 0x00f1, 0xf1 },
+         { 0x00f2, 0xf2 }, { 0x00f3, 0xf3 }, { 0x00f4, 0xf4 }, { 0x00f6, 0xf6 },
+         { 0x00f7, 0xf7 }, { 0x00f9, 0xf9 }, { 0x00fa, 0xfa }, { 0x00fb, 0xfb },
+         { 0x00fc, 0xfc }, { 0x0108, 0xc6 }, { 0x0109, 0xe6 }, { 0x010a, 0xc5 },
+         { 0x010b, 0xe5 }, { 0x011c, 0xd8 }, { 0x011d, 0xf8 }, { 0x011e, 0xab },
+         { 0x011f, 0xbb }, { 0x0120, 0xd5 }, { 0x0121, 0xf5 }, { 0x0124, 0xa6 },
+         { 0x0125, 0xb6 }, { 0x0126, 0xa1 }, { 0x0127, 0xb1 }, { 0x0130, 0xa9 },
+         { 0x0131, 0xb9 }, { 0x0134, 0xac }, { 0x0135, 0xbc }, { 0x015c, 0xde },
+         { 0x015d, 0xfe }, { 0x015e, 0xaa }, { 0x015f, 0xba }, { 0x016c, 0xdd },
+         { 0x016d, 0xfd }, { 0x017b, 0xaf }, { 0x017c, 0xbf }, { 0x02d8, 0xa2 },
+         { 0x02d9, 0xff },
+      };
+
+      // ISO/IEC 8859-4, 0xa0 - 0xff
+      const Iso8859Char ISO_8859_4_CHARS[] = {
+         { 0x00a0, 0xa0 }, { 0x00a4, 0xa4 }, { 0x00a7, 0xa7 }, { 0x00a8, 0xa8 },
+         { 0x00ad, 0xad }, { 0x00af, 0xaf }, { 0x00b0, 0xb0 }, { 0x00b4, 0xb4 },
+         { 0x00b8, 0xb8 }, { 0x00c1, 0xc1 }, { 0x00c2, 0xc2 }, { 0x00c3, 0xc3 },
+         { 0x00c4, 0xc4 }, { 0x00c5, 0xc5 }, { 0x00c6, 0xc6 }, { 0x00c9, 0xc9 },
+         { 0x00cb, 0xcb }, { 0x00cd, 0xcd }, { 0x00ce, 0xce }, { 0x00d4, 0xd4 },
+         { 0x00d5, 0xd5 }, { 0x00d6, 0xd6 }, { 0x00d7, 0xd7 }, { 0x00d8, 0xd8 },
+         { 0x00da, 0xda }, { 0x00db, 0xdb }, { 0x00dc, 0xdc }, { 0x00df, 0xdf },
+         { 0x00e1, 0xe1 }, { 0x00e2, 0xe2 }, { 0x00e3, 0xe3 }, { 0x00e4, 0xe4 },
+         { 0x00e5, 0xe5 }, { 0x00e6, 0xe6 }, { 0x00e9, 0xe9 }, { 0x00eb, 0xeb },
+         { 0x00ed, 0xed }, { 0x00ee, 0xee }, { 0x00f4, 0xf4 }, { 0x00f5, 0xf5 },
+         { 0x00f6, 0xf6 }, { 0x00f7, 0xf7 }, { 0x00f8, 0xf8 }, { 0x00fa, 0xfa },
+         { 0x00fb, 0xfb }, { 0x00fc, 0xfc }, { 0x0100, 0xc0 }, { 0x0101, 0xe0 },
+         { 0x0104, 0xa1 }, { 0x0105, 0xb1 }, { 0x010c, 0xc8 }, { 0x010d, 0xe8 },
+         { 0x0110, 0xd0 }, { 0x0111, 0xf0 }, { 0x0112, 0xaa }, { 0x0113, 0xba },
+         { 0x0116, 0xcc }, { 0x0117, 0xec }, { 0x0118, 0xca }, { 0x0119, 0xea },
+         { 0x0122, 0xab }, { 0x0123, 0xbb }, { 0x0128, 0xa5 }, { 0x0129, 0xb5 },
+         { 0x012a, 0xcf }, { 0x012b, 0xef }, { 0x012e, 0xc7 }, { 0x012f, 0xe7 },
+         { 0x0136, 0xd3 }, { 0x0137, 0xf3 }, { 0x0138, 0xa2 }, { 0x013b, 0xa6 },
+         { 0x013c, 0xb6 }, { 0x0145, 0xd1 }, { 0x0146, 0xf1 }, { 0x014a, 0xbd },
+         { 0x014b, 0xbf }, { 0x014c, 0xd2 }, { 0x014d, 0xf2 }, { 0x0156, 0xa3 },
+         { 0x0157, 0xb3 }, { 0x0160, 0xa9 }, { 0x0161, 0xb9 }, { 0x0166, 0xac },
+         { 0x0167, 0xbc }, { 0x0168, 0xdd }, { 0x0169, 0xfd }, { 0x016a, 0xde },
+         { 0x016b, 0xfe }, { 0x0172, 0xd9 }, { 0x0173, 0xf9 }, { 0x017d, 0xae },
+         { 0x017e, 0xbe }, { 0x02c7, 0xb7 }, { 0x02d9, 0xff }, { 0x02db, 0xb2 },
+      };
+
+      struct Charset {
+         TextEncoder::Table table;
+         const Iso8859Char* chars;
+         size_t count;
+      };
+
+      // in order of preference when encodings tie in length
+#define CHARSET(t) { TextEncoder::t, t##_CHARS, sizeof(t##_CHARS) / sizeof(t##_CHARS[0]) }
+      const Charset CHARSETS[] = {
+         CHARSET(ISO_8859_15), CHARSET(ISO_8859_5),  CHARSET(ISO_8859_7),
+         CHARSET(ISO_8859_9),  CHARSET(ISO_8859_10), CHARSET(ISO_8859_13),
+         CHARSET(ISO_8859_14), CHARSET(ISO_8859_6),  CHARSET(ISO_8859_8),
+         CHARSET(ISO_8859_11), CHARSET(ISO_8859_1),  CHARSET(ISO_8859_2),
+         CHARSET(ISO_8859_3),  CHARSET(ISO_8859_4),
+      };
+#undef CHARSET
+
+      const ui32 NO_FIT = 0xffffffff;
+
+      // returns the code for cp, 0 if the table doesn't have it
+      ui16 find6937(ui32 cp)
+      {
+         const Iso6937Char* end = ISO_6937_CHARS + sizeof(ISO_6937_CHARS) / sizeof(ISO_6937_CHARS[0]);
+         const Iso6937Char* c = std::lower_bound(ISO_6937_CHARS, end, cp,
+                                                 [](const Iso6937Char& e, ui32 v) { return e.cp < v; });
+         return (c != end && c->cp == cp) ? c->code : 0;
+      }
+
+      ui8 find8859(const Charset& cs, ui32 cp)
+      {
+         const Iso8859Char* end = cs.chars + cs.count;
+         const Iso8859Char* c = std::lower_bound(cs.chars, end, cp,
+                                                 [](const Iso8859Char& e, ui32 v) { return e.cp < v; });
+         return (c != end && c->cp == cp) ? c->code : 0;
+      }
+
+      const Charset& charset(TextEncoder::Table t)
+      {
+         const Charset* cs = std::find_if(std::begin(CHARSETS), std::end(CHARSETS),
+                                          [=](const Charset& c) { return c.table == t; });
+         return *cs;
+      }
+
+      ui8 selectorLength(TextEncoder::Table t)
+      {
+         return (t == TextEncoder::ISO_6937) ? 0 : ((t > 0xff) ? 3 : 1);
+      }
+
+      // number of continuation bytes following a UTF-8 lead byte, -1 if invalid
+      int seqLength(ui8 c)
+      {
+         if ((c & 0xe0) == 0xc0)
+            return 1;
+         if ((c & 0xf0) == 0xe0)
+            return 2;
+         if ((c & 0xf8) == 0xf0)
+            return 3;
+         return -1;
+      }
+   }
+
+   using namespace text_encoder_priv;
+
+
+   //
+   // length of the leading run of printable ASCII (0x20 - 0x7e) -
+   // these map to themselves in every table, so most of an EPG string
+   // is handled here 16 bytes at a time
+   size_t TextEncoder::asciiPrefix(const char* s, size_t len)
+   {
+      size_t i = 0;
+
+#ifdef __SSE2__
+      const __m128i ctrl = _mm_set1_epi8(0x1f);
+      const __m128i del = _mm_set1_epi8(0x7f);
+
+      for (; i + 16 <= len; i += 16) {
+         __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+         // signed compare, so bytes >= 0x80 fail it too
+         __m128i ok = _mm_andnot_si128(_mm_cmpeq_epi8(v, del), _mm_cmpgt_epi8(v, ctrl));
+         unsigned mask = _mm_movemask_epi8(ok);
+         if (mask != 0xffff)
+            return i + __builtin_ctz(~mask);
+      }
+#endif
+
+      for (; i < len; i++) {
+         ui8 c = s[i];
+         if (c < 0x20 || c > 0x7e)
+            break;
+      }
+      return i;
+   }
+
+
+   //
+   // collects the non-ASCII code points and the output sizes. Returns
+   // false if the string isn't valid UTF-8
+   bool TextEncoder::decode(const std::string& utf8, size_t i)
+   {
+      const char* s = utf8.data();
+      const size_t len = utf8.length();
+
+      wide.clear();
+      num_chars = utf8_len = i;
+
+      while (i < len) {
+         size_t run = asciiPrefix(s + i, len - i);
+         num_chars += run;
+         utf8_len += run;
+         if ((i += run) == len)
+            break;
+
+         ui8 c = s[i];
+         if (c < 0x80) {
+            // only line feeds are kept (as CR/LF, U+E08A in UTF-8)
+            if (c == '\n') {
+               num_chars++;
+               utf8_len += 3;
+            }
+            i++;
+            continue;
+         }
+
+         int n = seqLength(c);
+         if (n < 0 || i + n >= len)
+            return false;
+
+         ui32 cp = c & (0x3f >> n);
+         for (int k = 1; k <= n; k++) {
+            ui8 cc = s[i + k];
+            if ((cc & 0xc0) != 0x80)
+               return false;
+            cp = (cp << 6) | (cc & 0x3f);
+         }
+         i += n + 1;
+
+         // C1 control codes map to U+E080 - U+E09F in UTF-8
+         num_chars++;
+         utf8_len += (cp < 0xa0) ? 3 : n + 1;
+         wide.push_back(cp);
+      }
+      return true;
+   }
+
+
+   //
+   // encoded length (selector included) using the given table
+   ui32 TextEncoder::cost(Table t) const
+   {
+      if (t == UTF8)
+         return 1 + utf8_len;
+
+      ui32 c = selectorLength(t) + num_chars;
+
+      if (t == ISO_6937) {
+         for (ui32 cp : wide) {
+            if (cp < 0xa0)
+               continue;
+            ui16 code = find6937(cp);
+            if (!code)
+               return NO_FIT;
+            if (code > 0xff)
+               c++;
+         }
+      }
+      else {
+         const Charset& cs = charset(t);
+         for (ui32 cp : wide) {
+            if (cp >= 0xa0 && !find8859(cs, cp))
+               return NO_FIT;
+         }
+      }
+      return c;
+   }
+
+
+   //
+   // writes the selector and the text converted to the table
+   void TextEncoder::encodeBytes(Table t, const std::string& utf8, std::string& out) const
+   {
+      const char* s = utf8.data();
+      const size_t len = utf8.length();
+
+      out.reserve( cost(t) );
+      if (t > 0xff) {
+         out.push_back( 0x10 );
+         out.push_back( 0x00 );
+         out.push_back( static_cast<char>(t & 0xff) );
+      }
+      else if (t != ISO_6937)
+         out.push_back( static_cast<char>(t) );
+
+      const Charset* cs = (t != ISO_6937 && t != UTF8) ? &charset(t) : nullptr;
+
+      size_t i = 0;
+      while (i < len) {
+         size_t run = asciiPrefix(s + i, len - i);
+         out.append(s + i, run);
+         if ((i += run) == len)
+            break;
+
+         ui8 c = s[i];
+         if (c < 0x80) {
+            if (c == '\n') {
+               if (t == UTF8)
+                  out.append("\xee\x82\x8a");
+               else
+                  out.push_back( static_cast<char>(CRLF) );
+            }
+            i++;
+            continue;
+         }
+
+         int n = seqLength(c);
+         ui32 cp = c & (0x3f >> n);
+         for (int k = 1; k <= n; k++)
+            cp = (cp << 6) | (s[i + k] & 0x3f);
+
+         if (cp < 0xa0) {
+            // control code
+            if (t == UTF8) {
+               out.push_back( '\xee' );
+               out.push_back( '\x82' );
+               out.push_back( static_cast<char>(0x80 | (cp & 0x3f)) );
+            }
+            else
+               out.push_back( static_cast<char>(cp) );
+         }
+         else if (t == UTF8)
+            out.append(s + i, n + 1);
+         else if (t == ISO_6937) {
+            ui16 code = find6937(cp);
+            if (code > 0xff)
+               out.push_back( static_cast<char>(code >> 8) );
+            out.push_back( static_cast<char>(code & 0xff) );
+         }
+         else
+            out.push_back( static_cast<char>(find8859(*cs, cp)) );
+
+         i += n + 1;
+      }
+   }
+
+
+   //
+   // converts the string to the table giving the shortest output
+   TextEncoder::Table TextEncoder::encode(const std::string& utf8, std::string& out)
+   {
+      out.clear();
+
+      // plain ASCII is valid as is in the default table
+      size_t ascii = asciiPrefix(utf8.data(), utf8.length());
+      if (ascii == utf8.length()) {
+         out.assign(utf8);
+         return ISO_6937;
+      }
+
+      if (!decode(utf8, ascii)) {
+         // not much we can do.. pass it through as UTF-8
+         out.reserve(utf8.length() + 1);
+         out.push_back( static_cast<char>(UTF8) );
+         out.append(utf8);
+         return UTF8;
+      }
+
+      Table best = UTF8;
+      ui32 best_cost = cost(UTF8);
+
+      ui32 c = cost(ISO_6937);
+      if (c < best_cost) {
+         best = ISO_6937;
+         best_cost = c;
+      }
+
+      for (const Charset& cs : CHARSETS) {
+         // can't win if even one byte per char is longer
+         if (selectorLength(cs.table) + num_chars >= best_cost)
+            continue;
+
+         c = cost(cs.table);
+         if (c < best_cost) {
+            best = cs.table;
+            best_cost = c;
+         }
+      }
+
+      encodeBytes(best, utf8, out);
+      return best;
+   }
+
+} // namespace sigen
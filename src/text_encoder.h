@@ -0,0 +1,109 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// text_encoder.h: UTF-8 to EN 300 468 Annex A character table encoder
+// -----------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "types.h"
+
+namespace sigen {
+
+   /*!
+    * \brief Converts UTF-8 text to the DVB character tables
+    * (ETSI EN 300 468 Annex A) for use in text descriptor fields.
+    *
+    * The shortest encoding among ISO/IEC 6937 (the default table),
+    * the ISO/IEC 8859 tables and UTF-8 is chosen and the matching
+    * table selector bytes are prepended. Line feeds are mapped to the
+    * DVB CR/LF control code and other C0 control characters are
+    * dropped.
+    *
+    * Instances keep scratch buffers between calls so a single
+    * encoder should be reused for bulk conversion - but not shared
+    * across threads.
+    */
+   class TextEncoder
+   {
+   public:
+      //! \brief Character tables the encoder can select.
+      enum Table {
+         ISO_6937    = 0x00,      //!< Default table, no selector.
+         ISO_8859_5  = 0x01,      //!< Latin/Cyrillic.
+         ISO_8859_6  = 0x02,      //!< Latin/Arabic.
+         ISO_8859_7  = 0x03,      //!< Latin/Greek.
+         ISO_8859_8  = 0x04,      //!< Latin/Hebrew.
+         ISO_8859_9  = 0x05,      //!< Latin alphabet No. 5.
+         ISO_8859_10 = 0x06,      //!< Latin alphabet No. 6.
+         ISO_8859_11 = 0x07,      //!< Latin/Thai.
+         ISO_8859_13 = 0x09,      //!< Latin alphabet No. 7.
+         ISO_8859_14 = 0x0a,      //!< Latin alphabet No. 8 (Celtic).
+         ISO_8859_15 = 0x0b,      //!< Latin alphabet No. 9.
+         UTF8        = 0x15,      //!< UTF-8 encoding of ISO/IEC 10646.
+         ISO_8859_1  = 0x1001,    //!< West European (0x10 0x00 0x01 selector).
+         ISO_8859_2  = 0x1002,    //!< East European (0x10 0x00 0x02 selector).
+         ISO_8859_3  = 0x1003,    //!< South European (0x10 0x00 0x03 selector).
+         ISO_8859_4  = 0x1004     //!< North and North-East European (0x10 0x00 0x04 selector).
+      };
+
+      TextEncoder() = default;
+
+      // prohibit
+      TextEncoder(const TextEncoder&) = delete;
+      TextEncoder& operator=(const TextEncoder&) = delete;
+
+      /*!
+       * \brief Encode a UTF-8 string.
+       * \param utf8 Text to convert. Must be valid UTF-8.
+       * \param out Destination for the selector and encoded bytes (replaced).
+       * \return The character table used.
+       */
+      Table encode(const std::string& utf8, std::string& out);
+      /*!
+       * \brief Encode a UTF-8 string.
+       * \param utf8 Text to convert. Must be valid UTF-8.
+       * \return The selector and encoded bytes.
+       */
+      std::string encode(const std::string& utf8) {
+         std::string out;
+         encode(utf8, out);
+         return out;
+      }
+
+      // returns the length of the leading printable ASCII run
+      static size_t asciiPrefix(const char* s, size_t len);
+
+   private:
+      enum { CRLF = 0x8a };
+
+      // scratch state for the string being encoded: its non-ASCII
+      // code points, char count in a byte table and UTF-8 length
+      std::vector<ui32> wide;
+      ui32 num_chars = 0;
+      ui32 utf8_len = 0;
+
+      bool decode(const std::string& utf8, size_t from);
+      ui32 cost(Table t) const;
+      void encodeBytes(Table t, const std::string& utf8, std::string& out) const;
+   };
+
+} // sigen namespace
@@ -63,7 +63,7 @@ namespace sigen
    //
    // adds a descriptor to the loop
    //
-   bool TOT::addDesc(Descriptor &d)
+   bool TOT::add_desc(Descriptor &d, bool in_arena)
    {
       ui16 d_len = d.length();
 
@@ -71,7 +71,7 @@ namespace sigen
       if ( !incLength(d_len) )
          return false;
 
-      descriptors.add(d, d_len);
+      descriptors.add(d, d_len, in_arena);
       return true;
    }
 
@@ -81,24 +81,29 @@ namespace sigen
    //
    void TOT::buildSections(TStream &strm) const
    {
-      Section *s = strm.getNewSection( getMaxSectionLen() );
+      buildSection( *strm.getNewSection( getMaxSectionLen() ) );
+   }
 
-      STable::buildSections(*s);
+   bool TOT::buildSection(Section &s) const
+   {
+      if (s.capacity() < 3 + getDataLength() + Section::CRC_LEN)
+         return false;
+
+      s.reset();
+      STable::buildSections(s);
 
       // UTC data
-      s->set16Bits( utc.mjd );
-      s->set08Bits( utc.time.getBCDHour() );
-      s->set08Bits( utc.time.getBCDMinute() );
-      s->set08Bits( utc.time.getBCDSecond() );
+      s.setBits( utc );
 
       // reserved bits (4) and loop length (12)
-      s->set16Bits( rbits(~LEN_MASK) | (descriptors.loop_length() & LEN_MASK) );
+      s.set16Bits( rbits(~LEN_MASK) | (descriptors.loop_length() & LEN_MASK) );
 
       // descriptors
-      descriptors.buildSections(*s);
+      descriptors.buildSections(s);
 
       // crc it
-      s->calcCrc();
+      s.calcCrc();
+      return true;
    }
 
 } // namespace
@@ -28,6 +28,7 @@
 namespace sigen {
 
    class TStream;
+   class Section;
    class Descriptor;
 
    /*! \addtogroup table
@@ -45,7 +46,8 @@ namespace sigen {
    {
    public:
       enum {
-         PID = 0x14                 //!< Packet PID for transmission.
+         PID = 0x14,                //!< Packet PID for transmission.
+         MAX_SEC_LEN = 1024         //!< Maximum section length, e.g. for an InlineSection.
       };
 
       /*!
@@ -69,10 +71,23 @@ namespace sigen {
        * \brief Add a Descriptor to the descriptors loop.
        * \param desc Descriptor to add.
        */
-      bool addDesc(Descriptor& desc);
+      bool addDesc(Descriptor& desc) { return add_desc(desc, false); }
+      /*!
+       * \brief Construct a Descriptor in place in the descriptors loop.
+       *
+       * The `D` is built in the table's arena instead of being allocated
+       * on its own.
+       * \param args Arguments for the `D` constructor.
+       */
+      template <class D, class... Args>
+      bool emplaceDesc(Args&&... args) {
+         return emplace<D>([this](Descriptor& d) { return add_desc(d, true); },
+                           std::forward<Args>(args)...);
+      }
 
       // section data writer
       virtual void buildSections(TStream &) const;
+      virtual bool buildSection(Section &) const;
 
 #ifdef ENABLE_DUMP
       void dump(std::ostream &) const;
@@ -81,9 +96,10 @@ namespace sigen {
    private:
       UTC utc;
 
-      enum { MAX_SEC_LEN = 1024, TID = 0x73 };
+      enum { TID = 0x73 };
 
       DescList descriptors;
+      bool add_desc(Descriptor& d, bool in_arena);
    };
    //! @}
    //! @}
@@ -31,6 +31,7 @@
 namespace sigen {
 
    class LanguageCode;
+   class UTC;
 
    //
    // buffer object for storing the transport stream table
@@ -44,6 +45,8 @@ namespace sigen {
       ui32 crc;
       ui16 data_length;
       const ui16 size; // max size of the section (set at construction)
+      bool has_crc;    // calcCrc() has appended the crc
+      bool owns_data;  // data was allocated by the section
 
       // checks if len bytes can fit
       bool lengthFits(ui16 len) const { return ((data_length + len) <= size); }
@@ -53,7 +56,7 @@ namespace sigen {
 
       // constructor / destructor
       Section(ui16 section_size);
-      ~Section() { delete [] data; }
+      ~Section() { if (owns_data) delete [] data; }
       // prohibit
       Section(const Section &) = delete;
       Section(const Section &&) = delete;
@@ -67,6 +70,7 @@ namespace sigen {
 
       ui8 *getCurDataPosition() const { return pos; }
       ui32 getCRC() const { return crc; }
+      bool hasCRC() const { return has_crc; }
 
       // utility
       bool set08Bits(ui8 data);
@@ -82,6 +86,8 @@ namespace sigen {
       bool setBits(const std::string &data);
       bool setBits(const LanguageCode &code);
       bool setBits(const std::vector<ui8> &v);
+      bool setBits(const UTC &utc);              // packed mjd + bcd time
+      bool setBits(const ui8 *data, ui16 len);   // copies len bytes
 
       // sets data without incrementing pointer
       bool set08Bits(ui8 idx, ui8 data);
@@ -91,9 +97,46 @@ namespace sigen {
       void write(std::ostream &) const;
       bool calcCrc();
 
+      // empties the section for reuse
+      void reset();
+      // copies another section's data (must fit)
+      bool assign(const Section &);
+      // copies a built section's bytes (must fit), taking the crc from
+      // its last 4 bytes if with_crc is set
+      bool assign(const ui8 *data, ui16 len, bool with_crc);
+
+      // overwrites len bytes at idx, adjusting the stored crc (if
+      // one was added) from the changed bytes only
+      bool patch(ui16 idx, const ui8 *data, ui16 len);
+      // as above, for only the bits of mask in the byte at idx
+      bool patchBits(ui16 idx, ui8 data, ui8 mask);
+      // long form sections: sets version_number in place
+      bool setVersionNumber(ui8 v);
+
 #ifdef ENABLE_DUMP
       void dump(std::ostream &) const;
 #endif
+
+   protected:
+      // uses the given buffer of section_size bytes
+      Section(ui8 *buffer, ui16 section_size);
+   };
+
+   /*!
+    * \brief Section with its N bytes of storage held inline.
+    *
+    * Lives on the stack or inside the owning object so the small, high
+    * rate tables (TDT, TOT, RST, small PATs) can be built with
+    * STable::buildSection() and packetized without heap allocations.
+    */
+   template <ui16 N>
+   class InlineSection : public Section
+   {
+   public:
+      InlineSection() : Section(buffer, N) {}
+
+   private:
+      ui8 buffer[N];
    };
 
    /*!
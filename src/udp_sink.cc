@@ -0,0 +1,226 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// udp_sink.cc: batched udp / rtp transport stream output
+// -----------------------------------
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include "udp_sink.h"
+
+namespace sigen
+{
+   namespace udp_sink_priv {
+      enum {
+         DATAGRAM_LEN = UdpSink::PACKETS_PER_DATAGRAM * PacketSink::PACKET_SIZE,
+         STRIDE = UdpSink::RTP_HEADER_LEN + DATAGRAM_LEN,
+         RTP_CLOCK = 90000,   // Hz
+         PACING_US = 1000     // output per batch when paced
+      };
+
+      // how far a paced sink may fall behind before it stops catching up
+      const std::chrono::milliseconds MAX_LAG(20);
+   }
+
+   using namespace udp_sink_priv;
+
+   UdpSink::UdpSink(const std::string &host, ui16 port, bool with_rtp) :
+      fd(-1), family(AF_UNSPEC),
+      rtp(with_rtp), header_len(with_rtp ? RTP_HEADER_LEN : 0),
+      seq(0), ssrc(0),
+      bitrate(0), batch(MAX_BATCH),
+      start(Clock::now()),
+      data(MAX_BATCH * STRIDE), lens(MAX_BATCH, header_len),
+      count(0), sent(0), dropped(0), calls(0)
+   {
+      addrinfo hints, *res = nullptr;
+      memset(&hints, 0, sizeof(hints));
+      hints.ai_socktype = SOCK_DGRAM;
+
+      int err = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res);
+      if (err) {
+         std::cerr << "UdpSink::UdpSink(): can't resolve " << host << ": "
+                   << gai_strerror(err) << ".. sends disabled" << std::endl;
+         return;
+      }
+
+      for (addrinfo *ai = res; ai; ai = ai->ai_next) {
+         fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+         if (fd < 0)
+            continue;
+         if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            family = ai->ai_family;
+            break;
+         }
+         close(fd);
+         fd = -1;
+      }
+      freeaddrinfo(res);
+
+      if (fd < 0)
+         std::cerr << "UdpSink::UdpSink(): can't connect to " << host << ": "
+                   << strerror(errno) << ".. sends disabled" << std::endl;
+   }
+
+   UdpSink::~UdpSink()
+   {
+      if (fd >= 0) {
+         flush();
+         close(fd);
+      }
+   }
+
+
+   //
+   // batches hold about PACING_US of output
+   //
+   void UdpSink::setBitrate(ui32 bps)
+   {
+      bitrate = bps;
+      batch = MAX_BATCH;
+      if (bps) {
+         const uint64_t bytes = static_cast<uint64_t>(bps) / 8 * PACING_US / 1000000;
+         batch = std::min<size_t>(MAX_BATCH, std::max<uint64_t>(1, bytes / DATAGRAM_LEN));
+      }
+      next = Clock::now();
+
+      if (count >= batch)
+         send(count);
+   }
+
+   bool UdpSink::setTtl(int ttl)
+   {
+      if (family == AF_INET6)
+         return setsockopt(fd, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &ttl, sizeof(ttl)) == 0;
+
+      const unsigned char t = ttl;
+      return setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &t, sizeof(t)) == 0;
+   }
+
+
+   //
+   // packs the packets into the datagrams, sending a batch when full
+   //
+   void UdpSink::write(const ui8 *packets, size_t n)
+   {
+      if (fd < 0)
+         return;
+
+      for (; n > 0; n--, packets += PACKET_SIZE) {
+         memcpy(datagram(count) + lens[count], packets, PACKET_SIZE);
+         lens[count] += PACKET_SIZE;
+
+         if (lens[count] == header_len + DATAGRAM_LEN && ++count == batch)
+            send(count);
+      }
+   }
+
+   void UdpSink::flush()
+   {
+      if (fd < 0)
+         return;
+
+      if (lens[count] > header_len)
+         count++;
+      if (count > 0)
+         send(count);
+   }
+
+
+   //
+   // sends the first n datagrams, waiting for their time if paced
+   //
+   void UdpSink::send(size_t n)
+   {
+      Clock::time_point at = Clock::now();
+      if (bitrate) {
+         if (next > at)
+            std::this_thread::sleep_for(next - at);
+         else if (at - next > MAX_LAG)
+            next = at;
+         at = next;
+
+         size_t bytes = 0;
+         for (size_t i = 0; i < n; i++)
+            bytes += lens[i] - header_len;
+         next += std::chrono::nanoseconds(bytes * UINT64_C(8000000000) / bitrate);
+      }
+
+      mmsghdr msgs[MAX_BATCH];
+      iovec iov[MAX_BATCH];
+      memset(msgs, 0, sizeof(msgs));
+
+      const ui32 ts = std::chrono::duration_cast<std::chrono::microseconds>(at - start).count() *
+         RTP_CLOCK / 1000000;
+      for (size_t i = 0; i < n; i++) {
+         ui8 *d = datagram(i);
+         if (rtp) {
+            d[0] = 0x80;           // version 2
+            d[1] = RTP_MP2T_PT;
+            d[2] = seq >> 8;
+            d[3] = seq & 0xff;
+            d[4] = ts >> 24;
+            d[5] = ts >> 16;
+            d[6] = ts >> 8;
+            d[7] = ts;
+            d[8] = ssrc >> 24;
+            d[9] = ssrc >> 16;
+            d[10] = ssrc >> 8;
+            d[11] = ssrc;
+            seq++;
+         }
+         iov[i].iov_base = d;
+         iov[i].iov_len = lens[i];
+         msgs[i].msg_hdr.msg_iov = &iov[i];
+         msgs[i].msg_hdr.msg_iovlen = 1;
+      }
+
+      for (size_t done = 0; done < n; ) {
+         int r = sendmmsg(fd, msgs + done, n - done, 0);
+         calls++;
+         if (r < 0) {
+            if (errno == EINTR)
+               continue;
+            // a refused (or, unpaced, overrun) datagram is lost - carry on
+            dropped++;
+            done++;
+            continue;
+         }
+         sent += r;
+         done += r;
+      }
+
+      // a partly filled datagram (after a smaller batch was set) moves up
+      size_t partial = header_len;
+      if (n < MAX_BATCH && lens[n] > header_len) {
+         partial = lens[n];
+         memmove(datagram(0) + header_len, datagram(n) + header_len, partial - header_len);
+      }
+      std::fill(lens.begin(), lens.begin() + std::min<size_t>(n + 1, MAX_BATCH), header_len);
+      lens[0] = partial;
+      count = 0;
+   }
+
+} // sigen namespace
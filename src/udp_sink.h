@@ -0,0 +1,114 @@
+// Copyright 1999-2019 Ed Porras
+//
+// Permission is hereby granted, free of charge, to any person
+// obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies
+// of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+// BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+// ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// udp_sink.h: batched udp / rtp transport stream output
+// -----------------------------------
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include "sink.h"
+
+namespace sigen {
+
+   /*!
+    * \brief PacketSink sending 7 TS packets per UDP datagram, optionally
+    * with an RTP header (RFC 2250, payload type 33).
+    *
+    * Datagrams are sent in batches with one sendmmsg() call. With a
+    * bitrate set, sending is paced: each batch is held until its
+    * scheduled time and batches are kept to about a millisecond of
+    * output, so the downstream receiver sees a steady rate rather than
+    * bursts. The last, possibly short, datagram is only sent by flush().
+    */
+   class UdpSink : public PacketSink
+   {
+   public:
+      enum {
+         PACKETS_PER_DATAGRAM = 7,
+         RTP_HEADER_LEN = 12,
+         RTP_MP2T_PT = 33,           //!< RTP payload type for MPEG-2 TS.
+         MAX_BATCH = 32              //!< Datagrams per sendmmsg() at most.
+      };
+
+      /*!
+       * \brief Constructor - resolves the destination and connects the socket.
+       * \param host Destination address or host name (IPv4 or IPv6,
+       * unicast or multicast).
+       * \param port Destination port.
+       * \param rtp Prefix each datagram with an RTP header.
+       */
+      UdpSink(const std::string &host, ui16 port, bool rtp = false);
+      ~UdpSink();
+
+      // prohibit
+      UdpSink(const UdpSink &) = delete;
+      UdpSink &operator=(const UdpSink &) = delete;
+
+      //! \brief Pace the output to a bitrate (TS bits per second), 0 to not pace.
+      void setBitrate(ui32 bps);
+      //! \brief RTP synchronization source identifier.
+      void setSsrc(ui32 id) { ssrc = id; }
+      //! \brief Multicast time to live.
+      bool setTtl(int ttl);
+
+      void write(const ui8 *packets, size_t count);
+      //! \brief Send everything, including a short last datagram.
+      void flush();
+
+      //! \brief `false` if the socket couldn't be set up.
+      bool good() const { return fd >= 0; }
+      //! \brief Datagrams sent.
+      uint64_t datagramsSent() const { return sent; }
+      //! \brief Datagrams the socket refused (e.g., no receiver on unicast).
+      uint64_t datagramsDropped() const { return dropped; }
+      //! \brief sendmmsg() calls made.
+      uint64_t sendCalls() const { return calls; }
+
+   private:
+      typedef std::chrono::steady_clock Clock;
+
+      int fd;
+      int family;
+      bool rtp;
+      size_t header_len;
+      ui16 seq;
+      ui32 ssrc;
+
+      ui32 bitrate;
+      size_t batch;             // datagrams per sendmmsg()
+      Clock::time_point next;   // when the next batch is due, if paced
+      Clock::time_point start;  // of the RTP timestamps
+
+      std::vector<ui8> data;    // MAX_BATCH datagrams
+      std::vector<size_t> lens; // bytes in each datagram
+      size_t count;             // full datagrams queued
+      uint64_t sent, dropped, calls;
+
+      ui8 *datagram(size_t i) {
+         return &data[i * (RTP_HEADER_LEN + PACKETS_PER_DATAGRAM * PACKET_SIZE)];
+      }
+      void send(size_t n);
+   };
+
+} // sigen namespace
@@ -22,10 +22,15 @@
 
 #pragma once
 
+#include <chrono>
+#include <ctime>
+#include <iosfwd>
 #include "types.h"
 
 namespace sigen {
 
+   class Clock;
+
    //
    // BCD time class
    class BCDTime
@@ -37,17 +42,27 @@ namespace sigen {
       //
       // constructors
       // pass values in HEX!!
-      BCDTime(ui8 h = 0, ui8 m = 0, ui8 s = 0) : hour(h), min(m), sec(s) { }
+      constexpr BCDTime(ui8 h = 0, ui8 m = 0, ui8 s = 0) : hour(h), min(m), sec(s) { }
       // pass a bcd time array
-      BCDTime(ui8 *bta);
+      constexpr BCDTime(const ui8 *bta) :
+         hour(fromBCD(bta[HOUR_IDX])),
+         min(fromBCD(bta[MINUTES_IDX])),
+         sec(fromBCD(bta[SECONDS_IDX])) { }
 
       // accessors
-      ui8 getHour() const { return hour; }
-      ui8 getMinute() const { return min; }
-      ui8 getSecond() const { return sec; }
-      ui8 getBCDHour() const;
-      ui8 getBCDMinute() const;
-      ui8 getBCDSecond() const;
+      constexpr ui8 getHour() const { return hour; }
+      constexpr ui8 getMinute() const { return min; }
+      constexpr ui8 getSecond() const { return sec; }
+      constexpr ui8 getBCDHour() const { return toBCD(hour); }
+      constexpr ui8 getBCDMinute() const { return toBCD(min); }
+      constexpr ui8 getBCDSecond() const { return toBCD(sec); }
+      // writes the TIME_LEN bcd bytes
+      void getBCD(ui8 *bta) const {
+         bta[HOUR_IDX] = getBCDHour();
+         bta[MINUTES_IDX] = getBCDMinute();
+         bta[SECONDS_IDX] = getBCDSecond();
+      }
+      constexpr ui32 seconds() const { return hour * 3600 + min * 60 + sec; }
 
       // utility
       void set(ui8 h, ui8 m, ui8 s) { hour = h; min = m; sec = s; }
@@ -58,6 +73,10 @@ namespace sigen {
       // comparison op
       int operator==(const BCDTime &bcdt) const;
 
+      // 2-digit value <-> bcd conversions (no range checking)
+      static constexpr ui8 toBCD(ui8 v) { return v + 6 * (v / 10); }
+      static constexpr ui8 fromBCD(ui8 b) { return b - 6 * (b >> 4); }
+
       // dump to an ostream
       friend std::ostream &operator<<(std::ostream& o, const BCDTime& t) {
          return t.dump(o);
@@ -79,25 +98,66 @@ namespace sigen {
    class UTC
    {
    public:
+      // size of the packed mjd + bcd time field in tables
+      enum { BYTE_LEN = 2 + BCDTime::TIME_LEN };
+
       // public data holders - for simplicity
       ui16 mjd;
       BCDTime time;
 
-      // default constructor builds a UTC object with current time
+      // default constructor builds a UTC object with the current time
+      // of Clock::current()
       UTC();
+      // current time of a clock
+      explicit UTC(const Clock &clock);
       // these constructors must take h, m, s in HEX!!.. don't
       // pass BCD to construct
       UTC(ui16 mjd, ui8 h, ui8 m = 0, ui8 s = 0);
       UTC(ui16 M, ui16 D, ui16 Y, ui8 h, ui8 m = 0, ui8 s = 0);
       // this constructor DOES take mjd + bcd[3] (hr = 0, min = 1, sec = 2)
       UTC(ui16 mjd, ui8 bcd_time[BCDTime::TIME_LEN]);
+      // from seconds since the epoch (1970-01-01 00:00:00 UTC)
+      explicit UTC(time_t t);
+      // from a system_clock time point (e.g., std::chrono::sys_seconds)
+      explicit UTC(std::chrono::system_clock::time_point tp) :
+         UTC(std::chrono::system_clock::to_time_t(tp)) { }
 
       // accessors
       void getMDY(ui16 &M, ui16 &D, ui16 &Y) const;
+      // seconds since the epoch
+      time_t toTimeT() const {
+         return static_cast<time_t>(mjd - MJD_EPOCH) * 86400 + time.seconds();
+      }
+      // writes the BYTE_LEN bytes as sent in tables
+      void getBytes(ui8 *b) const {
+         b[0] = mjd >> 8;
+         b[1] = mjd & 0xff;
+         time.getBCD(b + 2);
+      }
 
       // comparison op
       int operator==(const UTC &) const;
 
+      //
+      // integer date <-> mjd conversions, valid from 1900-03-01 on.
+      // Y can be the full year or years since 1900
+      static constexpr ui16 dateToMJD(ui16 M, ui16 D, ui16 Y) {
+         ui32 y = ((Y < 1900) ? Y + 1900 : Y) - (M <= 2);
+         ui32 doy = (153 * (M > 2 ? M - 3 : M + 9) + 2) / 5 + D - 1;
+         ui32 doe = (y % 400) * 365 + (y % 400) / 4 - (y % 400) / 100 + doy;
+         return (y / 400) * 146097 + doe - DAYS_TO_MJD;
+      }
+      static constexpr void MJDToDate(ui16 mjd, ui16 &M, ui16 &D, ui16 &Y) {
+         ui32 z = mjd + DAYS_TO_MJD;
+         ui32 era = z / 146097, doe = z % 146097;
+         ui32 yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+         ui32 doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+         ui32 mp = (5 * doy + 2) / 153;
+         D = doy - (153 * mp + 2) / 5 + 1;
+         M = (mp < 10) ? mp + 3 : mp - 9;
+         Y = yoe + era * 400 + (M <= 2);
+      }
+
       // overloaded << op
       friend std::ostream &operator<<(std::ostream &o, const UTC &t) {
          return t.dump(o);
@@ -105,6 +165,12 @@ namespace sigen {
 
    protected:
       std::ostream& dump(std::ostream& o) const;
+
+   private:
+      enum {
+         MJD_EPOCH = 40587,      // 1970-01-01
+         DAYS_TO_MJD = 678881    // days from 0000-03-01 to MJD 0
+      };
    };
 
 } // sigen namespace
@@ -0,0 +1,101 @@
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../src/sigen.h"
+#include "dvb_builder.h"
+
+using namespace sigen;
+
+namespace tests
+{
+   namespace {
+      // writes the sections, then enough packets to cycle through all the
+      // buffers a few times, returning what should be in the file
+      std::vector<ui8> writeAll(AsyncFileSink& sink, const TStream& t)
+      {
+         std::vector<ui8> expected;
+         for (const Section* s : t.section_list)
+            expected.insert(expected.end(), s->getBinaryData(), s->getBinaryData() + s->length());
+         sink.write(t);
+
+         MpgPacketizer mem(0), out(0);
+         for (int rep = 0; rep < 1000; rep++) {
+            for (const Section* s : t.section_list) {
+               mem.packetize(*s, NIT::PID, expected);
+               out.packetize(*s, NIT::PID, sink);
+            }
+         }
+         return expected;
+      }
+
+      int checkFile(const TStream& t, AsyncFileSink::Backend backend)
+      {
+         const char* file_name = "async_sink.ts";
+         std::vector<ui8> expected;
+         {
+            AsyncFileSink sink(file_name, backend);
+            if (!sink.good() || (backend == AsyncFileSink::THREAD_BACKEND && sink.usingUring()))
+               return 1;
+
+            expected = writeAll(sink, t);
+            sink.flush();
+            if (sink.bytesWritten() != static_cast<off_t>(expected.size()) || !sink.close())
+               return 1;
+         }
+
+         std::vector<ui8> data = read_file(file_name);
+         std::remove(file_name);
+         return data == expected ? 0 : 1;
+      }
+
+      int checkFifo(const TStream& t, AsyncFileSink::Backend backend)
+      {
+         const char* fifo_name = "async_sink.fifo";
+         if (mkfifo(fifo_name, 0600) != 0)
+            return 1;
+
+         // reads until the writer closes
+         std::vector<ui8> data;
+         std::thread reader([&] {
+               int fd = open(fifo_name, O_RDONLY);
+               ui8 buf[4096];
+               ssize_t n;
+               while ((n = read(fd, buf, sizeof(buf))) > 0)
+                  data.insert(data.end(), buf, buf + n);
+               close(fd);
+            });
+
+         std::vector<ui8> expected;
+         bool ok;
+         {
+            AsyncFileSink sink(fifo_name, backend);
+            expected = writeAll(sink, t);
+            ok = sink.close();
+         }
+         reader.join();
+         std::remove(fifo_name);
+         return ok && data == expected ? 0 : 1;
+      }
+   }
+
+   int async_sink(TStream& t)
+   {
+      build_sink_nit(t, "async sink network");
+
+      for (AsyncFileSink::Backend backend : { AsyncFileSink::AUTO_BACKEND,
+                                              AsyncFileSink::THREAD_BACKEND }) {
+         if (checkFile(t, backend) || checkFifo(t, backend))
+            return 1;
+      }
+
+      // the sink is disabled if the file can't be created
+      AsyncFileSink bad("missing/dir/async_sink.ts");
+      bad.write(t);
+      if (bad.good() || bad.bytesWritten() != 0)
+         return 1;
+      return 0;
+   }
+}
@@ -1,3 +1,5 @@
+#include <cstring>
+#include <vector>
 #include "../src/sigen.h"
 #include "dvb_builder.h"
 
@@ -5,8 +7,56 @@ using namespace sigen;
 
 namespace tests
 {
+   namespace {
+      // transport streams added with addXportStreams() build the same as
+      // adding them and their descriptors one by one
+      int checkBulk()
+      {
+         enum { STREAMS = 50 };
+         BAT single(0x1000, 0x10), bulk(0x1000, 0x10);
+         single.setMaxSectionLen( 300 );
+         bulk.setMaxSectionLen( 300 );
+
+         std::vector<std::vector<ui8> > loops(STREAMS);
+         std::vector<NIT_BAT::XportStreamInfo> info;
+         for (ui16 xs = 0; xs < STREAMS; xs++) {
+            ServiceListDesc sld;
+            sld.addService(0x100 + xs, Dvb::DIGITAL_TV_ST);
+            sld.addService(0x200 + xs, Dvb::DIGITAL_RADIO_ST);
+            append_desc(loops[xs], sld);
+
+            ServiceListDesc* d = new ServiceListDesc;
+            d->addService(0x100 + xs, Dvb::DIGITAL_TV_ST);
+            d->addService(0x200 + xs, Dvb::DIGITAL_RADIO_ST);
+            single.addXportStream(xs, 0x30);
+            single.addXportStreamDesc(xs, *d);
+
+            info.push_back({ xs, 0x30, loops[xs].data(), ui16(loops[xs].size()) });
+         }
+
+         if (!bulk.addXportStreams(info.data(), info.size()))
+            return 1;
+
+         TStream ts, tb;
+         single.buildSections(ts);
+         bulk.buildSections(tb);
+
+         auto b = tb.section_list.begin();
+         for (const Section* s : ts.section_list) {
+            if (b == tb.section_list.end() || s->length() != (*b)->length() ||
+                memcmp(s->getBinaryData(), (*b)->getBinaryData(), s->length()))
+               return 1;
+            ++b;
+         }
+         return b == tb.section_list.end() ? 0 : 1;
+      }
+   }
+
    int bat(TStream& t)
    {
+      if (checkBulk())
+         return 1;
+
       BAT bat(0x1000, 0x10);
 
       bat.setMaxSectionLen( 300 ); // to test sectionizing
@@ -51,6 +101,9 @@ namespace tests
       bat.addXportStreamDesc(99, *sld2 );
 
       DUMP(bat);
+      if (tests::cmp_gen(bat))
+         return 1;
+
       bat.buildSections(t);
 
       // dump built sections
@@ -16,6 +16,12 @@ namespace tests
       DUMP(cat);
       cat.buildSections(t);
 
+      // the same table built at compile time
+      static constexpr auto static_cat =
+         StaticSI::cat(0x14, true, StaticSI::caDesc(0x4653, 0x1234, "this is a test"));
+      if (tests::cmp_static(t, static_cat.getBinaryData(), static_cat.length()))
+         return 1;
+
       // dump built sections
       DUMP(t);
 
@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include "../src/sigen.h"
+#include "dvb_builder.h"
+
+using namespace sigen;
+
+namespace tests
+{
+   namespace {
+      // restores the system clock
+      struct CurrentClock {
+         explicit CurrentClock(Clock& c) { Clock::setCurrent(&c); }
+         ~CurrentClock() { Clock::setCurrent(nullptr); }
+      };
+   }
+
+   //
+   // a day of carousel changes on a simulated clock
+   //
+   int clock(TStream&)
+   {
+      const time_t start = UTC(1, 1, 2018, 0, 0, 0).toTimeT();
+      const time_t day = 24 * 3600;
+
+      SimulatedClock sim(start);
+      {
+         CurrentClock cur(sim);
+
+         // the default constructors read the current clock
+         TDT tdt;
+         if (tdt.getUTC().toTimeT() != start)
+            return 1;
+
+         LiveTimeTable live(tdt);
+         Multiplex mux(0x10, 0x20, 0x30);
+         mux.addService(1, 0x100, 0x101, Dvb::DIGITAL_TV_ST, "provider", "service");
+         mux.rebuild(1);
+
+         Scheduler sched(sim);
+         size_t ticks = 0, changes = 0;
+         ui16 event_id = 0;
+
+         // TDT every 30s, a new present event every half hour and a
+         // rename at noon
+         sched.every(30, [&](const UTC& now) {
+               live.setUTC(now);
+               live.nextPackets();
+               ticks++;
+            });
+         sched.every(1800, [&](const UTC& now) {
+               Multiplex::Event present = { event_id, now, BCDTime(0, 30), Dvb::RUNNING_RS,
+                                            false, "eng", "event", "" };
+               Multiplex::Event following = present;
+               following.id = ++event_id;
+               following.start_time = UTC(now.toTimeT() + 1800);
+               following.running_status = Dvb::NOT_RUNNING_RS;
+               mux.setPresentFollowing(1, &present, &following);
+               mux.rebuild(1);
+               changes++;
+            });
+         sched.at(start + day / 2, [&](const UTC& now) {
+               if (UTC().toTimeT() != now.toTimeT())
+                  return;
+               mux.setServiceName(1, "provider", "renamed");
+               mux.rebuild(1);
+            });
+
+         auto t0 = std::chrono::steady_clock::now();
+         const size_t run = sched.runUntil(start + day);
+         const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+         // both ends of the day, nothing slept
+         if (run != 2881 + 49 + 1 || ticks != 2881 || changes != 49 || sched.pending() != 2 ||
+             sim.now() != start + day || secs > 10)
+            return 1;
+
+         ui8 utc[UTC::BYTE_LEN];
+         UTC(1, 2, 2018, 0, 0, 0).getBytes(utc);
+         if (memcmp(live.getSection().getBinaryData() + 3, utc, sizeof(utc)))
+            return 1;
+
+         // 49 EIT versions, the SDT once for the p/f flag and once for the rename
+         if (mux.getTable(Multiplex::PF_EIT_ST, 1)->acquire().getVersionNumber() != 48 % 32 ||
+             mux.getTable(Multiplex::SDT_ST, 0)->acquire().getVersionNumber() != 2)
+            return 1;
+
+         // one-off tasks adding the next one, in the finished ones' slots
+         size_t chained = 0;
+         Scheduler::Task chain = [&](const UTC& now) {
+               if (++chained < 100)
+                  sched.at(now.toTimeT() + 60, chain);
+            };
+         sched.at(sim.now() + 60, chain);
+         sched.runUntil(sim.now() + 100 * 60);
+         if (chained != 100 || sched.pending() != 2)
+            return 1;
+      }
+
+      // back on the system clock
+      const time_t now = ::time(nullptr);
+      if (UTC().toTimeT() < now || UTC().toTimeT() > now + 2)
+         return 1;
+      return 0;
+   }
+}
@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 #include <cstring>
 #include <algorithm>
@@ -59,13 +60,86 @@ namespace tests
       delete [] blob;
       return cmp;
    }
+
+   //
+   // checks the table's section generator yields what buildSections() does
+   int cmp_gen(const STable& table)
+   {
+      TStream ts;
+      table.buildSections(ts);
+
+      Section s(table.getMaxSectionLen());
+      SectionGenerator gen = table.sections();
+      gen.prepare(); // next() finishes a partial sizing pass
+
+      for (const Section* built : ts.section_list) {
+         if (!gen.next(s) || s.length() != built->length() ||
+             std::memcmp(s.getBinaryData(), built->getBinaryData(), s.length()))
+            return 1;
+      }
+      if (gen.next(s))
+         return 1;
+
+      // single section build, when the table allows it
+      InlineSection<4096> one;
+      if (table.buildSection(one)) {
+         const Section* built = ts.section_list.front();
+         if (ts.getNumSections() != 1 || one.length() != built->length() ||
+             std::memcmp(one.getBinaryData(), built->getBinaryData(), one.length()))
+            return 1;
+      }
+      return 0;
+   }
+
+   //
+   // checks a single section stream against compile time built bytes
+   int cmp_static(const TStream& ts, const ui8* data, ui16 len)
+   {
+      const Section* built = ts.section_list.front();
+      return (ts.getNumSections() != 1 || built->length() != len ||
+              std::memcmp(built->getBinaryData(), data, len)) ? 1 : 0;
+   }
+
+   //
+   // serializes a descriptor onto a descriptor loop, for the bulk loaders
+   void append_desc(std::vector<ui8>& loop, const Descriptor& d)
+   {
+      Section s(d.length());
+      d.buildSections(s);
+      loop.insert(loop.end(), s.getBinaryData(), s.getBinaryData() + s.length());
+   }
+
+   //
+   // multi-section NIT the sink tests write out: 300 byte sections so
+   // some packets are short
+   void build_sink_nit(TStream& t, const std::string& network_name)
+   {
+      NITActual nit(0x10, 1);
+      nit.setMaxSectionLen( 300 );
+      nit.addDesc( *new NetworkNameDesc(network_name) );
+      for (ui16 xs = 0; xs < 20; xs++) {
+         nit.addXportStream( xs, 0x20 );
+         ServiceListDesc* sld = new ServiceListDesc;
+         sld->addService( 0x100 + xs, Dvb::DIGITAL_TV_ST );
+         nit.addXportStreamDesc( xs, *sld );
+      }
+      nit.buildSections(t);
+   }
+
+   //
+   // a whole file's contents, empty if it can't be read
+   std::vector<ui8> read_file(const std::string& file_name)
+   {
+      std::ifstream f(file_name, std::ios::binary);
+      return std::vector<ui8>(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+   }
 }
 
 
 void usage(const std::string& prog)
 {
    std::cerr << prog << " linked against sigen library v" << sigen::version() << std::endl
-             << "Usage: " << prog << " [-bat|-cat|-eit|-nit|-pat|-pmt|-sdt|-tdt|-tot]"
+             << "Usage: " << prog << " [-bat|-cat|-eit|-nit|-pat|-pmt|-sdt|-tdt|-tot|-rst|-st|-ext_event|-text|-pipeline|-published|-multiplex|-file_sink|-async_sink|-udp_sink|-paced_sink|-clock]"
              << std::endl;
 }
 
@@ -94,7 +168,17 @@ int main(int argc, char* argv[])
       { "-tdt", tests::tdt },
       { "-tot", tests::tot },
       { "-rst", tests::rst },
-      { "-st", tests::st }
+      { "-st", tests::st },
+      { "-ext_event", tests::ext_event },
+      { "-text", tests::text },
+      { "-pipeline", tests::pipeline },
+      { "-published", tests::published },
+      { "-multiplex", tests::multiplex },
+      { "-file_sink", tests::file_sink },
+      { "-async_sink", tests::async_sink },
+      { "-udp_sink", tests::udp_sink },
+      { "-paced_sink", tests::paced_sink },
+      { "-clock", tests::clock }
    };
 
    // search for the given argument
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include "../src/sigen.h"
 
 namespace tests {
@@ -15,7 +16,22 @@ namespace tests {
    int tdt(sigen::TStream& t);
    int rst(sigen::TStream& t);
    int st(sigen::TStream& t);
+   int ext_event(sigen::TStream& t);
+   int text(sigen::TStream& t);
+   int pipeline(sigen::TStream& t);
+   int published(sigen::TStream& t);
+   int multiplex(sigen::TStream& t);
+   int file_sink(sigen::TStream& t);
+   int async_sink(sigen::TStream& t);
+   int udp_sink(sigen::TStream& t);
+   int paced_sink(sigen::TStream& t);
+   int clock(sigen::TStream& t);
 
    int cmp_bin(const sigen::TStream& ts, const std::string& filename);
+   int cmp_gen(const sigen::STable& table);
+   int cmp_static(const sigen::TStream& ts, const ui8* data, ui16 len);
+   void append_desc(std::vector<ui8>& loop, const sigen::Descriptor& d);
    bool write_bin(const sigen::TStream& ts, const std::string& basename);
+   void build_sink_nit(sigen::TStream& t, const std::string& network_name);
+   std::vector<ui8> read_file(const std::string& file_name);
 }
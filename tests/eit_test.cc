@@ -1,3 +1,7 @@
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
 #include "../src/sigen.h"
 #include "dvb_builder.h"
 
@@ -5,8 +9,202 @@ using namespace sigen;
 
 namespace tests
 {
+   namespace {
+      void buildOther(TStream& t, ui8 ver, ui8 running_status)
+      {
+         PF_EITOther eit(101, 0x444, 0x555, ver);
+         eit.addPresentEvent(0x2000, UTC(3, 1, 1999, 9, 0, 0), BCDTime(0, 30, 0), 1, 1);
+         eit.addFollowingEvent(0x2001, UTC(3, 1, 1999, 9, 30, 0), BCDTime(0, 30, 0), running_status, 1);
+         eit.addFollowingEventDesc( *new ShortEventDesc("eng", "Next", "Up next.") );
+         eit.buildSections(t);
+      }
+
+      // version bumps / status flips patched into built sections must
+      // match sections built with the new values
+      int checkPatch()
+      {
+         TStream patched, fresh;
+         buildOther(patched, 0, 1);
+         buildOther(fresh, 7, 4);
+
+         auto p = patched.section_list.begin();
+         for (const Section* f : fresh.section_list) {
+            Section& s = **p++;
+            s.setVersionNumber(7);
+            EIT::setRunningStatus(s, 0x2001, 4);
+
+            if (s.length() != f->length() || s.getCRC() != f->getCRC() ||
+                memcmp(s.getBinaryData(), f->getBinaryData(), s.length()))
+               return 1;
+         }
+         return EIT::setRunningStatus(*patched.section_list.front(), 0x2002, 4) ? 1 : 0;
+      }
+
+      // text passed as views into a larger buffer (not NUL terminated)
+      // is cut to the room left in the descriptor, copying only the
+      // viewed bytes
+      int checkTextViews()
+      {
+         const std::string buf = "Fight Club" + std::string(300, 'z') + "end";
+         const StrView name(buf.data(), 10), text(buf.data() + 10, 300);
+
+         std::vector<ui8> sed, eed;
+         append_desc(sed, ShortEventDesc("eng", name, text));
+         append_desc(eed, ExtendedEventDesc("eng", text, 0));
+
+         // the name and 5 other bytes leave room for 240 bytes of text
+         const std::string sed_exp = std::string("\x4d\xff" "eng" "\x0a" "Fight Club" "\xf0") +
+            std::string(240, 'z');
+         // 6 bytes before the text leave 249
+         const std::string eed_exp = std::string("\x4e\xff\x00" "eng" "\x00\xf9", 8) +
+            std::string(249, 'z');
+
+         return (std::string(sed.begin(), sed.end()) == sed_exp &&
+                 std::string(eed.begin(), eed.end()) == eed_exp) ? 0 : 1;
+      }
+
+      // mpeg-2 crc over a section including its crc is 0
+      bool crcOK(const Section& s)
+      {
+         ui32 crc = 0xffffffff;
+         for (ui16 i = 0; i < s.length(); i++) {
+            crc ^= static_cast<ui32>(s.getBinaryData()[i]) << 24;
+            for (int b = 0; b < 8; b++)
+               crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04c11db7 : crc << 1;
+         }
+         return crc == 0;
+      }
+
+      // schedule built from an event store: segments, section numbering
+      // and the events' bytes
+      int checkSchedule()
+      {
+         const ui16 day = UTC(3, 1, 1999, 0, 0, 0).mjd;
+         const ShortEventDesc sed("eng", "Scheduled", std::string(60, 'x'));
+         enum { BUSY_EVENTS = 40, EVENTS = 3 + BUSY_EVENTS + 1 };
+
+         EventStore store;
+         if (store.addEventDesc(sed))
+            return 1;
+
+         store.reserve(EVENTS, EVENTS * sed.length());
+         store.addEvent(0x10, UTC(day, 9, 0), BCDTime(0, 30), Dvb::RUNNING_RS, false);
+         store.addEventDesc(sed);
+         store.addEvent(0x11, UTC(day, 9, 30), BCDTime(1, 0), Dvb::NOT_RUNNING_RS, true);
+         store.addEvent(0x12, UTC(day, 13, 0), BCDTime(2, 0), Dvb::NOT_RUNNING_RS, false);
+         store.addEventDesc(sed);
+         // day 2, 09:00 - 11:00: several sections in one segment
+         for (ui16 i = 0; i < BUSY_EVENTS; i++) {
+            store.addEvent(0x100 + i, UTC(day + 1, 9 + i / 20, (i % 20) * 3), BCDTime(0, 3), Dvb::NOT_RUNNING_RS, false);
+            store.addEventDesc(sed);
+         }
+         // day 6: segment 8 of the second table_id
+         store.addEvent(0x200, UTC(day + 5, 1, 0), BCDTime(1, 0), Dvb::NOT_RUNNING_RS, false);
+
+         if (store.addEvent(0x300, UTC(day, 0, 0), BCDTime(1, 0), 1, false) ||
+             store.size() != EVENTS ||
+             store.memoryUsage() != static_cast<size_t>(EVENTS * EventStore::EVENT_BYTES + EVENTS * sed.length()))
+            return 1;
+
+         ES_EITActual es(store, 100, 0x333, 0x444, day, 3);
+         es.setMaxSectionLen( 1024 );
+         if (tests::cmp_gen(es))
+            return 1;
+
+         TStream ts;
+         es.buildSections(ts);
+
+         // the same events bulk loaded
+         std::vector<ui8> sed_loop;
+         append_desc(sed_loop, sed);
+         std::vector<EventStore::EventInfo> info;
+         for (size_t i = 0; i < store.size(); i++) {
+            ui8 bcd[BCDTime::TIME_LEN];
+            memcpy(bcd, store.getStartTime(i) + 2, sizeof(bcd));
+            info.push_back({ store.getId(i), UTC(store.getStartMJD(i), bcd), BCDTime(store.getDuration(i)),
+                             store.getRunningStatus(i), store.getFreeCAMode(i),
+                             sed_loop.data(), ui16(store.getDescLoopLen(i) ? sed_loop.size() : 0) });
+         }
+
+         EventStore bulk;
+         if (!bulk.addEvents(info.data(), 10) || !bulk.addEvents(info.data() + 10, info.size() - 10) ||
+             bulk.addEvents(info.data(), 1)) // out of order
+            return 1;
+
+         TStream bulk_ts;
+         ES_EITActual bulk_es(bulk, 100, 0x333, 0x444, day, 3);
+         bulk_es.setMaxSectionLen( 1024 );
+         bulk_es.buildSections(bulk_ts);
+
+         // expected: table_id, section_number, segment_last_section_number,
+         // last_section_number, number of events
+         const ui8 expected[][5] = {
+            { 0x50,  0,  0, 91,  0 }, { 0x50,  8,  8, 91,  0 }, { 0x50, 16, 16, 91,  0 },
+            { 0x50, 24, 24, 91,  2 }, { 0x50, 32, 32, 91,  1 }, { 0x50, 40, 40, 91,  0 },
+            { 0x50, 48, 48, 91,  0 }, { 0x50, 56, 56, 91,  0 }, { 0x50, 64, 64, 91,  0 },
+            { 0x50, 72, 72, 91,  0 }, { 0x50, 80, 80, 91,  0 }, { 0x50, 88, 91, 91, 11 },
+            { 0x50, 89, 91, 91, 11 }, { 0x50, 90, 91, 91, 11 }, { 0x50, 91, 91, 91,  7 },
+            { 0x51,  0,  0, 64,  0 }, { 0x51,  8,  8, 64,  0 }, { 0x51, 16, 16, 64,  0 },
+            { 0x51, 24, 24, 64,  0 }, { 0x51, 32, 32, 64,  0 }, { 0x51, 40, 40, 64,  0 },
+            { 0x51, 48, 48, 64,  0 }, { 0x51, 56, 56, 64,  0 }, { 0x51, 64, 64, 64,  1 },
+         };
+         if (ts.getNumSections() != sizeof(expected) / sizeof(expected[0]))
+            return 1;
+
+         size_t ev = 0, n = 0;
+         for (const Section* s : ts.section_list) {
+            const ui8* d = s->getBinaryData();
+            const ui8* e = expected[n++];
+
+            if (!crcOK(*s) || d[0] != e[0] || d[6] != e[1] || d[12] != e[2] || d[7] != e[3] ||
+                d[13] != 0x51 || ((d[5] >> 1) & 0x1f) != 3 ||
+                (((d[1] << 8) | d[2]) & 0xfff) != s->length() - 3)
+               return 1;
+
+            // the events, in order
+            ui8 count = 0;
+            for (ui16 i = 14; i < s->length() - Section::CRC_LEN; count++, ev++) {
+               const ui16 len = store.length(ev);
+               if (((d[i] << 8) | d[i + 1]) != store.getId(ev) ||
+                   memcmp(d + i + 12, store.getDescData(ev), len - 12))
+                  return 1;
+               i += len;
+            }
+            if (count != e[4])
+               return 1;
+         }
+         if (ev != EVENTS)
+            return 1;
+
+         auto b = bulk_ts.section_list.begin();
+         for (const Section* s : ts.section_list) {
+            if (b == bulk_ts.section_list.end() || s->length() != (*b)->length() ||
+                memcmp(s->getBinaryData(), (*b)->getBinaryData(), s->length()))
+               return 1;
+            ++b;
+         }
+
+         // the same event bytes as the p/f EIT writes
+         PF_EITActual pf(100, 0x333, 0x444, 0);
+         pf.addPresentEvent(0x10, UTC(day, 9, 0), BCDTime(0, 30), Dvb::RUNNING_RS, false);
+         pf.addPresentEventDesc( *new ShortEventDesc("eng", "Scheduled", std::string(60, 'x')) );
+         TStream pf_ts;
+         pf.buildSections(pf_ts);
+
+         const Section* es_sec = *std::next(ts.section_list.begin(), 3);
+         if (memcmp(pf_ts.section_list.front()->getBinaryData() + 14,
+                    es_sec->getBinaryData() + 14, store.length(0)))
+            return 1;
+
+         return 0;
+      }
+   }
+
    int eit(TStream& t)
    {
+      if (checkPatch() || checkSchedule() || checkTextViews())
+         return 1;
+
       // EIT PF Actual
       PF_EITActual eit_a(100, 0x333, 0x444, 0);
 
@@ -67,6 +265,9 @@ namespace tests
       eit_a.addFollowingEventDesc( *prd );
 
       DUMP(eit_a);
+      if (tests::cmp_gen(eit_a))
+         return 1;
+
       eit_a.buildSections(t);
 
       // EIT PDF Other
@@ -0,0 +1,50 @@
+#include <string>
+#include "../src/sigen.h"
+#include "dvb_builder.h"
+
+using namespace sigen;
+
+namespace tests
+{
+   int ext_event(TStream& t)
+   {
+      PF_EITActual eit(100, 0x333, 0x444, 0);
+
+      // ----------------------------------------
+      // present event: raw UTF-8 text long enough to need several
+      // descriptors, with multi-byte chars around the split points
+      eit.addPresentEvent(0x1000, UTC(3, 1, 1999, 9, 0, 0), BCDTime(1, 45, 0), 1, 0);
+
+      ExtendedEventSplitter splitter("eng", ExtendedEventSplitter::UTF8);
+      splitter.addItem("Director", "David Fincher");
+      splitter.addItem("Cast", "Edward Norton, Brad Pitt, Helena Bonham Carter");
+
+      std::string synopsis;
+      for (int i = 0; i < 12; i++)
+         synopsis += "A ticking-time-bomb insomniac and a slippery soap salesman "
+            "channel primal male aggression into a shocking new form of therapy \xc3\xa0 la carte. ";
+      splitter.setText(synopsis);
+
+      for (auto& eed : splitter.build())
+         eit.addPresentEventDesc(*eed.release());
+
+      // ----------------------------------------
+      // following event: reuse the splitter with DVB-encoded text
+      // (ISO/IEC 8859-5 selector is repeated in each chunk)
+      eit.addFollowingEvent(0x1001, UTC(3, 1, 1999, 10, 45, 0), BCDTime(0, 30, 0), 1, 0);
+
+      splitter.reset(ExtendedEventSplitter::DVB);
+      splitter.setText(std::string("\x10\x00\x05", 3) + std::string(300, '\xb0'));
+
+      for (auto& eed : splitter.build())
+         eit.addFollowingEventDesc(*eed.release());
+
+      DUMP(eit);
+      eit.buildSections(t);
+
+      // dump built sections
+      DUMP(t);
+
+      return tests::cmp_bin(t, "reference/ext_event.ts");
+   }
+}
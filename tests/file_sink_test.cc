@@ -0,0 +1,61 @@
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include "../src/sigen.h"
+#include "dvb_builder.h"
+
+using namespace sigen;
+
+namespace tests
+{
+   int file_sink(TStream& t)
+   {
+      const char* file_name = "file_sink.ts";
+
+      build_sink_nit(t, "file sink network");
+
+      std::vector<ui8> expected;
+      {
+         // a single page window and a small preallocation so packets
+         // straddle windows and the file grows
+         MappedFileSink sink(file_name, 2048, 1);
+         if (!sink.good())
+            return 1;
+
+         MpgPacketizer mem(0), out(0);
+         for (int rep = 0; rep < 50; rep++) {
+            for (const Section* s : t.section_list) {
+               mem.packetize(*s, NIT::PID, expected);
+               out.packetize(*s, NIT::PID, sink);
+            }
+
+            // everything written so far is in the file
+            if (rep == 10) {
+               sink.flush();
+               std::vector<ui8> data = read_file(file_name);
+               if (sink.bytesWritten() != static_cast<off_t>(expected.size()) ||
+                   data.size() < expected.size() ||
+                   !std::equal(expected.begin(), expected.end(), data.begin()))
+                  return 1;
+            }
+         }
+
+         if (sink.bytesWritten() != static_cast<off_t>(expected.size()) || !sink.close())
+            return 1;
+      }
+
+      // trimmed to the packets written
+      if (read_file(file_name) != expected)
+         return 1;
+
+      std::remove(file_name);
+
+      // the sink is disabled if the file can't be created
+      MappedFileSink bad("missing/dir/file_sink.ts");
+      ui8 pkt[PacketSink::PACKET_SIZE] = { MpgPacketizer::SYNC_BYTE };
+      bad.write(pkt, 1);
+      if (bad.good() || bad.bytesWritten() != 0)
+         return 1;
+      return 0;
+   }
+}
@@ -0,0 +1,217 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include "../src/sigen.h"
+#include "dvb_builder.h"
+
+using namespace sigen;
+
+namespace tests
+{
+   namespace {
+      std::vector<ui8> bytes(const TStream& t)
+      {
+         std::vector<ui8> v;
+         for (const Section* s : t.section_list)
+            v.insert(v.end(), s->getBinaryData(), s->getBinaryData() + s->length());
+         return v;
+      }
+
+      // the published sub-table is the same as building table
+      bool same(const Multiplex& mux, Multiplex::SubTable type, ui16 id, const STable& table)
+      {
+         std::shared_ptr<PublishedTable> pt = mux.getTable(type, id);
+         if (!pt)
+            return false;
+
+         TStream t;
+         table.buildSections(t);
+         return bytes(pt->acquire().stream()) == bytes(t);
+      }
+
+      ui8 version(const Multiplex& mux, Multiplex::SubTable type, ui16 id = 0)
+      {
+         return mux.getTable(type, id)->acquire().getVersionNumber();
+      }
+
+      // both multiplexes publish the same sub-tables on the same pids
+      bool sameTables(const Multiplex& a, const Multiplex& b)
+      {
+         std::vector<Multiplex::Entry> ea = a.getTables(), eb = b.getTables();
+         if (ea.size() != eb.size())
+            return false;
+
+         for (size_t i = 0; i < ea.size(); i++) {
+            PublishedTable::Snapshot sa = ea[i].table->acquire(), sb = eb[i].table->acquire();
+            if (ea[i].type != eb[i].type || ea[i].id != eb[i].id || ea[i].pid != eb[i].pid ||
+                bytes(sa.stream()) != bytes(sb.stream()) ||
+                sa.getVersionNumber() != sb.getVersionNumber() ||
+                sa.stream().section_list.back()->getCRC() != sb.stream().section_list.back()->getCRC())
+               return false;
+         }
+         return true;
+      }
+
+      int checkSnapshot(Multiplex& mux)
+      {
+         const char* file_name = "multiplex.snapshot";
+
+         // pending changes (the new EIT and the SDT's p/f flag) are carried over
+         Multiplex::Event ev = { 0x2000, UTC(58000, 12, 0), BCDTime(0, 45), Dvb::RUNNING_RS,
+                                 true, "eng", "news", "" };
+         mux.setPresentFollowing(3, nullptr, &ev);
+         if (!mux.saveSnapshot(file_name) || std::ifstream(std::string(file_name) + ".tmp"))
+            return 1;
+
+         std::unique_ptr<Multiplex> copy = Multiplex::loadSnapshot(file_name);
+         if (!copy || !copy->isDirty() || copy->rebuild() != 2 || mux.rebuild() != 2 ||
+             !sameTables(mux, *copy))
+            return 1;
+
+         // versions continue from the restored sections
+         const ui8 ver = version(*copy, Multiplex::SDT_ST);
+         copy->setServiceName(1, "provider", "restored");
+         if (copy->rebuild() != 1 || version(*copy, Multiplex::SDT_ST) != ((ver + 1) & 0x1f))
+            return 1;
+
+         // truncated and corrupted files are rejected
+         std::vector<char> data;
+         {
+            std::ifstream f(file_name, std::ios::binary);
+            data.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+         }
+         data[15]++; // record count
+         std::ofstream(file_name, std::ios::binary).write(data.data(), data.size());
+         if (Multiplex::loadSnapshot(file_name))
+            return 1;
+         data[15]--;
+
+         // a record length running past the end of the file
+         const char huge[36] = { 'S', 'G', 'M', 'X', 0, 1, 0, 0, 0, 0, 0, 36, 0, 0, 0, 2,
+                                 0, 1, 0, 0, '\xff', '\xff', '\xff', '\xff' };
+         std::ofstream(file_name, std::ios::binary).write(huge, sizeof(huge));
+         if (Multiplex::loadSnapshot(file_name))
+            return 1;
+
+         data.resize(data.size() - 8);
+         std::ofstream(file_name, std::ios::binary).write(data.data(), data.size());
+         if (Multiplex::loadSnapshot(file_name))
+            return 1;
+
+         data[0] = 'X';
+         std::ofstream(file_name, std::ios::binary).write(data.data(), data.size());
+         if (Multiplex::loadSnapshot(file_name) || Multiplex::loadSnapshot("missing.snapshot"))
+            return 1;
+
+         std::remove(file_name);
+         return 0;
+      }
+   }
+
+   int multiplex(TStream& t)
+   {
+      Multiplex mux(0x10, 0x20, 0x30);
+      mux.setNetworkName("multiplex network");
+
+      for (ui16 sid = 1; sid <= 3; sid++) {
+         mux.addService(sid, 0x100 * sid, 0x100 * sid + 1, Dvb::DIGITAL_TV_ST,
+                        "provider", "service " + std::to_string(sid));
+         mux.addElemStream(sid, PMT::ES_ISO_IEC_13818_2_VIDEO, 0x100 * sid + 1);
+         mux.addElemStream(sid, PMT::ES_ISO_IEC_13818_3_AUDIO, 0x100 * sid + 2);
+      }
+      mux.addBouquet(0x40, "bouquet");
+      mux.addBouquetService(0x40, 1);
+      mux.addBouquetService(0x40, 2);
+
+      Multiplex::Event ev = { 0x1000, UTC(58000, 10, 30), BCDTime(1, 30), Dvb::RUNNING_RS,
+                              false, "eng", "event", "event text" };
+      mux.setPresentFollowing(2, &ev, nullptr);
+
+      // inconsistent changes are rejected
+      if (mux.addService(1, 0x400, 0x401, Dvb::DIGITAL_TV_ST, "", "") ||
+          mux.addService(4, 0x10, 0x401, Dvb::DIGITAL_TV_ST, "", "") ||
+          mux.addElemStream(4, PMT::ES_ISO_IEC_13818_3_AUDIO, 0x402) ||
+          mux.addBouquetService(0x40, 4))
+         return 1;
+
+      // PAT, 3 PMTs, SDT, NIT, BAT and an EIT p/f
+      if (mux.rebuild(4) != 8 || mux.isDirty() || mux.getTables().size() != 8)
+         return 1;
+
+      PAT pat(0x20, 0);
+      pat.addNetworkPid(NIT::PID);
+      pat.addProgram(1, 0x100);
+      pat.addProgram(2, 0x200);
+      pat.addProgram(3, 0x300);
+
+      PMT pmt(2, 0x201, 0);
+      pmt.addElemStream(PMT::ES_ISO_IEC_13818_2_VIDEO, 0x201);
+      pmt.addElemStream(PMT::ES_ISO_IEC_13818_3_AUDIO, 0x202);
+
+      PF_EITActual eit(2, 0x20, 0x30, 0);
+      eit.addPresentEvent(ev.id, ev.start_time, ev.duration, ev.running_status, ev.free_CA_mode);
+      eit.addPresentEventDesc( *new ShortEventDesc(ev.language, ev.name, ev.text) );
+
+      if (!same(mux, Multiplex::PAT_ST, 0, pat) || !same(mux, Multiplex::PMT_ST, 2, pmt) ||
+          !same(mux, Multiplex::PF_EIT_ST, 2, eit) || mux.getTable(Multiplex::PF_EIT_ST, 1))
+         return 1;
+
+      // only the SDT changes
+      mux.setServiceName(3, "provider", "renamed");
+      if (mux.rebuild(1) != 1 || version(mux, Multiplex::SDT_ST) != 1 ||
+          version(mux, Multiplex::PAT_ST) != 0 || version(mux, Multiplex::NIT_ST) != 0)
+         return 1;
+
+      // removing a service updates the PAT, SDT, NIT and BAT and drops its
+      // PMT and EIT
+      mux.removeService(2);
+      if (mux.rebuild() != 4 || mux.getTables().size() != 6 ||
+          mux.getTable(Multiplex::PMT_ST, 2) || mux.getTable(Multiplex::PF_EIT_ST, 2))
+         return 1;
+
+      PAT pat1(0x20, 1);
+      pat1.addNetworkPid(NIT::PID);
+      pat1.addProgram(1, 0x100);
+      pat1.addProgram(3, 0x300);
+
+      BAT bat1(0x40, 1);
+      bat1.addBouquetDesc( *new BouquetNameDesc("bouquet") );
+      bat1.addXportStream(0x20, 0x30);
+      ServiceListDesc* sld = new ServiceListDesc;
+      sld->addService(1, Dvb::DIGITAL_TV_ST);
+      bat1.addXportStreamDesc(0x20, *sld);
+
+      SDTActual sdt2(0x20, 0x30, 2);
+      sdt2.addService(1, false, false, Dvb::RUNNING_RS, false);
+      sdt2.addServiceDesc( *new ServiceDesc(Dvb::DIGITAL_TV_ST, "provider", "service 1") );
+      sdt2.addService(3, false, false, Dvb::RUNNING_RS, false);
+      sdt2.addServiceDesc( *new ServiceDesc(Dvb::DIGITAL_TV_ST, "provider", "renamed") );
+
+      if (!same(mux, Multiplex::PAT_ST, 0, pat1) || !same(mux, Multiplex::BAT_ST, 0x40, bat1) ||
+          !same(mux, Multiplex::SDT_ST, 0, sdt2) || version(mux, Multiplex::PMT_ST, 1) != 0)
+         return 1;
+
+      // the carousel entries
+      for (const Multiplex::Entry& e : mux.getTables()) {
+         if (e.type == Multiplex::PMT_ST && e.pid != 0x100 * e.id)
+            return 1;
+      }
+
+      NITActual nit1(0x10, 1);
+      nit1.addNetworkDesc( *new NetworkNameDesc("multiplex network") );
+      nit1.addXportStream(0x20, 0x30);
+      sld = new ServiceListDesc;
+      sld->addService(1, Dvb::DIGITAL_TV_ST);
+      sld->addService(3, Dvb::DIGITAL_TV_ST);
+      nit1.addXportStreamDesc(0x20, *sld);
+      nit1.buildSections(t);
+
+      DUMP(t);
+
+      if (!same(mux, Multiplex::NIT_ST, 0, nit1))
+         return 1;
+      return checkSnapshot(mux);
+   }
+}
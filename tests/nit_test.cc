@@ -5,8 +5,109 @@ using namespace sigen;
 
 namespace tests
 {
+   //
+   // a fixed NIT built at compile time must match the runtime build
+   static int checkStatic()
+   {
+      static constexpr auto static_nit =
+         StaticSI::nit(0x200, 3, true,
+                       StaticSI::descLoop(),
+                       StaticSI::descLoop(
+                          StaticSI::xportStream(0x10, 0x20, StaticSI::descLoop(
+                             StaticSI::cableDeliverySystemDesc(1000, 2000, 0x01, 0x08, 0x02),
+                             StaticSI::satelliteDeliverySystemDesc(0x44444444, 0x3333, 0x1111111, true,
+                                                                   Dvb::Sat::CIRCULAR_RIGHT_POL,
+                                                                   Dvb::Sat::MOD_QPSK,
+                                                                   Dvb::CR_9_10_FECI,
+                                                                   Dvb::Sat::ROF_020))),
+                          StaticSI::xportStream(0x11, 0x21, StaticSI::descLoop(
+                             StaticSI::terrestrialDeliverySystemDesc(0x55555555,
+                                                                     Dvb::Terr::BW_6_MHZ,
+                                                                     Dvb::Terr::CONS_QAM_16,
+                                                                     Dvb::Terr::HI_4_IN_DEPTH,
+                                                                     Dvb::Terr::CR_2_3, Dvb::Terr::CR_7_8,
+                                                                     Dvb::Terr::GI_1_16,
+                                                                     Dvb::Terr::TM_8K,
+                                                                     true,
+                                                                     Dvb::Terr::PRI_HIGH,
+                                                                     false,
+                                                                     false)))));
+
+      NITActual nit(0x200, 3);
+      nit.addXportStream(0x10, 0x20);
+      nit.addXportStreamDesc( *new CableDeliverySystemDesc(1000, 2000, 0x01, 0x08, 0x02) );
+      nit.addXportStreamDesc( *new SatelliteDeliverySystemDesc(0x44444444, 0x3333, 0x1111111, true,
+                                                               Dvb::Sat::CIRCULAR_RIGHT_POL,
+                                                               Dvb::Sat::MOD_QPSK,
+                                                               Dvb::CR_9_10_FECI,
+                                                               Dvb::Sat::ROF_020) );
+      nit.addXportStream(0x11, 0x21);
+      nit.addXportStreamDesc( *new TerrestrialDeliverySystemDesc(0x55555555,
+                                                                 Dvb::Terr::BW_6_MHZ,
+                                                                 Dvb::Terr::CONS_QAM_16,
+                                                                 Dvb::Terr::HI_4_IN_DEPTH,
+                                                                 Dvb::Terr::CR_2_3, Dvb::Terr::CR_7_8,
+                                                                 Dvb::Terr::GI_1_16,
+                                                                 Dvb::Terr::TM_8K,
+                                                                 true,
+                                                                 Dvb::Terr::PRI_HIGH,
+                                                                 false,
+                                                                 false) );
+      TStream ts;
+      nit.buildSections(ts);
+
+      return tests::cmp_static(ts, static_nit.getBinaryData(), static_nit.length());
+   }
+
+   //
+   // the descriptor layouts must read back what they wrote
+   static int checkLayouts()
+   {
+      using Sat = SatelliteDeliverySystemDesc::Layout;
+      using Cells = CellListDesc::CellLayout;
+
+      static constexpr auto static_cable = StaticSI::cableDeliverySystemDesc(1000, 2000, 0x01, 0x08, 0x02);
+      static_assert(CableDeliverySystemDesc::Layout::View(static_cable.getBinaryData() + 2)
+                    .get<CableDeliverySystemDesc::Layout::SYMBOL_RATE>() == 2000, "cable layout");
+
+      Section s(64);
+      SatelliteDeliverySystemDesc sdsd(0x44444444, 0x3333, 0x1111111, true,
+                                       Dvb::Sat::CIRCULAR_RIGHT_POL, Dvb::Sat::MOD_QPSK,
+                                       Dvb::CR_9_10_FECI, Dvb::Sat::ROF_020);
+      sdsd.buildSections(s);
+
+      Sat::View v = descView<SatelliteDeliverySystemDesc>(s.getBinaryData(), s.length());
+      if (!v || v.get<Sat::FREQUENCY>() != 0x44444444 || v.get<Sat::ORBITAL_POSITION>() != 0x3333 ||
+          v.get<Sat::WEST_EAST>() != 1 || v.get<Sat::POLARISATION>() != Dvb::Sat::CIRCULAR_RIGHT_POL ||
+          v.get<Sat::ROLL_OFF>() != Dvb::Sat::ROF_020 ||
+          v.get<Sat::MODULATION_SYSTEM>() != Dvb::Sat::MODSYS_DVB_S2 ||
+          v.get<Sat::SYMBOL_RATE>() != 0x1111111 || v.get<Sat::FEC_INNER>() != Dvb::CR_9_10_FECI)
+         return 1;
+
+      // wrong tag, short data
+      if (descView<CableDeliverySystemDesc>(s.getBinaryData(), s.length()) ||
+          descView<SatelliteDeliverySystemDesc>(s.getBinaryData(), s.length() - 1))
+         return 1;
+
+      // cell header with its 12 bit extents and the subcell loop length
+      Section cs(64);
+      CellListDesc cld;
+      cld.addCell(1, 3000, 2000, 0x22b, 0x41);
+      cld.addSubCell(20, 3000, 2000, 0x22c, 0x42);
+      cld.buildSections(cs);
+
+      Cells::View cell(cs.getBinaryData() + 2);
+      return (cell.get<Cells::CELL_EXTENT_OF_LATITUDE>() != 0x22b ||
+              cell.get<Cells::CELL_EXTENT_OF_LONGITUDE>() != 0x41 ||
+              cell.get<Cells::SUBCELL_INFO_LOOP_LENGTH>() != CellListDesc::SubCellLayout::LENGTH ||
+              CellListDesc::SubCellLayout::View(cell.end()).get<CellListDesc::SubCellLayout::CELL_ID_EXTENSION>() != 20);
+   }
+
    int nit(TStream& t)
    {
+      if (checkStatic() || checkLayouts())
+         return 1;
+
       // NIT test
       NITActual nit(0x100, 0x01);
 
@@ -157,6 +258,21 @@ namespace tests
       nit.addXportStreamDesc( tsid, *tdsd2 );
 
       DUMP(nit);
+
+      // generated sections must match the built ones, and dropping a
+      // generator part way must leave the table intact for the build
+      if (tests::cmp_gen(nit))
+         return 1;
+      {
+         Section s(nit.getMaxSectionLen());
+         SectionGenerator gen = nit.sections();
+         gen.next(s);
+      }
+      {
+         SectionGenerator gen = nit.sections();
+         gen.prepare();
+      }
+
       nit.buildSections(t);
 
       // dump built sections
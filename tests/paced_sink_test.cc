@@ -0,0 +1,77 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "../src/sigen.h"
+#include "dvb_builder.h"
+
+using namespace sigen;
+
+namespace tests
+{
+   namespace {
+      // keeps the data packets and counts the nulls
+      class MemorySink : public PacketSink
+      {
+      public:
+         std::vector<ui8> data;
+         size_t nulls = 0;
+         bool flushed = false;
+
+         void write(const ui8* packets, size_t count) {
+            for (size_t i = 0; i < count; i++, packets += PACKET_SIZE) {
+               if ((((packets[1] & 0x1f) << 8) | packets[2]) == PacedSink::NULL_PID)
+                  nulls++;
+               else
+                  data.insert(data.end(), packets, packets + PACKET_SIZE);
+            }
+         }
+         void flush() { flushed = true; }
+      };
+   }
+
+   int paced_sink(TStream& t)
+   {
+      build_sink_nit(t, "paced sink network");
+
+      std::vector<ui8> packets;
+      MpgPacketizer mp(0);
+      for (int rep = 0; rep < 20; rep++) {
+         for (const Section* s : t.section_list)
+            mp.packetize(*s, NIT::PID, packets);
+      }
+      const size_t count = packets.size() / PacketSink::PACKET_SIZE;
+
+      // 8 Mbit/s is ~5300 packets/s, so the data takes ~1/10s
+      const ui32 bitrate = 8000000;
+      MemorySink out;
+      PacedSink sink(out, bitrate, 256);
+
+      auto start = std::chrono::steady_clock::now();
+      sink.start();
+      sink.write(packets.data(), count);
+      sink.flush();
+      if (!out.flushed || out.data != packets)
+         return 1;
+
+      // then nulls only
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      sink.stop();
+      const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      // the rate, to within a few ticks
+      PacedSink::Stats st = sink.getStats();
+      const double expected = secs * bitrate / (PacketSink::PACKET_SIZE * 8);
+      const uint64_t total = st.packets + st.null_packets;
+      if (st.packets != count || st.null_packets != out.nulls || out.nulls == 0 ||
+          total > expected + 1 || total + st.skipped_packets < expected * 0.8)
+         return 1;
+
+      uint64_t wakeups = 0;
+      for (unsigned i = 0; i < PacedSink::JITTER_BUCKETS; i++)
+         wakeups += st.jitter[i];
+      if (wakeups != st.ticks || st.ticks == 0 ||
+          PacedSink::jitterLimit(PacedSink::JITTER_BUCKETS - 1) != 0)
+         return 1;
+      return 0;
+   }
+}
@@ -30,9 +30,26 @@ namespace tests
       // for debug output
       DUMP(pat);
 
+      // a small pat builds into an inline section
+      InlineSection<PAT::MAX_SEC_LEN> s;
+      if (!pat.buildSection(s) || tests::cmp_gen(pat))
+         return 1;
+
       // this builds the binary section data onto the TStream object
       pat.buildSections(t);
 
+      // the same table built at compile time
+      static constexpr auto static_pat =
+         StaticSI::pat(0x10, 0x01, true,
+                       StaticSI::program(0, 0x20),
+                       StaticSI::program(100, 200), StaticSI::program(101, 201),
+                       StaticSI::program(102, 202), StaticSI::program(103, 203),
+                       StaticSI::program(104, 204), StaticSI::program(105, 205),
+                       StaticSI::program(106, 206), StaticSI::program(107, 207),
+                       StaticSI::program(108, 208), StaticSI::program(109, 209));
+      if (tests::cmp_static(t, static_pat.getBinaryData(), static_pat.length()))
+         return 1;
+
       // dump built sections
       DUMP(t);
 
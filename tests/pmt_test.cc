@@ -1,3 +1,4 @@
+#include <stdexcept>
 #include "../src/sigen.h"
 #include "dvb_builder.h"
 
@@ -179,6 +180,9 @@ namespace tests
       pmt.addElemStreamDesc( *afdd );
 
       DUMP(pmt);
+      if (tests::cmp_gen(pmt))
+         return 1;
+
       pmt.buildSections(t);
 
       // dump built sections
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/sigen.h"
+#include "dvb_builder.h"
+
+using namespace sigen;
+
+namespace tests
+{
+   namespace {
+      std::unique_ptr<SDTActual> makeSDT(int rev)
+      {
+         std::unique_ptr<SDTActual> sdt(new SDTActual(0x20, 0x30, 0x05));
+         sdt->setMaxSectionLen( 200 ); // several sections per version
+         for (ui16 sid = 1; sid <= 10; sid++) {
+            sdt->addService(sid, true, true, 1, false);
+            sdt->addServiceDesc( *new ServiceDesc( Dvb::DIGITAL_TV_ST, "provider",
+                                                   "service " + std::to_string(sid) +
+                                                   " rev " + std::to_string(rev) ) );
+         }
+         return sdt;
+      }
+
+      // mpeg-2 crc over a section including its crc is 0
+      bool crcOK(const Section& s)
+      {
+         ui32 crc = 0xffffffff;
+         for (ui16 i = 0; i < s.length(); i++) {
+            crc ^= static_cast<ui32>(s.getBinaryData()[i]) << 24;
+            for (int b = 0; b < 8; b++)
+               crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04c11db7 : crc << 1;
+         }
+         return crc == 0;
+      }
+
+      // every section is complete and carries the snapshot's version
+      bool consistent(const PublishedTable::Snapshot& snap)
+      {
+         for (const Section* s : snap.stream().section_list) {
+            if (!crcOK(*s) || ((s->getBinaryData()[5] >> 1) & 0x1f) != snap.getVersionNumber())
+               return false;
+         }
+         return true;
+      }
+
+      std::vector<ui8> bytes(const TStream& t)
+      {
+         std::vector<ui8> v;
+         for (const Section* s : t.section_list)
+            v.insert(v.end(), s->getBinaryData(), s->getBinaryData() + s->length());
+         return v;
+      }
+   }
+
+   int published(TStream& t)
+   {
+      enum { REVISIONS = 100 };
+      PublishedTable table;
+
+      if (table.acquire().valid())
+         return 1;
+
+      // the first publish keeps the table's version
+      if (table.publish(*makeSDT(0)) != 0x05)
+         return 1;
+
+      // held across the updates below, must stay intact
+      PublishedTable::Snapshot held = table.acquire();
+      const std::vector<ui8> held_bytes = bytes(held.stream());
+
+      // publishes completed by the writer below
+      std::atomic<int> published(0);
+      std::atomic<bool> done(false), failed(false);
+      std::thread reader([&]() {
+            int last = 0;
+            while (!done.load()) {
+               const int before = published.load();
+               PublishedTable::Snapshot snap = table.acquire();
+               // the publish in progress may already be visible
+               const int after = published.load() + 1;
+
+               // versions only move forward by one per publish: find the
+               // publish the snapshot is from, neither before the last one
+               // seen nor ahead of the writer
+               int p = std::max(before, last);
+               while (p <= after && ((0x05 + p) & 0x1f) != snap.getVersionNumber())
+                  p++;
+               if (!consistent(snap) || p > after)
+                  failed = true;
+               else
+                  last = p;
+            }
+         });
+
+      for (int rev = 1; rev <= REVISIONS; rev++) {
+         table.publish(*makeSDT(rev));
+         published.store(rev);
+      }
+
+      done = true;
+      reader.join();
+
+      if (failed || bytes(held.stream()) != held_bytes || held.getVersionNumber() != 0x05)
+         return 1;
+
+      // the first version is still held
+      if (table.reclaim() == 0)
+         return 1;
+      held.release();
+      if (table.reclaim() != 0)
+         return 1;
+
+      // latest is the same as building it with the bumped version
+      PublishedTable::Snapshot snap = table.acquire();
+      const ui8 ver = (0x05 + REVISIONS) & 0x1f;
+      std::unique_ptr<SDTActual> sdt = makeSDT(REVISIONS);
+      sdt->setVersionNumber(ver);
+      sdt->buildSections(t);
+
+      if (snap.getVersionNumber() != ver || bytes(snap.stream()) != bytes(t))
+         return 1;
+
+      return 0;
+   }
+}
@@ -13,6 +13,9 @@ namespace tests
          rst.addXportStream(0x1000, 0x2000, 0x100, 0x1000 + i, Dvb::RUNNING_RS);
       }
 
+      if (tests::cmp_gen(rst))
+         return 1;
+
       DUMP(rst);
       rst.buildSections(t);
 
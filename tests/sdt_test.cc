@@ -1,3 +1,6 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include "../src/sigen.h"
 #include "dvb_builder.h"
 
@@ -5,8 +8,82 @@ using namespace sigen;
 
 namespace tests
 {
+   namespace {
+      std::vector<ui8> bytes(const STable& table)
+      {
+         TStream t;
+         table.buildSections(t);
+
+         std::vector<ui8> v;
+         for (const Section* s : t.section_list)
+            v.insert(v.end(), s->getBinaryData(), s->getBinaryData() + s->length());
+         return v;
+      }
+
+      // a batch added with addServices() (or with descriptors built in
+      // place) builds the same as adding the services and descriptors
+      // one by one
+      int checkBulk()
+      {
+         enum { SERVICES = 100 };
+         SDTActual single(0x20, 0x30, 0x05), bulk(0x20, 0x30, 0x05), emplaced(0x20, 0x30, 0x05);
+         single.setMaxSectionLen( 300 );
+         bulk.setMaxSectionLen( 300 );
+         emplaced.setMaxSectionLen( 300 );
+
+         std::vector<std::vector<ui8> > loops(SERVICES);
+         std::vector<SDT::ServiceInfo> info;
+         for (ui16 sid = 0; sid < SERVICES; sid++) {
+            const std::string name = "service " + std::to_string(sid);
+            single.addService(sid, true, false, Dvb::RUNNING_RS, sid & 1);
+            single.addServiceDesc( *new ServiceDesc(Dvb::DIGITAL_TV_ST, "provider", name) );
+            append_desc(loops[sid], ServiceDesc(Dvb::DIGITAL_TV_ST, "provider", name));
+            emplaced.addService(sid, true, false, Dvb::RUNNING_RS, sid & 1);
+            emplaced.emplaceServiceDesc<ServiceDesc>(sid, Dvb::DIGITAL_TV_ST, "provider", name);
+            if (sid % 10 == 0) {
+               single.addServiceDesc( *new StuffingDesc('z', 20) );
+               append_desc(loops[sid], StuffingDesc('z', 20));
+               emplaced.emplaceServiceDesc<StuffingDesc>(sid, 'z', 20);
+            }
+            info.push_back({ sid, true, false, Dvb::RUNNING_RS, bool(sid & 1),
+                             loops[sid].data(), ui16(loops[sid].size()) });
+         }
+
+         if (!bulk.addServices(info.data(), 1) ||
+             !bulk.addServices(info.data() + 1, SERVICES - 1) ||
+             bytes(single) != bytes(bulk) || bytes(single) != bytes(emplaced))
+            return 1;
+
+         // no such service
+         if (emplaced.emplaceServiceDesc<ServiceDesc>(SERVICES, Dvb::DIGITAL_TV_ST, "p", "n"))
+            return 1;
+
+         // a malformed loop rejects the whole batch
+         const ui16 len = bulk.getDataLength();
+         const ui8 bad[] = { ServiceDesc::TAG, 10, 0 };
+         const SDT::ServiceInfo bad_info[] = {
+            { 200, false, false, Dvb::RUNNING_RS, false, nullptr, 0 },
+            { 201, false, false, Dvb::RUNNING_RS, false, bad, sizeof(bad) },
+         };
+         if (bulk.addServices(bad_info, 2) || bulk.getDataLength() != len)
+            return 1;
+
+#ifdef CHECK_DUPLICATES
+         try {
+            bulk.addServices(info.data() + 5, 1);
+            return 1;
+         }
+         catch (std::range_error&) { }
+#endif
+         return 0;
+      }
+   }
+
    int sdt(TStream& t)
    {
+      if (checkBulk())
+         return 1;
+
       // SDT
       SDTActual sdt(0x20, 0x30, 0x05);
 
@@ -1,3 +1,6 @@
+#include <cstdio>
+#include <string>
+#include <vector>
 #include "../src/sigen.h"
 #include "dvb_builder.h"
 
@@ -5,12 +8,164 @@ using namespace sigen;
 
 namespace tests
 {
+#ifdef ENABLE_DUMP
+   namespace {
+      // dumps the table through a DumpStream on a temp file
+      std::string structuredDump(const TDT& tdt, DumpStream::Format format)
+      {
+         FILE* f = tmpfile();
+         {
+            DumpStream ds(fileno(f), format);
+            tdt.dump(ds);
+         }
+         std::string out;
+         rewind(f);
+         for (int c; (c = fgetc(f)) != EOF; )
+            out += static_cast<char>(c);
+         fclose(f);
+         return out;
+      }
+
+      // a decoded dump record
+      struct Record {
+         int type;               // TLV type, 0 for JSON
+         long level;
+         long id;
+         std::string value;      // raw TLV bytes or JSON value text
+      };
+
+      // the header fields of the dump, in order
+      const struct { STRID id; ui32 value; } FIELDS[] = {
+         { TID_S, 0x70 }, { SECT_SYNTAX_IND_S, 0 }, { RESERVED_FU_S, 1 },
+         { RESERVED_S, 3 }, { TABLE_LEN_S, 5 }
+      };
+      const size_t NUM_FIELDS = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+      // splits a TLV dump into its records, false if it's malformed
+      bool decodeTlv(const std::string& tlv, std::vector<Record>& recs)
+      {
+         if (tlv.compare(0, 5, std::string("SGTL\1", 5)) != 0)
+            return false;
+
+         for (size_t pos = 5; pos < tlv.size(); ) {
+            if (pos + 6 > tlv.size())
+               return false;
+            const ui8* h = reinterpret_cast<const ui8*>(tlv.data() + pos);
+            const size_t len = (h[4] << 8) | h[5];
+            if (pos + 6 + len > tlv.size())
+               return false;
+            recs.push_back({ h[0], h[1], (h[2] << 8) | h[3], tlv.substr(pos + 6, len) });
+            pos += 6 + len;
+         }
+         return true;
+      }
+
+      // splits a JSON dump into its records' level, id and value (or
+      // header kind) - records are one per line
+      bool decodeJson(const std::string& json, std::vector<Record>& recs)
+      {
+         if (json.compare(0, 1, "[") != 0 || json.size() < 3 ||
+             json.compare(json.size() - 3, 3, "\n]\n") != 0)
+            return false;
+
+         for (size_t pos = json.find("\n{"); pos != std::string::npos;
+              pos = json.find("\n{", pos + 1)) {
+            const size_t end = json.find('\n', pos + 1);
+            std::string line = json.substr(pos + 1, end - pos - 1);
+            if (!line.empty() && line.back() == ',')
+               line.pop_back();
+
+            const size_t level = line.find("{\"level\":");
+            const size_t id = line.find(",\"id\":");
+            size_t value = line.find(",\"value\":");
+            size_t value_len = 9;
+            if (value == std::string::npos) {
+               value = line.find(",\"header\":");
+               value_len = 10;
+            }
+            if (level != 0 || id == std::string::npos || value == std::string::npos ||
+                line.back() != '}')
+               return false;
+
+            recs.push_back({ 0, std::stol(line.substr(9)), std::stol(line.substr(id + 6)),
+                             line.substr(value + value_len,
+                                         line.size() - value - value_len - 1) });
+         }
+         return true;
+      }
+
+      int checkStructuredDump(const TDT& tdt, const UTC& utc)
+      {
+         // TLV - header, the numeric fields then the packed utc
+         std::vector<Record> recs;
+         if (!decodeTlv(structuredDump(tdt, DumpStream::TLV), recs) ||
+             recs.size() != NUM_FIELDS + 2 ||
+             recs[0].type != 1 || recs[0].id != TDT_DUMP_S || recs[0].value != std::string(1, '\0'))
+            return 1;
+
+         for (size_t i = 0; i < NUM_FIELDS; i++) {
+            const Record& r = recs[i + 1];
+            const ui32 v = FIELDS[i].value;
+            const std::string b = { static_cast<char>(v >> 24), static_cast<char>(v >> 16),
+                                    static_cast<char>(v >> 8), static_cast<char>(v) };
+            if (r.type != 2 || r.level != 0 || r.id != FIELDS[i].id || r.value != b)
+               return 1;
+         }
+
+         ui8 utc_bytes[UTC::BYTE_LEN];
+         utc.getBytes(utc_bytes);
+         const Record& t = recs.back();
+         if (t.type != 5 || t.id != UTC_S ||
+             t.value != std::string(reinterpret_cast<const char*>(utc_bytes), sizeof(utc_bytes)))
+            return 1;
+
+         // JSON - the same records, with printed values
+         recs.clear();
+         if (!decodeJson(structuredDump(tdt, DumpStream::JSON), recs) ||
+             recs.size() != NUM_FIELDS + 2 ||
+             recs[0].id != TDT_DUMP_S || recs[0].value != "\"table\"")
+            return 1;
+
+         for (size_t i = 0; i < NUM_FIELDS; i++) {
+            const Record& r = recs[i + 1];
+            if (r.level != 0 || r.id != FIELDS[i].id || r.value != std::to_string(FIELDS[i].value))
+               return 1;
+         }
+
+         return (recs.back().id == UTC_S &&
+                 recs.back().value == "{\"mjd\":" + std::to_string(utc.mjd) +
+                 ",\"date\":\"1999-01-22\",\"time\":\"10:00:00\"}") ? 0 : 1;
+      }
+   }
+#endif
+
    int tdt(TStream& t)
    {
+      const UTC utc(1, 22, 1999, 10, 0, 0);
+
+      // epoch based constructors should land on the same time
+      const time_t epoch_s = 916999200;
+      if ((UTC(epoch_s) == utc) != 0 || utc.toTimeT() != epoch_s ||
+          (UTC(std::chrono::system_clock::from_time_t(epoch_s)) == utc) != 0)
+         return 1;
+
       // TDT
-      TDT tdt(UTC(1, 22, 1999, 10, 0, 0));
+      TDT tdt(utc);
 
       DUMP(tdt);
+#ifdef ENABLE_DUMP
+      if (checkStructuredDump(tdt, utc))
+         return 1;
+#endif
+
+      if (tests::cmp_gen(tdt))
+         return 1;
+
+      // built in place, but not into a section that's too small
+      InlineSection<TDT::MAX_SEC_LEN> s;
+      InlineSection<TDT::MAX_SEC_LEN - 1> small;
+      if (!tdt.buildSection(s) || tdt.buildSection(small))
+         return 1;
 
       tdt.buildSections(t);
 
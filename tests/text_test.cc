@@ -0,0 +1,41 @@
+#include <string>
+#include "../src/sigen.h"
+#include "dvb_builder.h"
+
+using namespace sigen;
+
+namespace tests
+{
+   int text(TStream& t)
+   {
+      SDTActual sdt(0x20, 0x30, 0x01);
+      TextEncoder enc;
+
+      // service names in UTF-8 - each should end up in a different table
+      const std::string names[] = {
+         "Das Erste",                            // plain ASCII, no selector
+         "M\xc3\xbcnchner Fernsehen",            // ISO/IEC 6937 (diacritic + u)
+         "T\xc3\xa9l\xc3\xa9 Ch\xc3\xa2teau Gen\xc3\xa8ve", // ISO/IEC 8859-15
+         "\xd0\x9f\xd0\xb5\xd1\x80\xd0\xb2\xd1\x8b\xd0\xb9 \xd0\xba\xd0\xb0\xd0\xbd\xd0\xb0\xd0\xbb", // 8859-5
+         "\xce\x95\xce\xa1\xce\xa4 1",           // ISO/IEC 8859-7
+         "Pozna\xc5\x84 \xc5\x81\xc3\xb3\x64\xc5\xba", // ISO/IEC 8859-13
+         "P\xc5\x99\xc3\xadli\xc5\xa1 \xc5\xbelu\xc5\xa5ou\xc4\x8dk\xc3\xbd k\xc5\xaf\xc5\x88", // 8859-2 (3-byte selector)
+         "NHK\xe7\xb7\x8f\xe5\x90\x88",          // UTF-8
+         "News\nWeather\tSport"                  // CR/LF control code, tab dropped
+      };
+
+      ui16 sid = 100;
+      for (const std::string& name : names) {
+         sdt.addService(sid++, false, true, 4, false);
+         sdt.addServiceDesc( *new ServiceDesc(0x01, enc.encode("Provider"), enc.encode(name)) );
+      }
+
+      DUMP(sdt);
+      sdt.buildSections(t);
+
+      // dump built sections
+      DUMP(t);
+
+      return tests::cmp_bin(t, "reference/text.ts");
+   }
+}
@@ -1,3 +1,4 @@
+#include <cstring>
 #include "../src/sigen.h"
 #include "dvb_builder.h"
 
@@ -5,16 +6,58 @@ using namespace sigen;
 
 namespace tests
 {
+   namespace {
+      void addOffsets(TOT& tot)
+      {
+         LocalTimeOffsetDesc *ltod = new LocalTimeOffsetDesc;
+         UTC t2(1, 22, 1999, 10, 0, 0);
+         ltod->addTimeOffset( "eng", 0x22, true, 0x1234, t2, 0x4321 );
+         ltod->addTimeOffset( "fre", 0x23, true, 0x5678, t2, 0x8765 );
+
+         tot.addDesc( *ltod );
+      }
+
+      // a patched live section must match a fresh build at the new time
+      int checkLiveTime(const TOT& tot)
+      {
+         const UTC later(3, 9, 2024, 17, 45, 30);
+
+         LiveTimeTable live(tot, 5);
+         live.setUTC(later);
+
+         TOT fresh(later);
+         addOffsets(fresh);
+
+         TStream ts;
+         fresh.buildSections(ts);
+         const Section& s = *ts.section_list.front();
+         if (s.length() != live.getSection().length() ||
+             memcmp(s.getBinaryData(), live.getSection().getBinaryData(), s.length()) ||
+             s.getCRC() != live.getSection().getCRC())
+            return 1;
+
+         // two emissions: the second has its continuity counter advanced
+         std::vector<ui8> pkts;
+         MpgPacketizer packetizer(5);
+         packetizer.packetize(s, TOT::PID, pkts);
+         packetizer.packetize(s, TOT::PID, pkts);
+
+         std::vector<ui8> out = live.nextPackets();
+         const std::vector<ui8>& next = live.nextPackets();
+         out.insert(out.end(), next.begin(), next.end());
+
+         return (out == pkts) ? 0 : 1;
+      }
+   }
+
    int tot(TStream& t)
    {
       TOT tot(UTC(1, 22, 1999, 10, 0, 0));
 
-      LocalTimeOffsetDesc *ltod = new LocalTimeOffsetDesc;
-      UTC t2(1, 22, 1999, 10, 0, 0);
-      ltod->addTimeOffset( "eng", 0x22, true, 0x1234, t2, 0x4321 );
-      ltod->addTimeOffset( "fre", 0x23, true, 0x5678, t2, 0x8765 );
+      addOffsets(tot);
 
-      tot.addDesc( *ltod );
+      if (checkLiveTime(tot) || tests::cmp_gen(tot))
+         return 1;
 
       DUMP(tot);
       tot.buildSections(t);
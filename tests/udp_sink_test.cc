@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../src/sigen.h"
+#include "dvb_builder.h"
+
+using namespace sigen;
+
+namespace tests
+{
+   namespace {
+      // bound loopback socket and its port
+      int receiver(ui16& port)
+      {
+         int fd = socket(AF_INET, SOCK_DGRAM, 0);
+         int rcvbuf = 1 << 20;
+         setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+         timeval tv = { 1, 0 };
+         setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+         sockaddr_in addr;
+         memset(&addr, 0, sizeof(addr));
+         addr.sin_family = AF_INET;
+         addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+         socklen_t len = sizeof(addr);
+         if (bind(fd, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+             getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            close(fd);
+            return -1;
+         }
+         port = ntohs(addr.sin_port);
+         return fd;
+      }
+
+      std::vector<ui8> packetize(const TStream& t, int reps)
+      {
+         std::vector<ui8> packets;
+         MpgPacketizer mp(0);
+         for (int rep = 0; rep < reps; rep++) {
+            for (const Section* s : t.section_list)
+               mp.packetize(*s, NIT::PID, packets);
+         }
+         return packets;
+      }
+
+      // sends the packets and checks what arrives
+      int check(const std::vector<ui8>& packets, bool rtp, ui32 bitrate)
+      {
+         ui16 port;
+         int fd = receiver(port);
+         if (fd < 0)
+            return 1;
+
+         const size_t count = packets.size() / PacketSink::PACKET_SIZE;
+         const size_t datagrams = (count + UdpSink::PACKETS_PER_DATAGRAM - 1) /
+            UdpSink::PACKETS_PER_DATAGRAM;
+         const size_t header_len = rtp ? UdpSink::RTP_HEADER_LEN : 0;
+
+         auto start = std::chrono::steady_clock::now();
+         UdpSink sink("127.0.0.1", port, rtp);
+         sink.setBitrate(bitrate);
+         sink.setSsrc(0x12345678);
+
+         // in odd sized pieces
+         for (size_t pos = 0; pos < count; pos += 5)
+            sink.write(&packets[pos * PacketSink::PACKET_SIZE], std::min<size_t>(5, count - pos));
+         sink.flush();
+         auto elapsed = std::chrono::steady_clock::now() - start;
+
+         if (!sink.good() || sink.datagramsSent() != datagrams || sink.datagramsDropped() ||
+             (!bitrate && sink.sendCalls() >= datagrams))
+            return 1;
+
+         // paced at the bitrate, less the last batch
+         if (bitrate) {
+            const double secs = (packets.size() - UdpSink::PACKETS_PER_DATAGRAM * PacketSink::PACKET_SIZE) * 8.0 / bitrate;
+            if (std::chrono::duration<double>(elapsed).count() < secs * 0.9)
+               return 1;
+         }
+
+         std::vector<ui8> received;
+         ui8 buf[2048];
+         for (size_t i = 0; i < datagrams; i++) {
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n < static_cast<ssize_t>(header_len) ||
+                (i + 1 < datagrams &&
+                 n != static_cast<ssize_t>(header_len + 7 * PacketSink::PACKET_SIZE)))
+               return 1;
+
+            if (rtp) {
+               const ui16 seq = (buf[2] << 8) | buf[3];
+               const ui32 ssrc = (buf[8] << 24) | (buf[9] << 16) | (buf[10] << 8) | buf[11];
+               if (buf[0] != 0x80 || buf[1] != UdpSink::RTP_MP2T_PT || seq != i ||
+                   ssrc != 0x12345678)
+                  return 1;
+            }
+            received.insert(received.end(), buf + header_len, buf + n);
+         }
+         close(fd);
+         return received == packets ? 0 : 1;
+      }
+   }
+
+   int udp_sink(TStream& t)
+   {
+      build_sink_nit(t, "udp sink network");
+
+      // not a multiple of 7 packets
+      std::vector<ui8> packets = packetize(t, 20);
+      if ((packets.size() / PacketSink::PACKET_SIZE) % UdpSink::PACKETS_PER_DATAGRAM == 0)
+         packets.resize(packets.size() - PacketSink::PACKET_SIZE);
+
+      if (check(packets, false, 0) || check(packets, true, 0) || check(packets, true, 4000000))
+         return 1;
+      return 0;
+   }
+}